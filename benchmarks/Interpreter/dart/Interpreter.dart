@@ -0,0 +1,193 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmarks for the bytecode interpreter: tight loops of common bytecode
+// sequences, and the time until a freshly spawned isolate has run its first
+// (cold) code. Meant to be run with --enable-interpreter, where the time per
+// run is dominated by bytecode dispatch.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int N = 100000;
+
+// Reports the time per run of [N] operations.
+abstract class InterpreterBenchmark extends BenchmarkBase {
+  InterpreterBenchmark(String name) : super('Interpreter.$name');
+
+  int expected = 0;
+
+  int compute();
+
+  @override
+  void setup() {
+    expected = compute();
+  }
+
+  @override
+  void run() {
+    if (compute() != expected) {
+      throw 'Unexpected result in $name.';
+    }
+  }
+
+  @override
+  void exercise() {
+    // Only a single run per measurement.
+    run();
+  }
+}
+
+// Integer comparisons followed by conditional jumps.
+class Loop extends InterpreterBenchmark {
+  Loop() : super('Loop');
+
+  @override
+  int compute() {
+    int sum = 0;
+    for (int i = 0; i < N; i++) {
+      if (i > 10) sum++;
+      if (i <= 20) sum += 2;
+    }
+    return sum;
+  }
+}
+
+// Pushes of locals followed by a direct call.
+class Calls extends InterpreterBenchmark {
+  Calls() : super('Calls');
+
+  @pragma('vm:never-inline')
+  static int add(int a, int b, int c) => a + b + c;
+
+  @override
+  int compute() {
+    int sum = 0;
+    int one = 1;
+    int two = 2;
+    for (int i = 0; i < N; i++) {
+      sum = add(sum, one, two);
+    }
+    return sum;
+  }
+}
+
+class Point {
+  int x;
+  int y;
+  Point(this.x, this.y);
+}
+
+// Field loads and stores.
+class Fields extends InterpreterBenchmark {
+  Fields() : super('Fields');
+
+  @override
+  int compute() {
+    final Point p = Point(0, 1);
+    for (int i = 0; i < N; i++) {
+      p.x += p.y;
+    }
+    return p.x;
+  }
+}
+
+// Null checks followed by conditional jumps.
+class NullChecks extends InterpreterBenchmark {
+  NullChecks() : super('NullChecks');
+
+  final List<Object?> objects = List<Object?>.generate(
+      16, (int i) => i.isEven ? null : i,
+      growable: false);
+
+  @override
+  int compute() {
+    int count = 0;
+    for (int i = 0; i < N; i++) {
+      if (objects[i & 15] == null) count++;
+    }
+    return count;
+  }
+}
+
+// Double comparisons followed by conditional jumps.
+class DoubleCompare extends InterpreterBenchmark {
+  DoubleCompare() : super('DoubleCompare');
+
+  @override
+  int compute() {
+    int count = 0;
+    double d = 0.0;
+    for (int i = 0; i < N; i++) {
+      d += 0.5;
+      if (d >= 100.0) {
+        d = 0.0;
+        count++;
+      }
+    }
+    return count;
+  }
+}
+
+// Code that has not run before in the isolate it runs in.
+int coldCode(int n) {
+  final Map<String, int> counts = <String, int>{};
+  for (int i = 0; i < n; i++) {
+    final String key = 'k${i % 7}';
+    counts[key] = (counts[key] ?? 0) + i;
+  }
+  final List<int> values = counts.values.toList()..sort();
+  return values.fold(0, (int a, int b) => a + b);
+}
+
+void isolateEntry(SendPort sendPort) {
+  sendPort.send(coldCode(100));
+}
+
+// Measures the time from spawning an isolate until it has run some cold code
+// and its first message arrived.
+class Startup {
+  static const String name = 'Interpreter.Startup';
+
+  Future<int> spawnOnce() async {
+    final ReceivePort port = ReceivePort();
+    final Stopwatch watch = Stopwatch()..start();
+    await Isolate.spawn(isolateEntry, port.sendPort);
+    await port.first;
+    return watch.elapsedMicroseconds;
+  }
+
+  Future<double> measureFor(int minimumMillis) async {
+    final Stopwatch watch = Stopwatch()..start();
+    int total = 0;
+    int runs = 0;
+    while (watch.elapsedMilliseconds < minimumMillis) {
+      total += await spawnOnce();
+      runs++;
+    }
+    return total / runs;
+  }
+
+  Future<void> report() async {
+    await measureFor(500); // warm-up
+    final double us = await measureFor(2000);
+    print('$name(RunTime): $us us.');
+  }
+}
+
+Future<void> main() async {
+  final benchmarks = [
+    Loop(),
+    Calls(),
+    Fields(),
+    NullChecks(),
+    DoubleCompare(),
+  ];
+  for (final benchmark in benchmarks) {
+    benchmark.report();
+  }
+  await Startup().report();
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import 'package:benchmark_harness/benchmark_harness.dart'
+    show PrintEmitter, ScoreEmitter;
+
+// Identical to BenchmarkBase from package:benchmark_harness but async.
+abstract class AsyncBenchmarkBase {
+  final String name;
+  final ScoreEmitter emitter;
+
+  Future<void> run();
+  Future<void> setup();
+  Future<void> teardown();
+
+  const AsyncBenchmarkBase(this.name, {this.emitter = const PrintEmitter()});
+
+  // Returns the number of microseconds per call.
+  Future<double> measureFor(int minimumMillis) async {
+    final minimumMicros = minimumMillis * 1000;
+    int iter = 0;
+    final watch = Stopwatch();
+    watch.start();
+    int elapsed = 0;
+    while (elapsed < minimumMicros) {
+      await run();
+      elapsed = watch.elapsedMicroseconds;
+      iter++;
+    }
+    return elapsed / iter;
+  }
+
+  // Measures the score for the benchmark and returns it.
+  Future<double> measure() async {
+    await setup();
+    await measureFor(500); // warm-up
+    final result = await measureFor(4000); // actual measurement
+    await teardown();
+    return result;
+  }
+
+  Future<void> report() async {
+    emitter.emit(name, await measure());
+  }
+}
+
+List<Map<String, Object>> makeMessage(int length) {
+  return List<Map<String, Object>>.generate(
+      length,
+      (int i) => <String, Object>{
+            'id': i,
+            'name': 'item $i',
+            'price': i * 0.25,
+            'tags': <String>['a', 'b', 'c'],
+          });
+}
+
+// Measures how long sending a list of [length] maps to another isolate and
+// receiving it back takes.
+class SendReceiveListOfMaps extends AsyncBenchmarkBase {
+  SendReceiveListOfMaps(String name, this.length) : super(name);
+
+  @override
+  Future<void> run() async {
+    outbox.send(message);
+    await inbox.moveNext();
+    final List<Map<String, Object>> received = inbox.current;
+    if (received.length != length) {
+      throw 'Unexpected message length ${received.length}';
+    }
+  }
+
+  @override
+  Future<void> setup() async {
+    message = makeMessage(length);
+    port = ReceivePort();
+    inbox = StreamIterator<dynamic>(port);
+    workerCompleted = Completer<bool>();
+    workerExitedPort = ReceivePort()
+      ..listen((_) => workerCompleted.complete(true));
+    await Isolate.spawn(echo, port.sendPort, onExit: workerExitedPort.sendPort);
+    await inbox.moveNext();
+    outbox = inbox.current;
+  }
+
+  @override
+  Future<void> teardown() async {
+    outbox.send(null);
+    await workerCompleted.future;
+    workerExitedPort.close();
+    port.close();
+  }
+
+  final int length;
+  late List<Map<String, Object>> message;
+  late ReceivePort port;
+  late StreamIterator<dynamic> inbox;
+  late SendPort outbox;
+  late Completer<bool> workerCompleted;
+  late ReceivePort workerExitedPort;
+}
+
+// Sends every message it receives back, until it receives null.
+Future<void> echo(SendPort replyPort) async {
+  final port = ReceivePort();
+  final inbox = StreamIterator<dynamic>(port);
+  replyPort.send(port.sendPort);
+  while (true) {
+    await inbox.moveNext();
+    final received = inbox.current;
+    if (received == null) {
+      break;
+    }
+    replyPort.send(received);
+  }
+  port.close();
+}
+
+Future<void> main() async {
+  for (final length in <int>[10, 1000, 100000]) {
+    await SendReceiveListOfMaps('IsolateMessaging.ListOfMaps$length', length)
+        .report();
+  }
+}
@@ -0,0 +1,152 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import 'package:benchmark_harness/benchmark_harness.dart'
+    show PrintEmitter, ScoreEmitter;
+
+// Identical to BenchmarkBase from package:benchmark_harness but async.
+abstract class AsyncBenchmarkBase {
+  final String name;
+  final ScoreEmitter emitter;
+
+  Future<void> run();
+  Future<void> setup();
+  Future<void> teardown();
+
+  const AsyncBenchmarkBase(this.name, {this.emitter = const PrintEmitter()});
+
+  // Returns the number of microseconds per call.
+  Future<double> measureFor(int minimumMillis) async {
+    final minimumMicros = minimumMillis * 1000;
+    int iter = 0;
+    final watch = Stopwatch();
+    watch.start();
+    int elapsed = 0;
+    while (elapsed < minimumMicros) {
+      await run();
+      elapsed = watch.elapsedMicroseconds;
+      iter++;
+    }
+    return elapsed / iter;
+  }
+
+  // Measures the score for the benchmark and returns it.
+  Future<double> measure() async {
+    await setup();
+    await measureFor(500); // warm-up
+    final result = await measureFor(4000); // actual measurement
+    await teardown();
+    return result;
+  }
+
+  Future<void> report() async {
+    emitter.emit(name, await measure());
+  }
+}
+
+const int rounds = 100;
+
+// Measures how long it takes [pairs] pairs of isolates, running at the same
+// time, to each bounce [rounds] messages back and forth.
+//
+// Isolates only share a thread pool when they are in the same isolate group
+// (--enable-isolate-groups).
+class PingPong extends AsyncBenchmarkBase {
+  PingPong(String name, this.pairs) : super(name);
+
+  @override
+  Future<void> run() async {
+    for (final pinger in pingers) {
+      pinger.send(rounds);
+    }
+    for (int i = 0; i < pairs; i++) {
+      await inbox.moveNext();
+    }
+  }
+
+  @override
+  Future<void> setup() async {
+    port = ReceivePort();
+    inbox = StreamIterator<dynamic>(port);
+    exitPort = ReceivePort();
+    exits = StreamIterator<dynamic>(exitPort);
+    for (int i = 0; i < pairs; i++) {
+      await Isolate.spawn(pinger, port.sendPort, onExit: exitPort.sendPort);
+      await inbox.moveNext();
+      pingers.add(inbox.current);
+    }
+  }
+
+  @override
+  Future<void> teardown() async {
+    for (final pinger in pingers) {
+      pinger.send(null);
+    }
+    for (int i = 0; i < pairs; i++) {
+      await exits.moveNext();
+    }
+    exitPort.close();
+    port.close();
+  }
+
+  final int pairs;
+  final List<SendPort> pingers = <SendPort>[];
+  late ReceivePort port;
+  late StreamIterator<dynamic> inbox;
+  late ReceivePort exitPort;
+  late StreamIterator<dynamic> exits;
+}
+
+// Bounces the requested number of messages off an echo isolate of its own and
+// reports back to [controller] every time, until it receives null.
+Future<void> pinger(SendPort controller) async {
+  final port = ReceivePort();
+  final inbox = StreamIterator<dynamic>(port);
+  await Isolate.spawn(echo, port.sendPort);
+  await inbox.moveNext();
+  final SendPort ponger = inbox.current;
+  controller.send(port.sendPort);
+  while (true) {
+    await inbox.moveNext();
+    final rounds = inbox.current;
+    if (rounds == null) {
+      break;
+    }
+    for (int i = 0; i < rounds; i++) {
+      ponger.send(i);
+      await inbox.moveNext();
+      if (inbox.current != i) {
+        throw 'Unexpected reply ${inbox.current}';
+      }
+    }
+    controller.send(true);
+  }
+  ponger.send(null);
+  port.close();
+}
+
+// Sends every message it receives back, until it receives null.
+Future<void> echo(SendPort replyPort) async {
+  final port = ReceivePort();
+  final inbox = StreamIterator<dynamic>(port);
+  replyPort.send(port.sendPort);
+  while (true) {
+    await inbox.moveNext();
+    final received = inbox.current;
+    if (received == null) {
+      break;
+    }
+    replyPort.send(received);
+  }
+  port.close();
+}
+
+Future<void> main() async {
+  for (final pairs in <int>[1, 8, 64]) {
+    await PingPong('IsolatePingPong.Pairs$pairs', pairs).report();
+  }
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures the latency of sending large object graphs to an isolate of the
+// same isolate group. Deeply immutable graphs are passed by reference, other
+// graphs are copied.
+//
+// Run with --enable-isolate-groups, otherwise every message is copied.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import 'package:benchmark_harness/benchmark_harness.dart'
+    show PrintEmitter, ScoreEmitter;
+import 'package:meta/meta.dart';
+
+// Identical to BenchmarkBase from package:benchmark_harness but async.
+abstract class AsyncBenchmarkBase {
+  final String name;
+  final ScoreEmitter emitter;
+
+  Future<void> run();
+  Future<void> setup();
+  Future<void> teardown();
+
+  const AsyncBenchmarkBase(this.name, {this.emitter = const PrintEmitter()});
+
+  // Returns the number of microseconds per call.
+  Future<double> measureFor(int minimumMillis) async {
+    final minimumMicros = minimumMillis * 1000;
+    int iter = 0;
+    final watch = Stopwatch();
+    watch.start();
+    int elapsed = 0;
+    while (elapsed < minimumMicros) {
+      await run();
+      elapsed = watch.elapsedMicroseconds;
+      iter++;
+    }
+    return elapsed / iter;
+  }
+
+  // Measures the score for the benchmark and returns it.
+  Future<double> measure() async {
+    await setup();
+    await measureFor(500); // warm-up
+    final result = await measureFor(4000); // actual measurement
+    await teardown();
+    return result;
+  }
+
+  Future<void> report() async {
+    emitter.emit(name, await measure());
+  }
+}
+
+const int kStringLength = 1024;
+
+// Builds a tree of lists whose leaves are strings, [size] bytes in total.
+List<Object> makeGraph(int size, {@required bool immutable}) {
+  final leaves = <Object>[
+    for (int i = 0; i < size ~/ kStringLength; i++)
+      i.toRadixString(16).padLeft(kStringLength, '0')
+  ];
+  final branches = <Object>[
+    for (int i = 0; i < leaves.length; i += 64)
+      immutable
+          ? List<Object>.unmodifiable(leaves.skip(i).take(64))
+          : leaves.skip(i).take(64).toList()
+  ];
+  return immutable ? List<Object>.unmodifiable(branches) : branches;
+}
+
+class SendGraph extends AsyncBenchmarkBase {
+  SendGraph(String name, this.size, {@required this.immutable}) : super(name);
+
+  @override
+  Future<void> run() async {
+    outbox.send(graph);
+    await inbox.moveNext();
+  }
+
+  @override
+  Future<void> setup() async {
+    graph = makeGraph(size, immutable: immutable);
+    port = ReceivePort();
+    inbox = StreamIterator<dynamic>(port);
+    workerCompleted = Completer<bool>();
+    workerExitedPort = ReceivePort()
+      ..listen((_) => workerCompleted.complete(true));
+    await Isolate.spawn(receive, port.sendPort,
+        onExit: workerExitedPort.sendPort);
+    await inbox.moveNext();
+    outbox = inbox.current;
+  }
+
+  @override
+  Future<void> teardown() async {
+    outbox.send(null);
+    await workerCompleted.future;
+    workerExitedPort.close();
+    port.close();
+  }
+
+  final int size;
+  final bool immutable;
+  List<Object> graph;
+  ReceivePort port;
+  StreamIterator<dynamic> inbox;
+  SendPort outbox;
+  Completer<bool> workerCompleted;
+  ReceivePort workerExitedPort;
+}
+
+// Acknowledges every message it receives, until it receives null.
+Future<void> receive(SendPort replyPort) async {
+  final port = ReceivePort();
+  final inbox = StreamIterator<dynamic>(port);
+  replyPort.send(port.sendPort);
+  while (true) {
+    await inbox.moveNext();
+    final received = inbox.current;
+    if (received == null) {
+      break;
+    }
+    replyPort.send(received.length);
+  }
+  port.close();
+}
+
+class SizeName {
+  const SizeName(this.size, this.name);
+
+  final int size;
+  final String name;
+}
+
+const List<SizeName> sizes = <SizeName>[
+  SizeName(1 * 1024 * 1024, '1MB'),
+  SizeName(100 * 1024 * 1024, '100MB'),
+];
+
+Future<void> main() async {
+  for (final sizeName in sizes) {
+    await SendGraph('IsolateSendImmutable.Immutable${sizeName.name}',
+            sizeName.size,
+            immutable: true)
+        .report();
+    await SendGraph(
+            'IsolateSendImmutable.Mutable${sizeName.name}', sizeName.size,
+            immutable: false)
+        .report();
+  }
+}
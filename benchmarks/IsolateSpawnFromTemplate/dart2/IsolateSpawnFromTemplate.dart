@@ -0,0 +1,100 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures the latency of spawning an isolate into the same isolate group and
+// receiving a reply that depends on an expensive, deeply immutable static
+// field. It is measured before and after the static field values of the main
+// isolate are saved with Dart_SaveIsolateGroupTemplate(). Isolates spawned
+// from the template do not run the initializer of the field again.
+//
+// Run in the precompiled runtime with --enable-isolate-groups, the JIT does
+// not support isolate group templates.
+
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:isolate';
+
+import 'package:benchmark_harness/benchmark_harness.dart'
+    show PrintEmitter, ScoreEmitter;
+
+// Identical to BenchmarkBase from package:benchmark_harness but async.
+abstract class AsyncBenchmarkBase {
+  final String name;
+  final ScoreEmitter emitter;
+
+  Future<void> run();
+
+  const AsyncBenchmarkBase(this.name, {this.emitter = const PrintEmitter()});
+
+  // Returns the number of microseconds per call.
+  Future<double> measureFor(int minimumMillis) async {
+    final minimumMicros = minimumMillis * 1000;
+    int iter = 0;
+    final watch = Stopwatch();
+    watch.start();
+    int elapsed = 0;
+    while (elapsed < minimumMicros) {
+      await run();
+      elapsed = watch.elapsedMicroseconds;
+      iter++;
+    }
+    return elapsed / iter;
+  }
+
+  // Measures the score for the benchmark and returns it.
+  Future<double> measure() async {
+    await measureFor(500); // warm-up
+    return await measureFor(4000); // actual measurement
+  }
+
+  Future<void> report() async {
+    emitter.emit(name, await measure());
+  }
+}
+
+final saveIsolateGroupTemplate = DynamicLibrary.executable()
+    .lookupFunction<Handle Function(), Object Function()>(
+        'Dart_SaveIsolateGroupTemplate');
+
+const int kTableSize = 10000;
+
+// Deeply immutable, so it can be saved in the isolate group template.
+final List<String> table = List<String>.unmodifiable(<String>[
+  for (int i = 0; i < kTableSize; i++) i.toRadixString(16).padLeft(16, '0')
+]);
+
+void replyWithTableSize(SendPort replyPort) {
+  replyPort.send(table.length);
+}
+
+class Spawn extends AsyncBenchmarkBase {
+  Spawn(String name) : super(name);
+
+  @override
+  Future<void> run() async {
+    final port = ReceivePort();
+    final inbox = StreamIterator<dynamic>(port);
+    final exitPort = ReceivePort();
+    final exited = StreamIterator<dynamic>(exitPort);
+    await Isolate.spawn(replyWithTableSize, port.sendPort,
+        onExit: exitPort.sendPort);
+    await inbox.moveNext();
+    if (inbox.current != kTableSize) {
+      throw 'Unexpected reply: ${inbox.current}';
+    }
+    await exited.moveNext();
+    await inbox.cancel();
+    await exited.cancel();
+  }
+}
+
+Future<void> main() async {
+  // Initialize the table in the main isolate.
+  if (table.length != kTableSize) {
+    throw 'Unexpected table size: ${table.length}';
+  }
+  await Spawn('IsolateSpawnFromTemplate.NoTemplate').report();
+  saveIsolateGroupTemplate();
+  await Spawn('IsolateSpawnFromTemplate.Template').report();
+}
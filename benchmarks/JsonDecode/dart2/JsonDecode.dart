@@ -0,0 +1,131 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmark for JSON decoding of complete documents from strings and UTF-8
+// bytes, compared with the chunked decoder which always parses in Dart.
+
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+// A payload resembling a typical API response.
+String makePayload(int records) {
+  final List<Object> list = [];
+  for (int i = 0; i < records; i++) {
+    list.add({
+      'id': i,
+      'uuid': '6f1c${i.toRadixString(16).padLeft(8, '0')}-4b1e-9a57-000000',
+      'name': 'User number $i',
+      'email': 'user$i@example.com',
+      'active': i % 3 != 0,
+      'score': i * 1.25,
+      'tags': ['alpha', 'beta', if (i.isEven) 'gamma'],
+      'address': {
+        'street': '${i % 1000} Main Street',
+        'city': i.isEven ? 'København' : 'Zürich',
+        'zip': '${10000 + i % 90000}',
+      },
+      'bio': 'Line one\nLine "two" with a backslash \\ and a tab\t.',
+      'parent': null,
+    });
+  }
+  return jsonEncode(list);
+}
+
+abstract class JsonDecodeBase extends BenchmarkBase {
+  final int size;
+  final String payload;
+  Uint8List bytes;
+
+  JsonDecodeBase(String kind, this.size)
+      : payload = makePayload(size),
+        super('JsonDecode.$kind.$size');
+
+  Object decode();
+
+  @override
+  void setup() {
+    bytes = utf8.encode(payload) as Uint8List;
+  }
+
+  @override
+  void run() {
+    final List result = decode() as List;
+    if (result.length != size) {
+      throw 'Decoded list length doesn\'t match expected.';
+    }
+  }
+
+  @override
+  void exercise() {
+    // Only a single run per measurement.
+    run();
+  }
+
+  @override
+  void warmup() {
+    BenchmarkBase.measureFor(run, 1000);
+  }
+
+  @override
+  double measure() {
+    // Report time per input byte.
+    return super.measure() / bytes.length;
+  }
+
+  @override
+  void report() {
+    // Report time in nanoseconds.
+    final double score = measure() * 1000.0;
+    print('$name(RunTime): $score ns.');
+  }
+}
+
+class JsonDecodeString extends JsonDecodeBase {
+  JsonDecodeString(int size) : super('String', size);
+
+  @override
+  Object decode() => jsonDecode(payload);
+}
+
+class JsonDecodeBytes extends JsonDecodeBase {
+  static final Converter<List<int>, Object> decoder =
+      utf8.decoder.fuse(json.decoder);
+
+  JsonDecodeBytes(int size) : super('Bytes', size);
+
+  @override
+  Object decode() => decoder.convert(bytes);
+}
+
+class JsonDecodeChunked extends JsonDecodeBase {
+  JsonDecodeChunked(int size) : super('Chunked', size);
+
+  @override
+  Object decode() {
+    Object result;
+    final callback = ChunkedConversionSink<Object>.withCallback((values) {
+      result = values.single;
+    });
+    json.decoder.startChunkedConversion(callback)
+      ..add(payload)
+      ..close();
+    return result;
+  }
+}
+
+void main(List<String> args) {
+  final benchmarks = [
+    for (int size in [10, 1000, 100000]) ...[
+      () => JsonDecodeString(size),
+      () => JsonDecodeBytes(size),
+      () => JsonDecodeChunked(size),
+    ]
+  ];
+
+  for (var bm in benchmarks) {
+    bm().report();
+  }
+}
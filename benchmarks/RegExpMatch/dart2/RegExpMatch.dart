@@ -0,0 +1,107 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmarks for finding matches of regular expressions in large inputs that
+// contain many of them, reported as time per MB of input.
+//
+// Where regexps are interpreted, as in AOT, matches are found with a DFA and
+// the backtracking matcher only runs at the start of each match, or not at
+// all without captures. In JIT mode regexps are compiled and called directly,
+// so run this benchmark in AOT to measure the DFA.
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int inputSize = 1024 * 1024;
+
+const List<String> requestLines = [
+  'GET /index.html took 12ms status=200\n',
+  'POST /api/users took 48ms status=201\n',
+  'GET /static/app.js took 3ms status=304\n',
+  'PUT /api/users/settings took 95ms status=200\n',
+  'the quick brown fox jumps over the lazy dog\n',
+];
+
+// Builds about [inputSize] code units of request log lines, ending with a
+// line only matched by the 'Last' benchmark.
+String makeLog({bool twoByte = false}) {
+  final StringBuffer buffer = StringBuffer();
+  int line = 0;
+  while (buffer.length < inputSize) {
+    buffer.write(requestLines[line % requestLines.length]);
+    if (twoByte && line % 100 == 0) buffer.write('\u{2014}\n');
+    line++;
+  }
+  buffer.write('DELETE /api/users took 7ms status=204!\n');
+  return buffer.toString();
+}
+
+class RegExpMatchBenchmark extends BenchmarkBase {
+  final RegExp regexp;
+  final bool twoByte;
+  String input;
+  int expected;
+
+  RegExpMatchBenchmark(String name, String pattern, this.twoByte)
+      : regexp = RegExp(pattern),
+        super('RegExpMatch.$name.${twoByte ? 'TwoByte' : 'OneByte'}');
+
+  // Sums the match positions, so that a wrong start or end is noticed.
+  int sumMatches() {
+    int sum = 0;
+    for (final match in regexp.allMatches(input)) {
+      sum += match.start + match.end;
+    }
+    return sum;
+  }
+
+  @override
+  void setup() {
+    input = makeLog(twoByte: twoByte);
+    expected = sumMatches();
+  }
+
+  @override
+  void run() {
+    if (sumMatches() != expected) {
+      throw 'Unexpected result in $name.';
+    }
+  }
+
+  @override
+  void exercise() {
+    // Only a single run per measurement.
+    run();
+  }
+
+  @override
+  void warmup() {
+    BenchmarkBase.measureFor(run, 1000);
+  }
+
+  @override
+  double measure() {
+    // Report time per MB of input.
+    return super.measure() * (1024 * 1024) / input.length;
+  }
+}
+
+void main() {
+  final benchmarks = [
+    for (final twoByte in [false, true]) ...[
+      // Many matches without captures.
+      () => RegExpMatchBenchmark('Words', r'[a-z]+ [a-z]+', twoByte),
+      // Many matches of alternatives with a variable length.
+      () => RegExpMatchBenchmark(
+          'Alternatives', r'(?:GET|POST|PUT) /[a-z/.]+', twoByte),
+      // Many matches with captures.
+      () => RegExpMatchBenchmark('Captures', r'([a-z]+)=(\d+)', twoByte),
+      // A single match at the end, after many partial matches.
+      () => RegExpMatchBenchmark(
+          'Last', r'[A-Z]+ /[a-z/]+ took \d+ms status=\d+!', twoByte),
+    ],
+  ];
+  for (final bm in benchmarks) {
+    bm().report();
+  }
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmarks for scanning large inputs with regular expressions that rarely
+// match, reported as time per MB of input.
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int inputSize = 1024 * 1024;
+
+const List<String> logLines = [
+  'INFO: request handled in 12ms by worker 3\n',
+  'DEBUG: cache lookup for key user:1234 returned a hit\n',
+  'INFO: connection from 10.0.0.17 accepted\n',
+  'WARNING: slow response from upstream service (250ms)\n',
+];
+
+// Builds a log of about [inputSize] code units with an error every
+// [errorEvery] lines.
+String makeLog({bool twoByte = false, int errorEvery = 1000}) {
+  final StringBuffer buffer = StringBuffer();
+  int line = 0;
+  while (buffer.length < inputSize) {
+    if (line % errorEvery == errorEvery - 1) {
+      buffer.write('ERROR: 503 upstream unavailable\n');
+    } else {
+      buffer.write(logLines[line % logLines.length]);
+    }
+    if (twoByte && line % 100 == 0) buffer.write('\u{2014}\n');
+    line++;
+  }
+  return buffer.toString();
+}
+
+class RegExpScan extends BenchmarkBase {
+  final RegExp regexp;
+  final bool twoByte;
+  String input;
+  int expected;
+
+  RegExpScan(String name, String pattern, this.twoByte)
+      : regexp = RegExp(pattern),
+        super('RegExpScan.$name.${twoByte ? 'TwoByte' : 'OneByte'}');
+
+  int countMatches() => regexp.allMatches(input).length;
+
+  @override
+  void setup() {
+    input = makeLog(twoByte: twoByte);
+    expected = countMatches();
+  }
+
+  @override
+  void run() {
+    if (countMatches() != expected) {
+      throw 'Unexpected result in $name.';
+    }
+  }
+
+  @override
+  void exercise() {
+    // Only a single run per measurement.
+    run();
+  }
+
+  @override
+  void warmup() {
+    BenchmarkBase.measureFor(run, 1000);
+  }
+
+  @override
+  double measure() {
+    // Report time per MB of input.
+    return super.measure() * (1024 * 1024) / input.length;
+  }
+}
+
+void main() {
+  final benchmarks = [
+    for (final twoByte in [false, true]) ...[
+      // A literal prefix.
+      () => RegExpScan('Prefix', r'ERROR: (\d+)', twoByte),
+      // A literal at a fixed offset after a class.
+      () => RegExpScan('FixedOffset', r'\d{3} upstream unavailable', twoByte),
+      // A literal at a variable offset.
+      () => RegExpScan('Inner', r'[A-Z]+: \d+ upstream', twoByte),
+      // No literal at all.
+      () => RegExpScan('NoLiteral', r'[0-9]{3}[a-z]{3}', twoByte),
+    ],
+  ];
+  for (final bm in benchmarks) {
+    bm().report();
+  }
+}
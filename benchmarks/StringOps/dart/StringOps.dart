@@ -0,0 +1,182 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmarks for searching, comparing and hashing strings.
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const String sample = 'The quick brown fox jumps over the lazy dog. ';
+
+// Builds a string of [size] code units that ends with [suffix].
+String makeText(int size, String suffix, {bool twoByte = false}) {
+  final StringBuffer buffer = StringBuffer();
+  if (twoByte) buffer.write('\u{1234}');
+  while (buffer.length < size - suffix.length) {
+    buffer.write(sample);
+  }
+  return buffer.toString().substring(0, size - suffix.length) + suffix;
+}
+
+// Returns a copy of [s] which is not identical to it.
+String copyOf(String s) => String.fromCharCodes(s.codeUnits);
+
+abstract class StringOpsBase extends BenchmarkBase {
+  final int size;
+  final bool twoByte;
+  late String text;
+  late String other;
+
+  StringOpsBase(String operation, this.size, this.twoByte)
+      : super('StringOps.$operation.${twoByte ? 'TwoByte' : 'OneByte'}.'
+            '${size >= 1000 ? '${size ~/ 1000}k' : '$size'}');
+
+  // Returns a value derived from the operation's result.
+  int operation();
+
+  int get expected;
+
+  @override
+  void setup() {
+    text = makeText(size, 'needle!', twoByte: twoByte);
+    other = copyOf(text);
+  }
+
+  @override
+  void run() {
+    if (operation() != expected) {
+      throw 'Unexpected result in $name.';
+    }
+  }
+
+  @override
+  void exercise() {
+    // Only a single run per measurement.
+    run();
+  }
+
+  @override
+  void warmup() {
+    BenchmarkBase.measureFor(run, 1000);
+  }
+
+  @override
+  double measure() {
+    // Report time per code unit.
+    return super.measure() / size;
+  }
+
+  @override
+  void report() {
+    // Report time in nanoseconds.
+    final double score = measure() * 1000.0;
+    print('$name(RunTime): $score ns.');
+  }
+}
+
+class IndexOfChar extends StringOpsBase {
+  IndexOfChar(int size, bool twoByte) : super('IndexOfChar', size, twoByte);
+
+  @override
+  int operation() => text.indexOf('!');
+
+  @override
+  int get expected => size - 1;
+}
+
+class IndexOfString extends StringOpsBase {
+  IndexOfString(int size, bool twoByte)
+      : super('IndexOfString', size, twoByte);
+
+  @override
+  int operation() => text.indexOf('needle');
+
+  @override
+  int get expected => size - 7;
+}
+
+class Contains extends StringOpsBase {
+  Contains(int size, bool twoByte) : super('Contains', size, twoByte);
+
+  @override
+  int operation() => text.contains('haystack') ? 1 : 0;
+
+  @override
+  int get expected => 0;
+}
+
+class Equals extends StringOpsBase {
+  Equals(int size, bool twoByte) : super('Equals', size, twoByte);
+
+  @override
+  int operation() => text == other ? 1 : 0;
+
+  @override
+  int get expected => 1;
+}
+
+class CompareTo extends StringOpsBase {
+  CompareTo(int size, bool twoByte) : super('CompareTo', size, twoByte);
+
+  @override
+  int operation() => text.compareTo(other);
+
+  @override
+  int get expected => 0;
+}
+
+class StartsWith extends StringOpsBase {
+  late String prefix;
+
+  StartsWith(int size, bool twoByte) : super('StartsWith', size, twoByte);
+
+  @override
+  void setup() {
+    super.setup();
+    prefix = copyOf(text.substring(0, size - 1));
+  }
+
+  @override
+  int operation() => text.startsWith(prefix) ? 1 : 0;
+
+  @override
+  int get expected => 1;
+}
+
+class HashCode extends StringOpsBase {
+  int expectedHash = 0;
+
+  HashCode(int size, bool twoByte) : super('HashCode', size, twoByte);
+
+  @override
+  void setup() {
+    super.setup();
+    expectedHash = text.substring(1).hashCode;
+  }
+
+  // Hash codes are cached, so each run hashes a fresh copy.
+  @override
+  int operation() => text.substring(1).hashCode;
+
+  @override
+  int get expected => expectedHash;
+}
+
+void main(List<String> args) {
+  final benchmarks = [
+    for (int size in [16, 1000, 100000])
+      for (bool twoByte in [false, true]) ...[
+        () => IndexOfChar(size, twoByte),
+        () => IndexOfString(size, twoByte),
+        () => Contains(size, twoByte),
+        () => Equals(size, twoByte),
+        () => CompareTo(size, twoByte),
+        () => StartsWith(size, twoByte),
+        () => HashCode(size, twoByte),
+      ]
+  ];
+
+  for (var bm in benchmarks) {
+    bm().report();
+  }
+}
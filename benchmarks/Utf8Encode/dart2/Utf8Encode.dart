@@ -0,0 +1,99 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmark for UTF-8 encoding
+
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const Map<String, String> samples = {
+  // Pure ASCII.
+  'en': 'The quick brown fox jumps over the lazy dog. ',
+  // Mostly ASCII with some Latin-1 characters.
+  'da': 'Høj bølgegang på søen får ænderne til at flyve væk. ',
+  // Two-byte UTF-8 sequences separated by spaces.
+  'ru': 'Съешь же ещё этих мягких французских булок, да выпей чаю. ',
+  // Three-byte UTF-8 sequences.
+  'zh': '我能吞下玻璃而不伤身体。敏捷的棕色狐狸跳过了懒狗。',
+  // Surrogate pairs and ASCII.
+  'emoji': 'Smile 😀, laugh 😂 and wave 👋 at the dog 🐶. ',
+};
+
+class Utf8Encode extends BenchmarkBase {
+  final String language;
+  final int size;
+  String text;
+  int expectedLength;
+
+  static String _makeName(String language, int size) {
+    String name = 'Utf8Encode.$language.';
+    name += size >= 1000000
+        ? '${size ~/ 1000000}M'
+        : size >= 1000 ? '${size ~/ 1000}k' : '$size';
+    return name;
+  }
+
+  Utf8Encode(this.language, this.size) : super(_makeName(language, size));
+
+  @override
+  void setup() {
+    final String sample = samples[language];
+    final StringBuffer buffer = StringBuffer();
+    while (buffer.length < size) {
+      buffer.write(sample);
+    }
+    text = buffer.toString().substring(0, size);
+    expectedLength = 0;
+    for (final int rune in text.runes) {
+      expectedLength += rune < 0x80
+          ? 1
+          : rune < 0x800 ? 2 : rune < 0x10000 ? 3 : 4;
+    }
+  }
+
+  @override
+  void run() {
+    final Uint8List bytes = utf8.encode(text) as Uint8List;
+    if (bytes.length != expectedLength) {
+      throw 'Output length doesn\'t match expected.';
+    }
+  }
+
+  @override
+  void exercise() {
+    // Only a single run per measurement.
+    run();
+  }
+
+  @override
+  void warmup() {
+    BenchmarkBase.measureFor(run, 1000);
+  }
+
+  @override
+  double measure() {
+    // Report time per input character.
+    return super.measure() / size;
+  }
+
+  @override
+  void report() {
+    // Report time in nanoseconds.
+    final double score = measure() * 1000.0;
+    print('$name(RunTime): $score ns.');
+  }
+}
+
+void main(List<String> args) {
+  final benchmarks = [
+    for (int size in [10, 10000, 10000000])
+      for (String language in samples.keys) () => Utf8Encode(language, size)
+  ];
+
+  for (var bm in benchmarks) {
+    bm().report();
+  }
+}
@@ -184,6 +184,11 @@ static void PrintUsage() {
 "[--save-obfuscation-map=<map-filename>]                                     \n"
 "<dart-kernel-file>                                                          \n"
 "                                                                            \n"
+"AOT snapshots can use type feedback recorded by a JIT run of the same       \n"
+"program (dart --save_type_feedback=<filename>) to speculate on receiver     \n"
+"classes and to prioritize inlining. This is enabled with                    \n"
+"--load_type_feedback=<filename>.                                            \n"
+"                                                                            \n"
 "AOT snapshots can be obfuscated: that is all identifiers will be renamed    \n"
 "during compilation. This mode is enabled with --obfuscate flag. Mapping     \n"
 "between original and obfuscated names can be serialized as a JSON array     \n"
@@ -421,7 +426,8 @@ static void MaybeLoadCode() {
   }
 
   if ((load_type_feedback_filename != NULL) &&
-      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT))) {
+      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT) ||
+       IsSnapshottingForPrecompilation())) {
     uint8_t* buffer = NULL;
     intptr_t size = 0;
     ReadFile(load_type_feedback_filename, &buffer, &size);
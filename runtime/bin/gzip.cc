@@ -11,7 +11,7 @@
 namespace dart {
 namespace bin {
 
-void Decompress(const uint8_t* input,
+bool Decompress(const uint8_t* input,
                 intptr_t input_len,
                 uint8_t** output,
                 intptr_t* output_length) {
@@ -37,11 +37,17 @@ void Decompress(const uint8_t* input,
   strm.avail_in = 0;
   strm.next_in = 0;
   int ret = inflateInit2(&strm, 32 + MAX_WBITS);
-  ASSERT(ret == Z_OK);
+  bool failed = (ret != Z_OK);
 
   intptr_t input_cursor = 0;
   intptr_t output_cursor = 0;
-  do {
+  while (!failed && (ret != Z_STREAM_END)) {
+    // The input ran out before the end of the stream: it is truncated.
+    if (input_cursor == input_len) {
+      failed = true;
+      break;
+    }
+
     // Setup input.
     intptr_t size_in = input_len - input_cursor;
     if (size_in > kChunkSize) {
@@ -57,8 +63,13 @@ void Decompress(const uint8_t* input,
       strm.next_out = &chunk_out[0];
       // Inflate.
       ret = inflate(&strm, Z_SYNC_FLUSH);
-      // We either hit the end of the stream or made forward progress.
-      ASSERT((ret == Z_STREAM_END) || (ret == Z_OK));
+      // Z_BUF_ERROR only means no progress was possible with the current
+      // chunk; running out of input is detected above. Anything else other
+      // than forward progress or the end of the stream is corrupt input.
+      if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR)) {
+        failed = true;
+        break;
+      }
       // Grow output buffer size.
       intptr_t size_out = kChunkSize - strm.avail_out;
       if (size_out > (output_capacity - output_cursor)) {
@@ -69,18 +80,60 @@ void Decompress(const uint8_t* input,
       // Copy output.
       memmove(&((*output)[output_cursor]), &chunk_out[0], size_out);
       output_cursor += size_out;
-    } while (strm.avail_out == 0);
+    } while ((strm.avail_out == 0) && (ret != Z_STREAM_END));
 
     // We've processed size_in bytes.
     input_cursor += size_in;
 
     // We're finished decompressing when zlib tells us.
-  } while (ret != Z_STREAM_END);
+  }
 
   inflateEnd(&strm);
+  free(chunk_out);
 
+  if (failed) {
+    free(*output);
+    *output = NULL;
+    *output_length = 0;
+    return false;
+  }
   *output_length = output_cursor;
-  free(chunk_out);
+  return true;
+}
+
+void Compress(const uint8_t* input,
+              intptr_t input_len,
+              uint8_t** output,
+              intptr_t* output_length) {
+  ASSERT(input != NULL);
+  ASSERT(output != NULL);
+  ASSERT(output_length != NULL);
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  // Add 16 to the window bits to write a gzip header instead of a zlib one.
+  int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  ASSERT(ret == Z_OK);
+
+  const intptr_t output_capacity = deflateBound(&strm, input_len);
+  *output = reinterpret_cast<uint8_t*>(malloc(output_capacity));
+  strm.avail_in = input_len;
+  strm.next_in = const_cast<uint8_t*>(input);
+  strm.avail_out = output_capacity;
+  strm.next_out = *output;
+  // The output buffer is large enough to finish in a single call.
+  ret = deflate(&strm, Z_FINISH);
+  ASSERT(ret == Z_STREAM_END);
+
+  *output_length = output_capacity - strm.avail_out;
+  deflateEnd(&strm);
+}
+
+bool IsGzipped(const uint8_t* input, intptr_t input_len) {
+  return (input_len >= 2) && (input[0] == 0x1f) && (input[1] == 0x8b);
 }
 
 }  // namespace bin
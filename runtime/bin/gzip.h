@@ -13,11 +13,23 @@ namespace bin {
 // |input| is assumed to be a gzipped stream.
 // This function allocates the output buffer in the C heap and the caller
 // is responsible for freeing it.
-void Decompress(const uint8_t* input,
+// Returns false, and sets |output| to NULL, if |input| is corrupt or
+// truncated.
+bool Decompress(const uint8_t* input,
                 intptr_t input_len,
                 uint8_t** output,
                 intptr_t* output_length);
 
+// Compresses |input| into a gzip stream. The output buffer is allocated in
+// the C heap and the caller is responsible for freeing it.
+void Compress(const uint8_t* input,
+              intptr_t input_len,
+              uint8_t** output,
+              intptr_t* output_length);
+
+// Returns true if |input| starts with the gzip magic bytes.
+bool IsGzipped(const uint8_t* input, intptr_t input_len);
+
 }  // namespace bin
 }  // namespace dart
 
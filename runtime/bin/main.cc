@@ -166,7 +166,8 @@ static void OnExitHook(int64_t exit_code) {
   }
   if (exit_code == 0) {
     if (Options::gen_snapshot_kind() == kAppJIT) {
-      Snapshot::GenerateAppJIT(Options::snapshot_filename());
+      Snapshot::GenerateAppJIT(Options::snapshot_filename(),
+                               Options::compress_snapshot());
     }
     WriteDepsFile(main_isolate);
   }
@@ -952,7 +953,8 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
     // Generate an app snapshot after execution if specified.
     if (Options::gen_snapshot_kind() == kAppJIT) {
       if (!Dart_IsCompilationError(result)) {
-        Snapshot::GenerateAppJIT(Options::snapshot_filename());
+        Snapshot::GenerateAppJIT(Options::snapshot_filename(),
+                                 Options::compress_snapshot());
       }
     }
     CHECK_RESULT(result);
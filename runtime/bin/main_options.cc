@@ -169,6 +169,9 @@ void Options::PrintUsage() {
 "    <snapshot-kind> controls the kind of snapshot, it could be\n"
 "                    kernel(default) or app-jit\n"
 "    <file_name> specifies the file into which the snapshot is written\n"
+"--compress-snapshot\n"
+"  Compress the data of an app-jit snapshot. It is inflated into memory\n"
+"  when the snapshot is loaded.\n"
 "--version\n"
 "  Print the SDK version.\n");
   } else {
@@ -202,6 +205,9 @@ void Options::PrintUsage() {
 "    <snapshot-kind> controls the kind of snapshot, it could be\n"
 "                    kernel(default) or app-jit\n"
 "    <file_name> specifies the file into which the snapshot is written\n"
+"--compress-snapshot\n"
+"  Compress the data of an app-jit snapshot. It is inflated into memory\n"
+"  when the snapshot is loaded.\n"
 "--version\n"
 "  Print the VM version.\n"
 "\n"
@@ -12,6 +12,7 @@
 #include "bin/error_exit.h"
 #include "bin/extensions.h"
 #include "bin/file.h"
+#include "bin/gzip.h"
 #include "bin/platform.h"
 #include "include/dart_api.h"
 #include "platform/utils.h"
@@ -40,13 +41,26 @@ class MappedAppSnapshot : public AppSnapshot {
     delete vm_instructions_mapping_;
     delete isolate_data_mapping_;
     delete isolate_instructions_mapping_;
+    free(vm_data_inflated_);
+    free(isolate_data_inflated_);
+  }
+
+  // Data sections written with --compress-snapshot start with a gzip header.
+  // They are inflated into the C heap and the file mapping is released.
+  // Returns false if a compressed section is corrupt or truncated.
+  bool InflateDataSections(int64_t vm_data_size, int64_t isolate_data_size) {
+    return Inflate(&vm_data_mapping_, vm_data_size, &vm_data_inflated_) &&
+           Inflate(&isolate_data_mapping_, isolate_data_size,
+                   &isolate_data_inflated_);
   }
 
   void SetBuffers(const uint8_t** vm_data_buffer,
                   const uint8_t** vm_instructions_buffer,
                   const uint8_t** isolate_data_buffer,
                   const uint8_t** isolate_instructions_buffer) {
-    if (vm_data_mapping_ != NULL) {
+    if (vm_data_inflated_ != nullptr) {
+      *vm_data_buffer = vm_data_inflated_;
+    } else if (vm_data_mapping_ != NULL) {
       *vm_data_buffer =
           reinterpret_cast<const uint8_t*>(vm_data_mapping_->address());
     }
@@ -54,7 +68,9 @@ class MappedAppSnapshot : public AppSnapshot {
       *vm_instructions_buffer =
           reinterpret_cast<const uint8_t*>(vm_instructions_mapping_->address());
     }
-    if (isolate_data_mapping_ != NULL) {
+    if (isolate_data_inflated_ != nullptr) {
+      *isolate_data_buffer = isolate_data_inflated_;
+    } else if (isolate_data_mapping_ != NULL) {
       *isolate_data_buffer =
           reinterpret_cast<const uint8_t*>(isolate_data_mapping_->address());
     }
@@ -65,10 +81,28 @@ class MappedAppSnapshot : public AppSnapshot {
   }
 
  private:
+  static bool Inflate(MappedMemory** mapping,
+                      int64_t size,
+                      uint8_t** inflated) {
+    if (*mapping == nullptr) return true;
+    const uint8_t* data =
+        reinterpret_cast<const uint8_t*>((*mapping)->address());
+    if (!IsGzipped(data, size)) return true;
+    intptr_t inflated_size = 0;
+    if (!Decompress(data, size, inflated, &inflated_size)) {
+      return false;
+    }
+    delete *mapping;
+    *mapping = nullptr;
+    return true;
+  }
+
   MappedMemory* vm_data_mapping_;
   MappedMemory* vm_instructions_mapping_;
   MappedMemory* isolate_data_mapping_;
   MappedMemory* isolate_instructions_mapping_;
+  uint8_t* vm_data_inflated_ = nullptr;
+  uint8_t* isolate_data_inflated_ = nullptr;
 };
 
 static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name,
@@ -145,8 +179,15 @@ static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name,
     }
   }
 
-  return new MappedAppSnapshot(vm_data_mapping, vm_instr_mapping,
-                               isolate_data_mapping, isolate_instr_mapping);
+  auto snapshot = new MappedAppSnapshot(vm_data_mapping, vm_instr_mapping,
+                                        isolate_data_mapping,
+                                        isolate_instr_mapping);
+  if (!snapshot->InflateDataSections(vm_data_size, isolate_data_size)) {
+    Syslog::PrintErr("Corrupt compressed snapshot: %s\n", script_name);
+    delete snapshot;
+    return nullptr;
+  }
+  return snapshot;
 }
 
 static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
@@ -409,12 +450,34 @@ void Snapshot::WriteAppSnapshot(const char* filename,
                                 uint8_t* isolate_data_buffer,
                                 intptr_t isolate_data_size,
                                 uint8_t* isolate_instructions_buffer,
-                                intptr_t isolate_instructions_size) {
+                                intptr_t isolate_instructions_size,
+                                bool compress_data) {
   File* file = File::Open(NULL, filename, File::kWriteTruncate);
   if (file == NULL) {
     ErrorExit(kErrorExitCode, "Unable to write snapshot file '%s'\n", filename);
   }
 
+  // Only the data sections are compressed: instructions have to stay
+  // mappable as executable. The header records the compressed sizes.
+  std::unique_ptr<uint8_t, decltype(std::free)*> compressed_vm_data{nullptr,
+                                                                    std::free};
+  std::unique_ptr<uint8_t, decltype(std::free)*> compressed_isolate_data{
+      nullptr, std::free};
+  if (compress_data) {
+    uint8_t* buffer = nullptr;
+    if (vm_data_size != 0) {
+      Compress(vm_data_buffer, vm_data_size, &buffer, &vm_data_size);
+      compressed_vm_data.reset(buffer);
+      vm_data_buffer = buffer;
+    }
+    if (isolate_data_size != 0) {
+      Compress(isolate_data_buffer, isolate_data_size, &buffer,
+               &isolate_data_size);
+      compressed_isolate_data.reset(buffer);
+      isolate_data_buffer = buffer;
+    }
+  }
+
   file->WriteFully(appjit_magic_number.bytes, appjit_magic_number.length);
   WriteInt64(file, vm_data_size);
   WriteInt64(file, vm_instructions_size);
@@ -488,7 +551,8 @@ void Snapshot::GenerateKernel(const char* snapshot_filename,
 #endif  // !defined(EXCLUDE_CFE_AND_KERNEL_PLATFORM) && !defined(TESTING)
 }
 
-void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
+void Snapshot::GenerateAppJIT(const char* snapshot_filename,
+                              bool compress_data) {
 #if defined(TARGET_ARCH_IA32)
   // Snapshots with code are not supported on IA32.
   uint8_t* isolate_buffer = NULL;
@@ -501,7 +565,7 @@ void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
   }
 
   WriteAppSnapshot(snapshot_filename, NULL, 0, NULL, 0, isolate_buffer,
-                   isolate_size, NULL, 0);
+                   isolate_size, NULL, 0, compress_data);
 #else
   uint8_t* isolate_data_buffer = NULL;
   intptr_t isolate_data_size = 0;
@@ -515,7 +579,7 @@ void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
   }
   WriteAppSnapshot(snapshot_filename, NULL, 0, NULL, 0, isolate_data_buffer,
                    isolate_data_size, isolate_instructions_buffer,
-                   isolate_instructions_size);
+                   isolate_instructions_size, compress_data);
 #endif
 }
 
@@ -31,7 +31,8 @@ class Snapshot {
   static void GenerateKernel(const char* snapshot_filename,
                              const char* script_name,
                              const char* package_config);
-  static void GenerateAppJIT(const char* snapshot_filename);
+  static void GenerateAppJIT(const char* snapshot_filename,
+                             bool compress_data = false);
   static void GenerateAppAOTAsAssembly(const char* snapshot_filename);
 
   static AppSnapshot* TryReadAppendedAppSnapshotElf(const char* container_path);
@@ -46,7 +47,8 @@ class Snapshot {
                                uint8_t* isolate_data_buffer,
                                intptr_t isolate_data_size,
                                uint8_t* isolate_instructions_buffer,
-                               intptr_t isolate_instructions_size);
+                               intptr_t isolate_instructions_size,
+                               bool compress_data = false);
 
  private:
   DISALLOW_ALLOCATION();
@@ -1016,6 +1016,23 @@ DART_EXPORT void* Dart_CurrentIsolateGroupData();
  */
 DART_EXPORT void* Dart_IsolateGroupData(Dart_Isolate isolate);
 
+/**
+ * Makes the static field values of the current isolate the initial values
+ * of isolates spawned into its group from now on, so that those isolates do
+ * not run the corresponding initializers again.
+ *
+ * Only values which are deeply immutable (numbers, strings, constants and
+ * unmodifiable lists of those) are recorded, since mutable state must not
+ * be shared between isolates. All other static fields of a spawned isolate
+ * are initialized as usual.
+ *
+ * This is only supported by the precompiled runtime, where isolates spawned
+ * into an existing group are cloned from the group's initial state.
+ *
+ * \return A valid handle if no error occurs during the operation.
+ */
+DART_EXPORT Dart_Handle Dart_SaveIsolateGroupTemplate();
+
 /**
  * Returns the debugging name for the current isolate.
  *
@@ -3498,6 +3515,10 @@ Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length);
  * Compile functions using data from Dart_SaveTypeFeedback. The data must from a
  * VM with the same version and compiler flags.
  *
+ * When precompiling, no functions are compiled. Instead the feedback is kept
+ * for Dart_Precompile, which uses it for receiver class speculation and
+ * inlining decisions. In this case the compiler flags need not match.
+ *
  * \return Returns an error handle if a compilation error was encountered or a
  *   version mismatch is detected.
  */
@@ -42,6 +42,10 @@ typedef void (*Dart_NativeMessageHandler_DL)(Dart_Port_DL dest_port_id,
 DART_EXTERN_C bool (*Dart_PostCObject_DL)(Dart_Port_DL port_id,
                                           Dart_CObject* message);
 
+DART_EXTERN_C bool (*Dart_PostCObjects_DL)(Dart_Port_DL port_id,
+                                           intptr_t num_messages,
+                                           Dart_CObject** messages);
+
 DART_EXTERN_C bool (*Dart_PostInteger_DL)(Dart_Port_DL port_id,
                                           int64_t message);
 
@@ -111,6 +111,34 @@ typedef struct _Dart_CObject {
  */
 DART_EXPORT bool Dart_PostCObject(Dart_Port port_id, Dart_CObject* message);
 
+/**
+ * Posts a batch of messages on some port, in order. Each message will contain
+ * the Dart_CObject object graph rooted in the corresponding element of
+ * 'messages'.
+ *
+ * This behaves like calling Dart_PostCObject for every message, but the port
+ * is looked up, and the receiver is woken up, only once for the whole batch.
+ * Producers of many small messages, such as chunks of Dart_CObject of type
+ * Dart_CObject_kExternalTypedData, should prefer this over repeated calls to
+ * Dart_PostCObject.
+ *
+ * The batch is posted atomically: if any message cannot be serialized or the
+ * port is closed, no message is enqueued, false is returned and ownership of
+ * external typed data in all the messages remains with the caller.
+ *
+ * This function may be called on any thread when the VM is running (that is,
+ * after Dart_Initialize has returned and before Dart_Cleanup has been called).
+ *
+ * \param port_id The destination port.
+ * \param num_messages The number of messages in 'messages'.
+ * \param messages The messages to send.
+ *
+ * \return True if the messages were posted.
+ */
+DART_EXPORT bool Dart_PostCObjects(Dart_Port port_id,
+                                   intptr_t num_messages,
+                                   Dart_CObject** messages);
+
 /**
  * Posts a message on some port. The message will contain the integer 'message'.
  *
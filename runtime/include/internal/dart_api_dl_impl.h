@@ -12,6 +12,7 @@
   /***** dart_native_api.h *****/                                              \
   /* Dart_Port */                                                              \
   F(Dart_PostCObject)                                                          \
+  F(Dart_PostCObjects)                                                         \
   F(Dart_PostInteger)                                                          \
   F(Dart_NewNativePort)                                                        \
   F(Dart_CloseNativePort)
@@ -0,0 +1,579 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/bootstrap_natives.h"
+
+#include "platform/unaligned.h"
+#include "platform/unicode.h"
+#include "vm/dart_entry.h"
+#include "vm/double_conversion.h"
+#include "vm/exceptions.h"
+#include "vm/native_entry.h"
+#include "vm/object.h"
+#include "vm/symbols.h"
+
+namespace dart {
+
+// Decodes a complete JSON text into the objects _BuildJsonListener in
+// convert_patch.dart would build, allocating them directly in the heap.
+//
+// The decoder accepts exactly the grammar accepted by _ChunkedJsonParser, but
+// instead of reporting errors it gives up, as it does on the rare escaped
+// unpaired surrogate in UTF-8 input. The caller then falls back to the Dart
+// parser, which reports any errors.
+//
+// Maps are created with just their data array filled in. Like deserialized
+// maps, their index is regenerated by _rehashObjects once decoding succeeded.
+template <typename CharType>
+class JsonDecoder : public ValueObject {
+ public:
+  JsonDecoder(Zone* zone,
+              const CharType* chars,
+              intptr_t length,
+              const TypeArguments& map_type_arguments)
+      : zone_(zone),
+        chars_(chars),
+        length_(length),
+        map_type_arguments_(map_type_arguments),
+        containers_(
+            GrowableObjectArray::Handle(zone, GrowableObjectArray::New())),
+        maps_(GrowableObjectArray::Handle(zone, GrowableObjectArray::New())),
+        container_(GrowableObjectArray::Handle(zone)),
+        value_(Object::Handle(zone)),
+        data_(Array::Handle(zone)),
+        map_(LinkedHashMap::Handle(zone)),
+        null_index_(TypedData::Handle(zone)),
+        is_map_(zone, 16),
+        utf8_buffer_(zone, 0),
+        utf16_buffer_(zone, 0) {}
+
+  // Returns false if the input could not be decoded. Otherwise [result] holds
+  // the decoded value and [maps] all maps whose index must be regenerated.
+  bool Decode(Object* result, GrowableObjectArray* maps);
+
+ private:
+  static const intptr_t kWordSize = sizeof(uintptr_t);
+
+  static bool IsWhitespace(int32_t c) {
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+  }
+
+  static bool IsDigit(int32_t c) { return (c >= '0') && (c <= '9'); }
+
+  // Returns true if none of the bytes in [word] ends or escapes a JSON string
+  // or is a control or non-ASCII character.
+  static bool IsPlainAsciiWord(uintptr_t word) {
+    const uintptr_t kOnes = ~static_cast<uintptr_t>(0) / 0xFF;
+    const uintptr_t kHighBits = kOnes * 0x80;
+    const uintptr_t quotes = word ^ (kOnes * '"');
+    const uintptr_t backslashes = word ^ (kOnes * '\\');
+    const uintptr_t special = ((quotes - kOnes) & ~quotes) |
+                              ((backslashes - kOnes) & ~backslashes) |
+                              ((word - kOnes * 0x20) & ~word) | word;
+    return (special & kHighBits) == 0;
+  }
+
+  void SkipWhitespace() {
+    while ((position_ < length_) && IsWhitespace(chars_[position_])) {
+      position_++;
+    }
+  }
+
+  // Consumes [c] if it is the next character.
+  bool Match(char c) {
+    if ((position_ < length_) && (chars_[position_] == c)) {
+      position_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool MatchKeyword(const char* keyword) {
+    for (const char* p = keyword; *p != '\0'; p++) {
+      if (!Match(*p)) return false;
+    }
+    return true;
+  }
+
+  bool ParseValue();
+  bool ParseKey();
+  bool ParseString();
+  bool ParseEscapedString(intptr_t start);
+  bool ParseEscape(int32_t* code_unit);
+  bool ParseNumber();
+  bool MakeString(intptr_t start, intptr_t end, bool is_ascii);
+  void AddCodeUnit(int32_t code_unit);
+  void EndMap();
+
+  Zone* zone_;
+  const CharType* chars_;
+  const intptr_t length_;
+  intptr_t position_ = 0;
+  const TypeArguments& map_type_arguments_;
+
+  // Stack of the lists and maps being built. Maps are collected as
+  // alternating keys and values in a growable array.
+  const GrowableObjectArray& containers_;
+  const GrowableObjectArray& maps_;
+  GrowableObjectArray& container_;
+  Object& value_;
+  Array& data_;
+  LinkedHashMap& map_;
+  const TypedData& null_index_;
+  GrowableArray<bool> is_map_;
+
+  GrowableArray<uint8_t> utf8_buffer_;
+  GrowableArray<uint16_t> utf16_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonDecoder);
+};
+
+template <typename CharType>
+bool JsonDecoder<CharType>::Decode(Object* result, GrowableObjectArray* maps) {
+  SkipWhitespace();
+  while (true) {
+    // Parse a value or open a container.
+    if (Match('{')) {
+      SkipWhitespace();
+      container_ = GrowableObjectArray::New();
+      if (!Match('}')) {
+        containers_.Add(container_);
+        is_map_.Add(true);
+        if (!ParseKey()) return false;
+        continue;
+      }
+      containers_.Add(container_);
+      EndMap();
+    } else if (Match('[')) {
+      SkipWhitespace();
+      container_ = GrowableObjectArray::New();
+      if (!Match(']')) {
+        containers_.Add(container_);
+        is_map_.Add(false);
+        continue;
+      }
+      value_ = container_.raw();
+    } else if (!ParseValue()) {
+      return false;
+    }
+
+    // Add the value to the enclosing containers, closing them as necessary.
+    while (true) {
+      SkipWhitespace();
+      if (is_map_.is_empty()) {
+        if (position_ != length_) return false;
+        *result = value_.raw();
+        *maps = maps_.raw();
+        return true;
+      }
+      container_ ^= containers_.At(containers_.Length() - 1);
+      container_.Add(value_);
+      if (is_map_.Last()) {
+        if (Match(',')) {
+          SkipWhitespace();
+          if (!ParseKey()) return false;
+          break;
+        }
+        if (!Match('}')) return false;
+        is_map_.RemoveLast();
+        EndMap();
+      } else {
+        if (Match(',')) {
+          SkipWhitespace();
+          break;
+        }
+        if (!Match(']')) return false;
+        is_map_.RemoveLast();
+        value_ = containers_.RemoveLast();
+      }
+    }
+  }
+}
+
+// Parses '"key" :' and adds the key to the innermost map.
+template <typename CharType>
+bool JsonDecoder<CharType>::ParseKey() {
+  if (!Match('"') || !ParseString()) return false;
+  container_ ^= containers_.At(containers_.Length() - 1);
+  container_.Add(value_);
+  SkipWhitespace();
+  if (!Match(':')) return false;
+  SkipWhitespace();
+  return true;
+}
+
+// Replaces the innermost collected keys and values with a map.
+template <typename CharType>
+void JsonDecoder<CharType>::EndMap() {
+  container_ ^= containers_.RemoveLast();
+  const intptr_t used_data = container_.Length();
+  const intptr_t data_size =
+      Utils::Maximum(Utils::RoundUpToPowerOfTwo(used_data),
+                     static_cast<uintptr_t>(LinkedHashMap::kInitialIndexSize));
+  data_ = Array::New(data_size);
+  for (intptr_t i = 0; i < used_data; i++) {
+    value_ = container_.At(i);
+    data_.SetAt(i, value_);
+  }
+  // The index is regenerated afterwards, see _HashBase._regenerateIndex.
+  map_ = LinkedHashMap::New(data_, null_index_, /*hash_mask=*/0, used_data,
+                            /*deleted_keys=*/0);
+  map_.SetTypeArguments(map_type_arguments_);
+  maps_.Add(map_);
+  value_ = map_.raw();
+}
+
+// Parses a string, number, boolean or null into [value_].
+template <typename CharType>
+bool JsonDecoder<CharType>::ParseValue() {
+  if (position_ == length_) return false;
+  switch (chars_[position_]) {
+    case '"':
+      position_++;
+      return ParseString();
+    case 't':
+      value_ = Bool::True().raw();
+      return MatchKeyword("true");
+    case 'f':
+      value_ = Bool::False().raw();
+      return MatchKeyword("false");
+    case 'n':
+      value_ = Object::null();
+      return MatchKeyword("null");
+    default:
+      return ParseNumber();
+  }
+}
+
+// Parses the rest of a string after the opening quote into [value_].
+template <typename CharType>
+bool JsonDecoder<CharType>::ParseString() {
+  const intptr_t start = position_;
+  bool is_ascii = true;
+  while (true) {
+    if (sizeof(CharType) == 1) {
+      // Skip plain ASCII characters a word at a time.
+      while ((position_ + kWordSize <= length_) &&
+             IsPlainAsciiWord(LoadUnaligned(
+                 reinterpret_cast<const uintptr_t*>(chars_ + position_)))) {
+        position_ += kWordSize;
+      }
+    }
+    if (position_ == length_) return false;
+    const int32_t c = chars_[position_];
+    if (c == '"') break;
+    if (c == '\\') return ParseEscapedString(start);
+    if (c < 0x20) return false;
+    if (c >= 0x80) is_ascii = false;
+    position_++;
+  }
+  const intptr_t end = position_++;
+  return MakeString(start, end, is_ascii);
+}
+
+template <typename CharType>
+bool JsonDecoder<CharType>::ParseEscapedString(intptr_t start) {
+  utf8_buffer_.Clear();
+  utf16_buffer_.Clear();
+  position_ = start;
+  while (true) {
+    if (position_ == length_) return false;
+    int32_t c = chars_[position_++];
+    if (c == '"') break;
+    if (c < 0x20) return false;
+    if ((c == '\\') && !ParseEscape(&c)) return false;
+    AddCodeUnit(c);
+  }
+  if (sizeof(CharType) == 1) {
+    if (!Utf8::IsValid(utf8_buffer_.data(), utf8_buffer_.length())) {
+      return false;
+    }
+    value_ = String::FromUTF8(utf8_buffer_.data(), utf8_buffer_.length());
+  } else {
+    value_ = String::FromUTF16(utf16_buffer_.data(), utf16_buffer_.length());
+  }
+  return true;
+}
+
+// Decodes the escape sequence after a backslash. In UTF-8 input, a pair of
+// escaped surrogates is combined into a single code point.
+template <typename CharType>
+bool JsonDecoder<CharType>::ParseEscape(int32_t* code_unit) {
+  if (position_ == length_) return false;
+  switch (chars_[position_++]) {
+    case '"':
+      *code_unit = '"';
+      return true;
+    case '\\':
+      *code_unit = '\\';
+      return true;
+    case '/':
+      *code_unit = '/';
+      return true;
+    case 'b':
+      *code_unit = '\b';
+      return true;
+    case 'f':
+      *code_unit = '\f';
+      return true;
+    case 'n':
+      *code_unit = '\n';
+      return true;
+    case 'r':
+      *code_unit = '\r';
+      return true;
+    case 't':
+      *code_unit = '\t';
+      return true;
+    case 'u':
+      break;
+    default:
+      return false;
+  }
+  if (position_ + 4 > length_) return false;
+  int32_t value = 0;
+  for (intptr_t i = 0; i < 4; i++) {
+    const int32_t c = chars_[position_++];
+    int32_t digit;
+    if (IsDigit(c)) {
+      digit = c - '0';
+    } else if (((c | 0x20) >= 'a') && ((c | 0x20) <= 'f')) {
+      digit = (c | 0x20) - 'a' + 10;
+    } else {
+      return false;
+    }
+    value = (value << 4) | digit;
+  }
+  if ((sizeof(CharType) == 1) && Utf16::IsSurrogate(value)) {
+    // UTF-8 cannot represent unpaired surrogates.
+    int32_t trail;
+    if (!Utf16::IsLeadSurrogate(value) || !Match('\\') ||
+        (position_ == length_) || (chars_[position_] != 'u') ||
+        !ParseEscape(&trail) || !Utf16::IsTrailSurrogate(trail)) {
+      return false;
+    }
+    value = Utf16::Decode(value, trail);
+  }
+  *code_unit = value;
+  return true;
+}
+
+template <typename CharType>
+void JsonDecoder<CharType>::AddCodeUnit(int32_t code_unit) {
+  if (sizeof(CharType) == 2) {
+    utf16_buffer_.Add(code_unit);
+  } else if (code_unit < 0x80) {
+    utf8_buffer_.Add(code_unit);
+  } else {
+    char encoded[4];
+    const intptr_t length = Utf8::Encode(code_unit, encoded);
+    for (intptr_t i = 0; i < length; i++) {
+      utf8_buffer_.Add(encoded[i]);
+    }
+  }
+}
+
+template <typename CharType>
+bool JsonDecoder<CharType>::MakeString(intptr_t start,
+                                       intptr_t end,
+                                       bool is_ascii) {
+  const intptr_t length = end - start;
+  if (sizeof(CharType) == 2) {
+    const uint16_t* utf16 = reinterpret_cast<const uint16_t*>(chars_ + start);
+    value_ = String::FromUTF16(utf16, length);
+    return true;
+  }
+  const uint8_t* utf8 = reinterpret_cast<const uint8_t*>(chars_ + start);
+  if (is_ascii) {
+    value_ = OneByteString::New(utf8, length, Heap::kNew);
+  } else {
+    if (!Utf8::IsValid(utf8, length)) return false;
+    value_ = String::FromUTF8(utf8, length);
+  }
+  return true;
+}
+
+// Parses a number into [value_], using the same representation as
+// _ChunkedJsonParser.parseNumber: integer literals which fit into 64 bits
+// become ints, everything else becomes a double.
+template <typename CharType>
+bool JsonDecoder<CharType>::ParseNumber() {
+  // Format:
+  //  '-'?('0'|[1-9][0-9]*)('.'[0-9]+)?([eE][+-]?[0-9]+)?
+  const intptr_t start = position_;
+  const bool is_negative = Match('-');
+  if ((position_ == length_) || !IsDigit(chars_[position_])) return false;
+
+  // Accumulate the integer value negatively to be able to represent -2^63.
+  int64_t int_value = 0;
+  bool is_double = false;
+  bool is_zero = true;
+  if (Match('0')) {
+    if ((position_ < length_) && IsDigit(chars_[position_])) return false;
+  } else {
+    while ((position_ < length_) && IsDigit(chars_[position_])) {
+      const int64_t digit = chars_[position_++] - '0';
+      is_zero = false;
+      if (int_value < (kMinInt64 + digit) / 10) {
+        is_double = true;  // Overflow.
+      } else {
+        int_value = 10 * int_value - digit;
+      }
+    }
+  }
+  if (Match('.')) {
+    is_double = true;
+    if ((position_ == length_) || !IsDigit(chars_[position_])) return false;
+    while ((position_ < length_) && IsDigit(chars_[position_])) {
+      is_zero = is_zero && (chars_[position_] == '0');
+      position_++;
+    }
+  }
+  bool exponent_overflow = false;
+  bool is_negative_exponent = false;
+  if ((position_ < length_) && ((chars_[position_] | 0x20) == 'e')) {
+    is_double = true;
+    position_++;
+    is_negative_exponent = Match('-');
+    if (!is_negative_exponent) Match('+');
+    if ((position_ == length_) || !IsDigit(chars_[position_])) return false;
+    intptr_t exponent = 0;
+    while ((position_ < length_) && IsDigit(chars_[position_])) {
+      exponent = 10 * exponent + (chars_[position_++] - '0');
+      if (exponent > 400) {
+        exponent_overflow = true;
+        exponent = 400;
+      }
+    }
+  }
+
+  if (!is_double) {
+    if (!is_negative) {
+      if (int_value == kMinInt64) {
+        is_double = true;  // 2^63 does not fit.
+      } else {
+        int_value = -int_value;
+      }
+    }
+    if (!is_double) {
+      value_ = Integer::New(int_value);
+      return true;
+    }
+  }
+
+  double double_value;
+  if (exponent_overflow) {
+    // The Dart parser doesn't look at the mantissa in this case.
+    if (is_zero || is_negative_exponent) {
+      double_value = is_negative ? -0.0 : 0.0;
+    } else {
+      double_value = is_negative ? kNegInfinity : kPosInfinity;
+    }
+  } else {
+    const intptr_t length = position_ - start;
+    char* buffer = zone_->Alloc<char>(length + 1);
+    for (intptr_t i = 0; i < length; i++) {
+      buffer[i] = static_cast<char>(chars_[start + i]);
+    }
+    buffer[length] = '\0';
+    if (!CStringToDouble(buffer, length, &double_value)) return false;
+  }
+  value_ = Double::New(double_value);
+  return true;
+}
+
+// Regenerates the index of the maps created by [JsonDecoder].
+static void RehashMaps(Zone* zone, const GrowableObjectArray& maps) {
+  if (maps.Length() == 0) return;
+  const Library& collections_lib =
+      Library::Handle(zone, Library::CollectionLibrary());
+  const Function& rehashing_function = Function::Handle(
+      zone,
+      collections_lib.LookupFunctionAllowPrivate(Symbols::_rehashObjects()));
+  ASSERT(!rehashing_function.IsNull());
+  const Array& arguments = Array::Handle(zone, Array::New(1));
+  arguments.SetAt(0, maps);
+  const Object& result =
+      Object::Handle(zone, DartEntry::InvokeFunction(rehashing_function,
+                                                     arguments));
+  if (result.IsError()) {
+    Exceptions::PropagateError(Error::Cast(result));
+  }
+}
+
+template <typename CharType>
+static bool DecodeJson(Zone* zone,
+                       const CharType* chars,
+                       intptr_t length,
+                       const TypeArguments& map_type_arguments,
+                       Object* result) {
+  GrowableObjectArray& maps = GrowableObjectArray::Handle(zone);
+  JsonDecoder<CharType> decoder(zone, chars, length, map_type_arguments);
+  if (!decoder.Decode(result, &maps)) return false;
+  RehashMaps(zone, maps);
+  return true;
+}
+
+// Returns [not_decoded] if the input was left to the Dart parser.
+DEFINE_NATIVE_ENTRY(JsonDecoder_decodeNative, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, input, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, map_prototype,
+                               arguments->NativeArgAt(1));
+  const Instance& not_decoded =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(2));
+  const TypeArguments& map_type_arguments =
+      TypeArguments::Handle(zone, map_prototype.GetTypeArguments());
+
+  // The input is copied out of the heap, as decoding allocates.
+  Object& result = Object::Handle(zone);
+  if (input.IsString()) {
+    const String& str = String::Cast(input);
+    if (str.IsOneByteString() || str.IsExternalOneByteString()) {
+      // Latin-1 characters decode to the same strings from UTF-8.
+      const intptr_t length = Utf8::Length(str);
+      uint8_t* chars = zone->Alloc<uint8_t>(length);
+      str.ToUTF8(chars, length);
+      if (DecodeJson(zone, chars, length, map_type_arguments, &result)) {
+        return result.raw();
+      }
+    } else {
+      const intptr_t length = str.Length();
+      uint16_t* chars = zone->Alloc<uint16_t>(length);
+      for (intptr_t i = 0; i < length; i++) {
+        chars[i] = str.CharAt(i);
+      }
+      if (DecodeJson(zone, chars, length, map_type_arguments, &result)) {
+        return result.raw();
+      }
+    }
+    return not_decoded.raw();
+  }
+
+  // A Uint8List of UTF-8 encoded bytes.
+  uint8_t* chars = nullptr;
+  intptr_t length = 0;
+  if (input.IsTypedData() || input.IsExternalTypedData() ||
+      input.IsTypedDataView()) {
+    const TypedDataBase& bytes = TypedDataBase::Cast(input);
+    ASSERT(bytes.ElementSizeInBytes() == 1);
+    length = bytes.LengthInBytes();
+    chars = zone->Alloc<uint8_t>(length);
+    NoSafepointScope no_safepoint;
+    memmove(chars, bytes.DataAddr(0), length);
+  } else {
+    return not_decoded.raw();
+  }
+  // Skip a leading byte order mark, like _JsonUtf8Parser.
+  if ((length >= 3) && (chars[0] == 0xEF) && (chars[1] == 0xBB) &&
+      (chars[2] == 0xBF)) {
+    chars += 3;
+    length -= 3;
+  }
+  if (DecodeJson(zone, chars, length, map_type_arguments, &result)) {
+    return result.raw();
+  }
+  return not_decoded.raw();
+}
+
+}  // namespace dart
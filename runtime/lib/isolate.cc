@@ -19,6 +19,7 @@
 #include "vm/lockers.h"
 #include "vm/longjump.h"
 #include "vm/message_handler.h"
+#include "vm/message_snapshot.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/port.h"
@@ -101,10 +102,10 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
     PortMap::PostMessage(
         Message::New(destination_port_id, obj.raw(), Message::kNormalPriority));
   } else {
-    MessageWriter writer(can_send_any_object);
     // TODO(turnidge): Throw an exception when the return value is false?
-    PortMap::PostMessage(writer.WriteMessage(obj, destination_port_id,
-                                             Message::kNormalPriority));
+    PortMap::PostMessage(WriteMessage(can_send_any_object, obj,
+                                      destination_port_id,
+                                      Message::kNormalPriority));
   }
   return Object::null();
 }
@@ -119,6 +120,14 @@ class ObjectPtrSetTraitsLayout {
   static uword Hash(const ObjectPtr obj) { return static_cast<uword>(obj); }
 };
 
+// Objects of these classes are allowed in messages and only refer to objects
+// that are, so they do not need to be validated or tracked.
+static bool IsValidMessageLeaf(ObjectPtr raw) {
+  const intptr_t cid = raw->GetClassId();
+  return IsStringClassId(cid) || IsTypedDataBaseClassId(cid) ||
+         cid == kMintCid || cid == kDoubleCid;
+}
+
 static ObjectPtr ValidateMessageObject(Zone* zone,
                                        Isolate* isolate,
                                        const Object& obj) {
@@ -136,7 +145,8 @@ static ObjectPtr ValidateMessageObject(Zone* zone,
    private:
     void VisitPointers(ObjectPtr* from, ObjectPtr* to) {
       for (ObjectPtr* raw = from; raw <= to; raw++) {
-        if (!(*raw)->IsHeapObject() || (*raw)->ptr()->IsCanonical()) {
+        if (!(*raw)->IsHeapObject() || (*raw)->ptr()->IsCanonical() ||
+            IsValidMessageLeaf(*raw)) {
           continue;
         }
         if (visited_->GetValueExclusive(*raw) == 1) {
@@ -150,7 +160,8 @@ static ObjectPtr ValidateMessageObject(Zone* zone,
     WeakTable* visited_;
     MallocGrowableArray<ObjectPtr>* const working_set_;
   };
-  if (!obj.raw()->IsHeapObject() || obj.raw()->ptr()->IsCanonical()) {
+  if (!obj.raw()->IsHeapObject() || obj.raw()->ptr()->IsCanonical() ||
+      IsValidMessageLeaf(obj.raw())) {
     return obj.raw();
   }
   ClassTable* class_table = isolate->class_table();
@@ -161,61 +172,66 @@ static ObjectPtr ValidateMessageObject(Zone* zone,
   MallocGrowableArray<ObjectPtr> working_set;
   std::unique_ptr<WeakTable> visited(new WeakTable());
 
-  NoSafepointScope no_safepoint;
-  SendMessageValidator visitor(isolate->group(), visited.get(), &working_set);
-
-  visited->SetValueExclusive(obj.raw(), 1);
-  working_set.Add(obj.raw());
+  // The exception for an illegal object can only be allocated once we are
+  // done walking the object graph.
+  const char* error = nullptr;
+  {
+    NoSafepointScope no_safepoint;
+    SendMessageValidator visitor(isolate->group(), visited.get(),
+                                 &working_set);
 
-  while (!working_set.is_empty()) {
-    ObjectPtr raw = working_set.RemoveLast();
+    visited->SetValueExclusive(obj.raw(), 1);
+    working_set.Add(obj.raw());
 
-    if (visited->GetValueExclusive(raw) > 0) {
-      continue;
-    }
-    visited->SetValueExclusive(raw, 1);
+    // Objects are marked as visited when they are added to the working set.
+    while (error == nullptr && !working_set.is_empty()) {
+      ObjectPtr raw = working_set.RemoveLast();
 
-    const intptr_t cid = raw->GetClassId();
-    switch (cid) {
-      // List below matches the one in raw_object_snapshot.cc
+      const intptr_t cid = raw->GetClassId();
+      switch (cid) {
+        // List below matches the one in raw_object_snapshot.cc
 #define MESSAGE_SNAPSHOT_ILLEGAL(type)                                         \
   case k##type##Cid:                                                           \
-    return Exceptions::CreateUnhandledException(                               \
-        zone, Exceptions::kArgumentValue,                                      \
-        "Illegal argument in isolate message : (object is a " #type ")");
-
-      MESSAGE_SNAPSHOT_ILLEGAL(DynamicLibrary);
-      MESSAGE_SNAPSHOT_ILLEGAL(MirrorReference);
-      MESSAGE_SNAPSHOT_ILLEGAL(Pointer);
-      MESSAGE_SNAPSHOT_ILLEGAL(ReceivePort);
-      MESSAGE_SNAPSHOT_ILLEGAL(RegExp);
-      MESSAGE_SNAPSHOT_ILLEGAL(StackTrace);
-      MESSAGE_SNAPSHOT_ILLEGAL(UserTag);
-
-      case kClosureCid: {
-        closure = Closure::RawCast(raw);
-        FunctionPtr func = closure.function();
-        // We only allow closure of top level methods or static functions in a
-        // class to be sent in isolate messages.
-        if (!Function::IsImplicitStaticClosureFunction(func)) {
-          return Exceptions::CreateUnhandledException(
-              zone, Exceptions::kArgumentValue, "Closures are not allowed");
-        }
-        break;
-      }
-      default:
-        if (cid >= kNumPredefinedCids) {
-          klass = class_table->At(cid);
-          if (klass.num_native_fields() != 0) {
-            return Exceptions::CreateUnhandledException(
-                zone, Exceptions::kArgumentValue,
-                "Objects that extend NativeWrapper are not allowed");
+    error = "Illegal argument in isolate message : (object is a " #type ")";   \
+    continue;
+
+        MESSAGE_SNAPSHOT_ILLEGAL(DynamicLibrary);
+        MESSAGE_SNAPSHOT_ILLEGAL(MirrorReference);
+        MESSAGE_SNAPSHOT_ILLEGAL(Pointer);
+        MESSAGE_SNAPSHOT_ILLEGAL(ReceivePort);
+        MESSAGE_SNAPSHOT_ILLEGAL(RegExp);
+        MESSAGE_SNAPSHOT_ILLEGAL(StackTrace);
+        MESSAGE_SNAPSHOT_ILLEGAL(UserTag);
+#undef MESSAGE_SNAPSHOT_ILLEGAL
+
+        case kClosureCid: {
+          closure = Closure::RawCast(raw);
+          FunctionPtr func = closure.function();
+          // We only allow closure of top level methods or static functions in
+          // a class to be sent in isolate messages.
+          if (!Function::IsImplicitStaticClosureFunction(func)) {
+            error = "Closures are not allowed";
+            continue;
           }
+          break;
         }
+        default:
+          if (cid >= kNumPredefinedCids) {
+            klass = class_table->At(cid);
+            if (klass.num_native_fields() != 0) {
+              error = "Objects that extend NativeWrapper are not allowed";
+              continue;
+            }
+          }
+      }
+      raw->ptr()->VisitPointers(&visitor);
     }
-    raw->ptr()->VisitPointers(&visitor);
   }
   isolate->set_forward_table_new(nullptr);
+  if (error != nullptr) {
+    return Exceptions::CreateUnhandledException(
+        zone, Exceptions::kArgumentValue, error);
+  }
   return obj.raw();
 }
 
@@ -8,7 +8,9 @@
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/regexp_assembler_bytecode.h"
+#include "vm/regexp_dfa.h"
 #include "vm/regexp_parser.h"
+#include "vm/regexp_prefilter.h"
 #include "vm/thread.h"
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -17,6 +19,9 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, regexp_dfa);
+DECLARE_FLAG(bool, regexp_prefilter);
+
 DEFINE_NATIVE_ENTRY(RegExp_factory, 0, 6) {
   ASSERT(
       TypeArguments::CheckedHandle(zone, arguments->NativeArgAt(0)).IsNull());
@@ -121,13 +126,45 @@ static ObjectPtr ExecuteMatch(Zone* zone,
   GET_NON_NULL_NATIVE_ARGUMENT(String, subject, arguments->NativeArgAt(1));
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_index, arguments->NativeArgAt(2));
 
+  intptr_t start = start_index.Value();
+  if (FLAG_regexp_prefilter &&
+      !RegExpPrefilter::Apply(zone, regexp, subject, sticky, &start)) {
+    return Object::null();
+  }
+  if (FLAG_regexp_dfa) {
+    // Find the match in linear time. The backtracking matcher is only needed
+    // for captures, or to find where the match ends, and starts at the match.
+    // Note that in JIT mode this is only reached when RegExp_ExecuteMatch is
+    // not intrinsified, i.e. with --interpret_irregexp.
+    RegExpDFA* dfa = RegExpDFA::For(zone, regexp);
+    if (dfa != nullptr) {
+      intptr_t match_start;
+      intptr_t match_end;
+      if (dfa->Search(subject, start, sticky, &match_start, &match_end) ==
+          RegExpDFA::kNoMatch) {
+        return Object::null();
+      }
+      if (dfa->has_exact_end() && !dfa->has_captures()) {
+        const TypedData& result = TypedData::Handle(
+            zone, TypedData::New(kTypedDataInt32ArrayCid, 2));
+        result.SetInt32(0, match_start);
+        result.SetInt32(sizeof(int32_t), match_end);
+        return result.raw();
+      }
+      start = match_start;
+    }
+  }
+  const Smi& start_smi =
+      (start == start_index.Value()) ? start_index
+                                     : Smi::Handle(zone, Smi::New(start));
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (!FLAG_interpret_irregexp) {
-    return IRRegExpMacroAssembler::Execute(regexp, subject, start_index,
+    return IRRegExpMacroAssembler::Execute(regexp, subject, start_smi,
                                            /*sticky=*/sticky, zone);
   }
 #endif
-  return BytecodeRegExpMacroAssembler::Interpret(regexp, subject, start_index,
+  return BytecodeRegExpMacroAssembler::Interpret(regexp, subject, start_smi,
                                                  /*sticky=*/sticky, zone);
 }
 
@@ -100,6 +100,15 @@ DEFINE_NATIVE_ENTRY(StringBase_substringUnchecked, 0, 3) {
   return String::SubString(receiver, start, (end - start));
 }
 
+DEFINE_NATIVE_ENTRY(StringBase_indexOfUnchecked, 0, 3) {
+  const String& receiver =
+      String::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(String, pattern, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_obj, arguments->NativeArgAt(2));
+
+  return Smi::New(receiver.IndexOf(pattern, start_obj.Value()));
+}
+
 // Return the bitwise-or of all characters in the slice from start to end.
 static uint16_t CharacterLimit(const String& string,
                                intptr_t start,
@@ -501,6 +510,26 @@ DEFINE_NATIVE_ENTRY(TwoByteString_allocateFromTwoByteList, 0, 3) {
   return Object::null();
 }
 
+DEFINE_NATIVE_ENTRY(Utf8Encoder_convertIntercepted, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(String, receiver, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_obj, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, end_obj, arguments->NativeArgAt(2));
+  // The range has already been checked by Utf8Encoder.convert.
+  const intptr_t start = start_obj.Value();
+  const intptr_t end = end_obj.Value();
+  ASSERT((0 <= start) && (start <= end) && (end <= receiver.Length()));
+
+  const intptr_t length = Utf8::Length(receiver, start, end);
+  const TypedData& result = TypedData::Handle(
+      zone, TypedData::New(kTypedDataUint8ArrayCid, length));
+  {
+    NoSafepointScope no_safepoint;
+    Utf8::Encode(receiver, start, end,
+                 reinterpret_cast<char*>(result.DataAddr(0)), length);
+  }
+  return result.raw();
+}
+
 DEFINE_NATIVE_ENTRY(String_getHashCode, 0, 1) {
   const String& receiver =
       String::CheckedHandle(zone, arguments->NativeArgAt(0));
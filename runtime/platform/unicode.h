@@ -58,9 +58,17 @@ class Utf8 : AllStatic {
 
   static intptr_t Length(int32_t ch);
   static intptr_t Length(const String& str);
+  // Length of the UTF-8 encoding of the code units [start, end) of 'str'.
+  static intptr_t Length(const String& str, intptr_t start, intptr_t end);
 
   static intptr_t Encode(int32_t ch, char* dst);
   static intptr_t Encode(const String& src, char* dst, intptr_t len);
+  // Encodes the code units [start, end) of 'src'.
+  static intptr_t Encode(const String& src,
+                         intptr_t start,
+                         intptr_t end,
+                         char* dst,
+                         intptr_t len);
 
   static intptr_t Decode(const uint8_t* utf8_array,
                          intptr_t array_len,
@@ -0,0 +1,91 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// In AOT snapshots canonical doubles and mints which are not Smis are used in
+// place from the read-only data section of the image. Verifies that constants
+// of both kinds keep their values and identities after loading.
+
+import 'dart:collection';
+
+import 'package:expect/expect.dart';
+
+const int maxInt = 0x7FFFFFFFFFFFFFFF;
+const int minInt = -0x8000000000000000;
+const int beyondSmi = 0x4000000000000001;
+// A Smi on 64-bit targets, but a mint on 32-bit targets.
+const int beyondSmi32 = 0x123456789A;
+
+const double pi = 3.141592653589793;
+const double negativeZero = -0.0;
+const double huge = 1e300;
+const double tiny = 5e-324;
+
+const List<Object> constants = <Object>[
+  maxInt,
+  minInt,
+  beyondSmi,
+  beyondSmi32,
+  pi,
+  negativeZero,
+  huge,
+  tiny,
+  double.infinity,
+  double.nan,
+];
+
+const Map<int, String> names = <int, String>{
+  maxInt: 'maxInt',
+  minInt: 'minInt',
+  beyondSmi: 'beyondSmi',
+  beyondSmi32: 'beyondSmi32',
+};
+
+class Holder {
+  final int i;
+  final double d;
+  const Holder(this.i, this.d);
+}
+
+const Holder holder = Holder(beyondSmi, pi);
+
+@pragma('vm:never-inline')
+List<Object> constantsFromOtherFunction() =>
+    <Object>[maxInt, minInt, beyondSmi, holder.i, pi, holder.d, double.nan];
+
+main() {
+  // Values computed at runtime, which are not canonical.
+  Expect.equals(int.parse('9223372036854775807'), maxInt);
+  Expect.equals(int.parse('-9223372036854775808'), minInt);
+  Expect.equals((1 << 62) + 1, beyondSmi);
+  Expect.equals(int.parse('78187493530'), beyondSmi32);
+  Expect.equals(double.parse('3.141592653589793'), pi);
+  Expect.isTrue(negativeZero == 0.0 && negativeZero.isNegative);
+  Expect.equals(double.parse('1e300'), huge);
+  Expect.equals(double.parse('5e-324'), tiny);
+  Expect.isTrue(constants[8] == double.infinity);
+  Expect.isTrue((constants[9] as double).isNaN);
+
+  Expect.equals('maxInt', names[int.parse('9223372036854775807')]);
+  Expect.equals('minInt', names[int.parse('-9223372036854775808')]);
+  Expect.equals('beyondSmi', names[(1 << 62) + 1]);
+  Expect.equals('beyondSmi32', names[int.parse('78187493530')]);
+
+  // Uses of the same constant refer to the same canonical object.
+  final List<Object> other = constantsFromOtherFunction();
+  Expect.isTrue(identical(other[0], constants[0]));
+  Expect.isTrue(identical(other[1], constants[1]));
+  Expect.isTrue(identical(other[2], constants[2]));
+  Expect.isTrue(identical(other[3], constants[2]));
+  Expect.isTrue(identical(other[4], constants[4]));
+  Expect.isTrue(identical(other[5], constants[4]));
+  Expect.isTrue(identical(other[6], constants[9]));
+  Expect.isTrue(identical(holder, const Holder(beyondSmi, pi)));
+  Expect.isFalse(identical(negativeZero, 0.0));
+
+  final Set<Object> identitySet = LinkedHashSet<Object>.identity()
+    ..addAll(constants);
+  for (final Object value in other) {
+    Expect.isTrue(identitySet.contains(value));
+  }
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--enable-isolate-groups
+
+// Verifies that isolates spawned after Dart_SaveIsolateGroupTemplate() start
+// with the deeply immutable static fields of the template already initialized,
+// while mutable ones are still initialized again in every isolate.
+
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:isolate';
+
+import 'package:expect/expect.dart';
+
+final saveIsolateGroupTemplate = DynamicLibrary.executable()
+    .lookupFunction<Handle Function(), Object Function()>(
+        'Dart_SaveIsolateGroupTemplate');
+
+final List<String> initialized = <String>[];
+
+T init<T>(String name, T value) {
+  initialized.add(name);
+  return value;
+}
+
+final String immutableValue = init('immutable', 'abc' * 3);
+final List<int> mutableValue = init('mutable', <int>[1, 2, 3]);
+
+void isolateEntry(SendPort sendPort) {
+  sendPort.send(<Object>[immutableValue, mutableValue.length, initialized]);
+}
+
+main() async {
+  Expect.equals('abcabcabc', immutableValue);
+  Expect.equals(3, mutableValue.length);
+  Expect.listEquals(<String>['immutable', 'mutable'], initialized);
+
+  saveIsolateGroupTemplate();
+
+  final port = ReceivePort();
+  final exitPort = ReceivePort();
+  await Isolate.spawn(isolateEntry, port.sendPort, onExit: exitPort.sendPort);
+
+  final messages = StreamIterator(port);
+  Expect.isTrue(await messages.moveNext());
+  final List reply = messages.current;
+  Expect.equals('abcabcabc', reply[0]);
+  Expect.equals(3, reply[1]);
+  Expect.listEquals(<String>['mutable'], reply[2]);
+  await messages.cancel();
+
+  final exit = StreamIterator(exitPort);
+  Expect.isTrue(await exit.moveNext());
+  await exit.cancel();
+
+  // The template does not affect the spawning isolate.
+  Expect.listEquals(<String>['immutable', 'mutable'], initialized);
+}
@@ -99,10 +99,57 @@ verifyExitMessageIsPostedLast() async {
   port.close();
 }
 
+sendAndExitReceivePortWorker(SendPort sendPort) {
+  final receivePort = ReceivePort();
+  try {
+    sendAndExit(sendPort, <Object>[1, 'two', <Object>[receivePort]]);
+  } catch (e) {
+    receivePort.close();
+    sendPort.send(e.toString());
+  }
+}
+
+verifyCantSendAndExitReceivePort() async {
+  final port = ReceivePort();
+  final inbox = StreamIterator<dynamic>(port);
+  await Isolate.spawn(sendAndExitReceivePortWorker, port.sendPort);
+  await inbox.moveNext();
+  Expect.equals(
+      "Invalid argument(s): Illegal argument in isolate message : "
+      "(object is a ReceivePort)",
+      inbox.current);
+  port.close();
+}
+
+sendAndExitListWorker(SendPort sendPort) {
+  final shared = <String, Object>{'shared': true};
+  sendAndExit(
+      sendPort,
+      List<Object>.generate(
+          100000, (i) => i.isEven ? 'item $i' : <Object>[i, 0.5, shared]));
+}
+
+verifyCanSendAndExitList() async {
+  final port = ReceivePort();
+  final inbox = StreamIterator<dynamic>(port);
+  await Isolate.spawn(sendAndExitListWorker, port.sendPort);
+  await inbox.moveNext();
+  final List<Object> result = inbox.current;
+  Expect.equals(100000, result.length);
+  Expect.equals('item 0', result[0]);
+  final first = result[1] as List<Object>;
+  final last = result[99999] as List<Object>;
+  Expect.equals(99999, last[0]);
+  Expect.identical(first[2], last[2]);
+  port.close();
+}
+
 main() async {
   await verifyCantSendAnonymousClosure();
   await verifyCantSendNative();
   await verifyCantSendRegexp();
   await verifyCanSendStaticMethod();
   await verifyExitMessageIsPostedLast();
+  await verifyCantSendAndExitReceivePort();
+  await verifyCanSendAndExitList();
 }
@@ -6,6 +6,7 @@
 
 #include "bin/builtin.h"
 #include "bin/file.h"
+#include "bin/gzip.h"
 #include "bin/isolate_data.h"
 #include "bin/process.h"
 #include "bin/reference_counting.h"
@@ -17,13 +18,17 @@
 
 #include "vm/clustered_snapshot.h"
 #include "vm/dart_api_impl.h"
+#include "vm/message_snapshot.h"
 #include "vm/stack_frame.h"
+#include "vm/symbols.h"
 #include "vm/timer.h"
 
 using dart::bin::File;
 
 namespace dart {
 
+DECLARE_FLAG(int, snapshot_fill_tasks);
+
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
 const char* Benchmark::executable_ = NULL;
@@ -206,6 +211,88 @@ BENCHMARK(CorelibIsolateStartup) {
   Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
 }
 
+//
+// Measure creation of core isolate from a snapshot whose clusters are filled
+// by a given number of tasks.
+//
+static void CorelibIsolateStartupWithFillTasks(Benchmark* benchmark,
+                                               Thread* thread,
+                                               intptr_t num_tasks) {
+  const int kNumIterations = 100;
+  const int saved_fill_tasks = FLAG_snapshot_fill_tasks;
+  FLAG_snapshot_fill_tasks = num_tasks;
+  Timer timer(true, "CorelibIsolateStartupWithFillTasks");
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  for (int i = 0; i < kNumIterations; i++) {
+    timer.Start();
+    TestCase::CreateTestIsolate();
+    timer.Stop();
+    Dart_ShutdownIsolate();
+  }
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+  FLAG_snapshot_fill_tasks = saved_fill_tasks;
+}
+
+BENCHMARK(CorelibIsolateStartup1FillTask) {
+  CorelibIsolateStartupWithFillTasks(benchmark, thread, 1);
+}
+
+BENCHMARK(CorelibIsolateStartup2FillTasks) {
+  CorelibIsolateStartupWithFillTasks(benchmark, thread, 2);
+}
+
+BENCHMARK(CorelibIsolateStartup4FillTasks) {
+  CorelibIsolateStartupWithFillTasks(benchmark, thread, 4);
+}
+
+BENCHMARK(CorelibIsolateStartup8FillTasks) {
+  CorelibIsolateStartupWithFillTasks(benchmark, thread, 8);
+}
+
+//
+// Measure creation of core isolate from a gzipped snapshot, including the
+// time taken to inflate it.
+//
+BENCHMARK(CompressedCorelibIsolateStartup) {
+  const int kNumIterations = 100;
+  const Snapshot* snapshot =
+      Snapshot::SetupFromBuffer(bin::core_isolate_snapshot_data);
+  uint8_t* compressed = nullptr;
+  intptr_t compressed_length = 0;
+  bin::Compress(bin::core_isolate_snapshot_data, snapshot->length(),
+                &compressed, &compressed_length);
+  Timer timer(true, "CompressedCorelibIsolateStartup");
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  for (int i = 0; i < kNumIterations; i++) {
+    uint8_t* data = nullptr;
+    intptr_t data_length = 0;
+    timer.Start();
+    EXPECT(
+        bin::Decompress(compressed, compressed_length, &data, &data_length));
+    TestCase::CreateTestIsolateFromSnapshot(data);
+    timer.Stop();
+    Dart_ShutdownIsolate();
+    free(data);
+  }
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+  free(compressed);
+}
+
+BENCHMARK_SIZE(CompressedCoreSnapshotSize) {
+  const Snapshot* snapshot =
+      Snapshot::SetupFromBuffer(bin::core_isolate_snapshot_data);
+  uint8_t* compressed = nullptr;
+  intptr_t compressed_length = 0;
+  bin::Compress(bin::core_isolate_snapshot_data, snapshot->length(),
+                &compressed, &compressed_length);
+  benchmark->set_score(compressed_length);
+  free(compressed);
+}
+
 //
 // Measure invocation of Dart API functions.
 //
@@ -734,6 +821,211 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+static const char* kListOfMapsScript =
+    "makeListOfMaps() {\n"
+    "  var list = <Map<String, Object>>[];\n"
+    "  for (int i = 0; i < 10000; ++i) {\n"
+    "    list.add({'id': i, 'name': 'item $i', 'price': i * 0.25,\n"
+    "              'tags': ['a', 'b', 'c']});\n"
+    "  }\n"
+    "  return list;\n"
+    "}";
+
+static void BenchmarkListOfMaps(Benchmark* benchmark,
+                                Thread* thread,
+                                bool clustered) {
+  Dart_Handle h_lib = TestCase::LoadTestScript(kListOfMapsScript, NULL);
+  EXPECT_VALID(h_lib);
+  Dart_Handle h_result =
+      Dart_Invoke(h_lib, NewString("makeListOfMaps"), 0, NULL);
+  EXPECT_VALID(h_result);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  Instance& list = Instance::Handle();
+  list ^= Api::UnwrapHandle(h_result);
+  const intptr_t kLoopCount = 20;
+  Timer timer(true, "List of Maps");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    StackZone zone(thread);
+    std::unique_ptr<Message> message;
+    if (clustered) {
+      message = WriteClusteredMessage(true, list, ILLEGAL_PORT,
+                                      Message::kNormalPriority);
+    } else {
+      MessageWriter writer(true);
+      message =
+          writer.WriteMessage(list, ILLEGAL_PORT, Message::kNormalPriority);
+    }
+    ASSERT(message != nullptr);
+
+    // Read object back from the snapshot.
+    ReadMessage(thread, message.get());
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+BENCHMARK(ListOfMapsMessage) {
+  BenchmarkListOfMaps(benchmark, thread, /* clustered = */ false);
+}
+
+BENCHMARK(ListOfMapsClusteredMessage) {
+  BenchmarkListOfMaps(benchmark, thread, /* clustered = */ true);
+}
+
+static const char* kNativePortScript =
+    "import 'dart:isolate';\n"
+    "import 'dart:typed_data';\n"
+    "var port;\n"
+    "int received = 0;\n"
+    "openPort(int expected) {\n"
+    "  int count = 0;\n"
+    "  port = new RawReceivePort();\n"
+    "  port.handler = (Uint8List chunk) {\n"
+    "    received += chunk.length;\n"
+    "    if (++count == expected) port.close();\n"
+    "  };\n"
+    "  return port.sendPort;\n"
+    "}\n"
+    "bytesReceived() => received;\n";
+
+// Measures native-to-Dart throughput of external typed data chunks, posted
+// either one by one or in batches of 'batch_size'.
+static void BenchmarkNativePortThroughput(Benchmark* benchmark,
+                                          intptr_t batch_size) {
+  const intptr_t kNumMessages = 64 * 1024;
+  const intptr_t kChunkSize = 1 * KB;
+  // All chunks share one buffer: the receiver only looks at their lengths,
+  // and external typed data is never copied on the way.
+  static uint8_t chunk[kChunkSize];
+  ASSERT(kNumMessages % batch_size == 0);
+
+  Dart_EnterScope();
+  Dart_Handle lib = TestCase::LoadTestScript(kNativePortScript, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(kNumMessages);
+  Dart_Handle send_port = Dart_Invoke(lib, NewString("openPort"), 1, args);
+  EXPECT_VALID(send_port);
+  Dart_Port port_id;
+  EXPECT_VALID(Dart_SendPortGetId(send_port, &port_id));
+
+  Dart_CObject* messages = new Dart_CObject[batch_size];
+  Dart_CObject** batch = new Dart_CObject*[batch_size];
+  for (intptr_t i = 0; i < batch_size; i++) {
+    messages[i].type = Dart_CObject_kExternalTypedData;
+    messages[i].value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    messages[i].value.as_external_typed_data.length = kChunkSize;
+    messages[i].value.as_external_typed_data.data = chunk;
+    messages[i].value.as_external_typed_data.peer = NULL;
+    messages[i].value.as_external_typed_data.callback = NoopFinalizer;
+    batch[i] = &messages[i];
+  }
+
+  Timer timer(true, "Native port throughput");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumMessages; i += batch_size) {
+    if (batch_size == 1) {
+      EXPECT(Dart_PostCObject(port_id, batch[0]));
+    } else {
+      EXPECT(Dart_PostCObjects(port_id, batch_size, batch));
+    }
+  }
+  // Runs until the receiver has seen all chunks and closed its port.
+  EXPECT_VALID(Dart_RunLoop());
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+
+  Dart_Handle result = Dart_Invoke(lib, NewString("bytesReceived"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t bytes_received = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(result, &bytes_received));
+  EXPECT_EQ(kNumMessages * kChunkSize, bytes_received);
+
+  delete[] batch;
+  delete[] messages;
+  Dart_ExitScope();
+}
+
+BENCHMARK(NativePortPostCObject) {
+  BenchmarkNativePortThroughput(benchmark, /*batch_size=*/1);
+}
+
+BENCHMARK(NativePortPostCObjectsBatched) {
+  BenchmarkNativePortThroughput(benchmark, /*batch_size=*/64);
+}
+
+// Interns symbols on a helper thread. Half of the symbols are interned by all
+// tasks, the others only by this task.
+class InternSymbolsTask : public ThreadPool::Task {
+ public:
+  static const intptr_t kNumTasks = 4;
+  static const intptr_t kSymbolsPerTask = 200000;
+  static const intptr_t kNumSharedSymbols = 20000;
+
+  InternSymbolsTask(Isolate* isolate,
+                    intptr_t id,
+                    Monitor* monitor,
+                    intptr_t* exited)
+      : isolate_(isolate), id_(id), monitor_(monitor), exited_(exited) {}
+
+  virtual void Run() {
+    Thread::EnterIsolateAsHelper(isolate_, Thread::kUnknownTask);
+    Thread* thread = Thread::Current();
+    {
+      StackZone zone(thread);
+      char name[64];
+      for (intptr_t i = 0; i < kSymbolsPerTask; i++) {
+        HANDLESCOPE(thread);
+        if ((i & 1) == 0) {
+          Utils::SNPrint(name, sizeof(name), "shared%" Pd,
+                         i % kNumSharedSymbols);
+        } else {
+          Utils::SNPrint(name, sizeof(name), "task%" Pd "_%" Pd, id_, i);
+        }
+        Symbols::New(thread, name);
+      }
+    }
+    Thread::ExitIsolateAsHelper();
+    {
+      MonitorLocker ml(monitor_);
+      ++*exited_;
+      ml.Notify();
+    }
+  }
+
+ private:
+  Isolate* isolate_;
+  const intptr_t id_;
+  Monitor* monitor_;
+  intptr_t* exited_;
+};
+
+BENCHMARK(SymbolsConcurrentInterning) {
+  Isolate* isolate = thread->isolate();
+  Monitor monitor;
+  intptr_t exited = 0;
+  Timer timer(true, "Concurrent symbol interning");
+  timer.Start();
+  for (intptr_t i = 0; i < InternSymbolsTask::kNumTasks; i++) {
+    Dart::thread_pool()->Run<InternSymbolsTask>(isolate, i, &monitor, &exited);
+  }
+  {
+    // This thread is in native code, so the tasks can safepoint without it.
+    MonitorLocker ml(&monitor);
+    while (exited != InternSymbolsTask::kNumTasks) {
+      ml.Wait();
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
@@ -25,6 +25,8 @@
 #include "vm/program_visitor.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 #include "vm/zone_text_buffer.h"
@@ -42,8 +44,19 @@ DEFINE_FLAG(bool,
             print_cluster_information,
             false,
             "Print information about clusters written to snapshot");
+DEFINE_FLAG(bool,
+            lazy_line_starts,
+            true,
+            "Leave script line starts in the snapshot, to be paged in on "
+            "first use, instead of copying them into the heap.");
 #endif
 
+DEFINE_FLAG(int,
+            snapshot_fill_tasks,
+            4,
+            "Number of tasks that read the clusters of a program snapshot in "
+            "parallel, including the isolate's thread.");
+
 #if defined(DART_PRECOMPILER)
 DEFINE_FLAG(charp,
             write_v8_snapshot_profile_to,
@@ -474,6 +487,8 @@ class TypeArgumentsDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypeArgumentsPtr type_args = static_cast<TypeArgumentsPtr>(d->Ref(id));
@@ -663,6 +678,8 @@ class FunctionDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     Snapshot::Kind kind = d->kind();
 
@@ -1232,6 +1249,16 @@ class ScriptSerializationCluster : public SerializationCluster {
   void Trace(Serializer* s, ObjectPtr object) {
     ScriptPtr script = Script::RawCast(object);
     objects_.Add(script);
+    // Line starts are only needed for stack traces and debugging. Leave them
+    // in the snapshot as external typed data, so their pages are only touched
+    // when a line is first looked up, instead of copying them into the heap.
+    TypedDataBasePtr line_starts = script->ptr()->line_starts_;
+    if (FLAG_lazy_line_starts && s->kind() != Snapshot::kFullAOT &&
+        line_starts->IsHeapObject() &&
+        IsTypedDataClassId(line_starts->GetClassId()) &&
+        s->Claim(line_starts)) {
+      line_starts_.Add(static_cast<TypedDataPtr>(line_starts));
+    }
     PushFromTo(script);
   }
 
@@ -1243,6 +1270,11 @@ class ScriptSerializationCluster : public SerializationCluster {
       ScriptPtr script = objects_[i];
       s->AssignRef(script);
     }
+    const intptr_t line_starts_count = line_starts_.length();
+    s->WriteUnsigned(line_starts_count);
+    for (intptr_t i = 0; i < line_starts_count; i++) {
+      s->AssignRef(line_starts_[i]);
+    }
   }
 
   void WriteFill(Serializer* s) {
@@ -1256,10 +1288,24 @@ class ScriptSerializationCluster : public SerializationCluster {
       s->Write<uint8_t>(script->ptr()->flags_);
       s->Write<int32_t>(script->ptr()->kernel_script_index_);
     }
+    const intptr_t line_starts_count = line_starts_.length();
+    for (intptr_t i = 0; i < line_starts_count; i++) {
+      TypedDataPtr line_starts = line_starts_[i];
+      AutoTraceObject(line_starts);
+      const intptr_t cid = line_starts->GetClassId();
+      s->WriteCid(cid - kTypedDataCidRemainderInternal +
+                  kTypedDataCidRemainderExternal);
+      const intptr_t length = Smi::Value(line_starts->ptr()->length_);
+      s->WriteUnsigned(length);
+      s->Align(ExternalTypedData::kDataSerializationAlignment);
+      s->WriteBytes(line_starts->ptr()->data(),
+                    length * TypedData::ElementSizeInBytes(cid));
+    }
   }
 
  private:
   GrowableArray<ScriptPtr> objects_;
+  GrowableArray<TypedDataPtr> line_starts_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -1276,6 +1322,12 @@ class ScriptDeserializationCluster : public DeserializationCluster {
       d->AssignRef(AllocateUninitialized(old_space, Script::InstanceSize()));
     }
     stop_index_ = d->next_index();
+    const intptr_t line_starts_count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < line_starts_count; i++) {
+      d->AssignRef(
+          AllocateUninitialized(old_space, ExternalTypedData::InstanceSize()));
+    }
+    line_starts_stop_index_ = d->next_index();
   }
 
   void ReadFill(Deserializer* d) {
@@ -1290,7 +1342,23 @@ class ScriptDeserializationCluster : public DeserializationCluster {
       script->ptr()->kernel_script_index_ = d->Read<int32_t>();
       script->ptr()->load_timestamp_ = 0;
     }
+    for (intptr_t id = stop_index_; id < line_starts_stop_index_; id++) {
+      ExternalTypedDataPtr line_starts =
+          static_cast<ExternalTypedDataPtr>(d->Ref(id));
+      const intptr_t cid = d->ReadCid();
+      const intptr_t length = d->ReadUnsigned();
+      Deserializer::InitializeHeader(line_starts, cid,
+                                     ExternalTypedData::InstanceSize());
+      line_starts->ptr()->length_ = Smi::New(length);
+      d->Align(ExternalTypedData::kDataSerializationAlignment);
+      line_starts->ptr()->data_ =
+          const_cast<uint8_t*>(d->CurrentBufferAddress());
+      d->Advance(length * ExternalTypedData::ElementSizeInBytes(cid));
+    }
   }
+
+ private:
+  intptr_t line_starts_stop_index_;
 };
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -2000,6 +2068,8 @@ class ObjectPoolDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     for (intptr_t id = start_index_; id < stop_index_; id += 1) {
       const intptr_t length = d->ReadUnsigned();
@@ -2277,17 +2347,28 @@ class RODataSerializationCluster : public SerializationCluster {
 
   void WriteAlloc(Serializer* s) {
     s->WriteCid(cid_);
+    WriteObjects(s, type_, objects_);
+  }
+
+  void WriteFill(Serializer* s) {
+    // No-op.
+  }
 
-    intptr_t count = objects_.length();
+  // Also used by clusters that place only some of their objects in the
+  // read-only data section.
+  static void WriteObjects(Serializer* s,
+                           const char* type,
+                           const GrowableArray<ObjectPtr>& objects) {
+    intptr_t count = objects.length();
     s->WriteUnsigned(count);
     uint32_t running_offset = 0;
     for (intptr_t i = 0; i < count; i++) {
-      ObjectPtr object = objects_[i];
+      ObjectPtr object = objects[i];
       s->AssignRef(object);
-      if (cid_ == kOneByteStringCid || cid_ == kTwoByteStringCid) {
-        s->TraceStartWritingObject(type_, object, String::RawCast(object));
+      if (object->IsStringInstance()) {
+        s->TraceStartWritingObject(type, object, String::RawCast(object));
       } else {
-        s->TraceStartWritingObject(type_, object, nullptr);
+        s->TraceStartWritingObject(type, object, nullptr);
       }
       uint32_t offset = s->GetDataOffset(object);
       s->TraceDataOffset(offset);
@@ -2301,8 +2382,18 @@ class RODataSerializationCluster : public SerializationCluster {
     }
   }
 
-  void WriteFill(Serializer* s) {
-    // No-op.
+  // Canonical numbers in an AOT snapshot are immutable and contain no
+  // pointers, so they can be used in place from the read-only data section.
+  // Returns false if [number] has to be written by value.
+  static bool TraceReadOnlyNumber(Serializer* s, ObjectPtr number) {
+    if (s->kind() != Snapshot::kFullAOT || !number->ptr()->IsCanonical()) {
+      return false;
+    }
+    if (!number->ptr()->InVMIsolateHeap() &&
+        !s->isolate()->heap()->old_space()->IsObjectFromImagePages(number)) {
+      Object::FinalizeReadOnlyObject(number);
+    }
+    return true;
   }
 
  private:
@@ -2317,7 +2408,13 @@ class RODataDeserializationCluster : public DeserializationCluster {
   RODataDeserializationCluster() {}
   ~RODataDeserializationCluster() {}
 
-  void ReadAlloc(Deserializer* d) {
+  void ReadAlloc(Deserializer* d) { ReadObjects(d); }
+
+  void ReadFill(Deserializer* d) {
+    // No-op.
+  }
+
+  static void ReadObjects(Deserializer* d) {
     intptr_t count = d->ReadUnsigned();
     uint32_t running_offset = 0;
     for (intptr_t i = 0; i < count; i++) {
@@ -2325,10 +2422,6 @@ class RODataDeserializationCluster : public DeserializationCluster {
       d->AssignRef(d->GetObjectAt(running_offset));
     }
   }
-
-  void ReadFill(Deserializer* d) {
-    // No-op.
-  }
 };
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -3173,14 +3266,15 @@ class InstanceDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     intptr_t next_field_offset = next_field_offset_in_words_ << kWordSizeLog2;
     intptr_t instance_size =
         Object::RoundedAllocationSize(instance_size_in_words_ * kWordSize);
 
     const auto unboxed_fields_bitmap =
-        d->isolate()->group()->shared_class_table()->GetUnboxedFieldsMapAt(
-            cid_);
+        d->isolate_group()->shared_class_table()->GetUnboxedFieldsMapAt(cid_);
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       InstancePtr instance = static_cast<InstancePtr>(d->Ref(id));
       bool is_canonical = d->Read<bool>();
@@ -3750,6 +3844,10 @@ class MintSerializationCluster : public SerializationCluster {
     if (!object->IsHeapObject()) {
       SmiPtr smi = Smi::RawCast(object);
       smis_.Add(smi);
+    } else if (!compiler::target::IsSmi(Mint::RawCast(object)->ptr()->value_) &&
+               RODataSerializationCluster::TraceReadOnlyNumber(s, object)) {
+      // Mints that are Smis on the target are written by value below.
+      read_only_mints_.Add(object);
     } else {
       MintPtr mint = Mint::RawCast(object);
       mints_.Add(mint);
@@ -3759,6 +3857,7 @@ class MintSerializationCluster : public SerializationCluster {
   void WriteAlloc(Serializer* s) {
     s->WriteCid(kMintCid);
 
+    RODataSerializationCluster::WriteObjects(s, "int", read_only_mints_);
     s->WriteUnsigned(smis_.length() + mints_.length());
     for (intptr_t i = 0; i < smis_.length(); i++) {
       SmiPtr smi = smis_[i];
@@ -3781,6 +3880,7 @@ class MintSerializationCluster : public SerializationCluster {
  private:
   GrowableArray<SmiPtr> smis_;
   GrowableArray<MintPtr> mints_;
+  GrowableArray<ObjectPtr> read_only_mints_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -3793,6 +3893,7 @@ class MintDeserializationCluster : public DeserializationCluster {
     PageSpace* old_space = d->heap()->old_space();
 
     start_index_ = d->next_index();
+    RODataDeserializationCluster::ReadObjects(d);
     const intptr_t count = d->ReadUnsigned();
     for (intptr_t i = 0; i < count; i++) {
       bool is_canonical = d->Read<bool>();
@@ -3834,12 +3935,17 @@ class DoubleSerializationCluster : public SerializationCluster {
   ~DoubleSerializationCluster() {}
 
   void Trace(Serializer* s, ObjectPtr object) {
+    if (RODataSerializationCluster::TraceReadOnlyNumber(s, object)) {
+      read_only_objects_.Add(object);
+      return;
+    }
     DoublePtr dbl = Double::RawCast(object);
     objects_.Add(dbl);
   }
 
   void WriteAlloc(Serializer* s) {
     s->WriteCid(kDoubleCid);
+    RODataSerializationCluster::WriteObjects(s, "double", read_only_objects_);
     const intptr_t count = objects_.length();
     s->WriteUnsigned(count);
     for (intptr_t i = 0; i < count; i++) {
@@ -3860,6 +3966,7 @@ class DoubleSerializationCluster : public SerializationCluster {
 
  private:
   GrowableArray<DoublePtr> objects_;
+  GrowableArray<ObjectPtr> read_only_objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -3869,6 +3976,7 @@ class DoubleDeserializationCluster : public DeserializationCluster {
   ~DoubleDeserializationCluster() {}
 
   void ReadAlloc(Deserializer* d) {
+    RODataDeserializationCluster::ReadObjects(d);
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
     const intptr_t count = d->ReadUnsigned();
@@ -4020,6 +4128,8 @@ class TypedDataDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
 
@@ -4582,6 +4692,8 @@ class ArrayDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       ArrayPtr array = static_cast<ArrayPtr>(d->Ref(id));
@@ -4662,6 +4774,8 @@ class OneByteStringDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       OneByteStringPtr str = static_cast<OneByteStringPtr>(d->Ref(id));
@@ -4739,6 +4853,8 @@ class TwoByteStringDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TwoByteStringPtr str = static_cast<TwoByteStringPtr>(d->Ref(id));
@@ -5239,6 +5355,16 @@ void Serializer::Push(ObjectPtr object) {
   }
 }
 
+bool Serializer::Claim(ObjectPtr object) {
+  ASSERT(object->IsHeapObject());
+  if (heap_->GetObjectId(object) != kUnreachableReference) {
+    return false;
+  }
+  heap_->SetObjectId(object, kUnallocatedReference);
+  num_written_objects_++;
+  return true;
+}
+
 void Serializer::Trace(ObjectPtr object) {
   intptr_t cid;
   if (!object->IsHeapObject()) {
@@ -5427,15 +5553,35 @@ void Serializer::Serialize() {
   }
 #endif
 
+  // The fills are preceded by a table of their offsets from the start of the
+  // table, so that the deserializer can read them in parallel. The table has a
+  // fixed size and is written once the fills have been written.
+  const intptr_t fill_table_position = bytes_written();
+  for (intptr_t i = 0; i <= num_clusters; i++) {
+    stream_.WriteFixed<uint32_t>(0);
+  }
+  GrowableArray<intptr_t> fill_offsets(num_clusters + 1);
   for (intptr_t cid = 1; cid < num_cids_; cid++) {
     SerializationCluster* cluster = clusters_by_cid_[cid];
     if (cluster != NULL) {
+      fill_offsets.Add(bytes_written() - fill_table_position);
       cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
       Write<int32_t>(kSectionMarker);
 #endif
     }
   }
+  fill_offsets.Add(bytes_written() - fill_table_position);
+  ASSERT(fill_offsets.length() == num_clusters + 1);
+  if (!Utils::IsUint(32, fill_offsets.Last())) {
+    FATAL("Fill offset overflow");
+  }
+  const intptr_t fills_end = bytes_written();
+  stream_.SetPosition(fill_table_position);
+  for (intptr_t i = 0; i <= num_clusters; i++) {
+    stream_.WriteFixed<uint32_t>(fill_offsets[i]);
+  }
+  stream_.SetPosition(fills_end);
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
@@ -5848,6 +5994,22 @@ Deserializer::Deserializer(Thread* thread,
   stream_.SetPosition(offset);
 }
 
+Deserializer::Deserializer(Thread* thread, const Deserializer& parent)
+    : ThreadStackResource(thread),
+      heap_(parent.heap_),
+      zone_(thread->zone()),
+      kind_(parent.kind_),
+      stream_(nullptr, 0),
+      image_reader_(parent.image_reader_),
+      num_base_objects_(parent.num_base_objects_),
+      num_objects_(parent.num_objects_),
+      num_clusters_(parent.num_clusters_),
+      code_order_length_(parent.code_order_length_),
+      refs_(parent.refs_),
+      next_ref_index_(parent.next_ref_index_),
+      clusters_(nullptr),
+      field_table_(parent.field_table_) {}
+
 Deserializer::~Deserializer() {
   delete[] clusters_;
 }
@@ -6278,13 +6440,129 @@ void Deserializer::Deserialize() {
   // We should have completely filled the ref array.
   ASSERT((next_ref_index_ - 1) == num_objects_);
 
+  ReadFills();
+}
+
+// Fills of less than this many bytes are all read on the isolate's thread.
+static const intptr_t kMinConcurrentFillSize = 1 * MB;
+
+class DeserializationFillTask : public ThreadPool::Task {
+ public:
+  DeserializationFillTask(IsolateGroup* isolate_group,
+                          Deserializer* deserializer,
+                          ThreadBarrier* barrier,
+                          RelaxedAtomic<intptr_t>* next_fill)
+      : isolate_group_(isolate_group),
+        deserializer_(deserializer),
+        barrier_(barrier),
+        next_fill_(next_fill) {}
+
+  void Run() {
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        isolate_group_, Thread::kUnknownTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+
+    deserializer_->ReadConcurrentFills(Thread::Current(), next_fill_);
+
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  Deserializer* deserializer_;
+  ThreadBarrier* barrier_;
+  RelaxedAtomic<intptr_t>* next_fill_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeserializationFillTask);
+};
+
+// The fills are preceded by a table of their offsets. Clusters that cannot be
+// filled concurrently are filled first, in order, on the isolate's thread.
+// The others are then divided between the isolate's thread and helper
+// threads, one cluster at a time.
+void Deserializer::ReadFills() {
+  fill_table_ = CurrentBufferAddress();
+  fill_offsets_ = zone_->Alloc<intptr_t>(num_clusters_ + 1);
+  for (intptr_t i = 0; i <= num_clusters_; i++) {
+    uint32_t offset;
+    ReadBytes(reinterpret_cast<uint8_t*>(&offset), sizeof(offset));
+    fill_offsets_[i] = offset;
+  }
+  const intptr_t fill_size = fill_offsets_[num_clusters_] - fill_offsets_[0];
+  ASSERT(CurrentBufferAddress() == fill_table_ + fill_offsets_[0]);
+
+  intptr_t num_tasks = read_fills_concurrently_ ? FLAG_snapshot_fill_tasks : 1;
+  if (fill_size < kMinConcurrentFillSize) {
+    num_tasks = 1;
+  }
+  if (num_tasks <= 1) {
+    for (intptr_t i = 0; i < num_clusters_; i++) {
+      clusters_[i]->ReadFill(this);
+#if defined(DEBUG)
+      int32_t section_marker = Read<int32_t>();
+      ASSERT(section_marker == kSectionMarker);
+#endif
+    }
+    return;
+  }
+
+  concurrent_fills_ = zone_->Alloc<intptr_t>(num_clusters_);
+  num_concurrent_fills_ = 0;
   for (intptr_t i = 0; i < num_clusters_; i++) {
+    if (clusters_[i]->CanReadFillConcurrently()) {
+      concurrent_fills_[num_concurrent_fills_++] = i;
+      continue;
+    }
+    Advance(fill_table_ + fill_offsets_[i] - CurrentBufferAddress());
     clusters_[i]->ReadFill(this);
 #if defined(DEBUG)
     int32_t section_marker = Read<int32_t>();
     ASSERT(section_marker == kSectionMarker);
 #endif
   }
+  num_tasks = Utils::Minimum(num_tasks, num_concurrent_fills_);
+  if (num_tasks > 0) {
+    TIMELINE_DURATION(thread(), Isolate, "ReadConcurrentFills");
+    Monitor monitor;
+    Monitor done_monitor;
+    ThreadBarrier barrier(num_tasks, &monitor, &done_monitor);
+    RelaxedAtomic<intptr_t> next_fill = {0};
+    for (intptr_t i = 0; i < num_tasks - 1; i++) {
+      Dart::thread_pool()->Run<DeserializationFillTask>(
+          thread()->isolate_group(), this, &barrier, &next_fill);
+    }
+    // The last task is the isolate's thread.
+    ReadConcurrentFills(thread(), &next_fill);
+    barrier.Exit();
+    // The destructor of the barrier waits for the helper tasks.
+  }
+  Advance(fill_table_ + fill_offsets_[num_clusters_] - CurrentBufferAddress());
+}
+
+void Deserializer::ReadConcurrentFills(Thread* thread,
+                                       RelaxedAtomic<intptr_t>* next_fill) {
+  Deserializer deserializer(thread, *this);
+  for (intptr_t i = next_fill->fetch_add(1); i < num_concurrent_fills_;
+       i = next_fill->fetch_add(1)) {
+    const intptr_t index = concurrent_fills_[i];
+    deserializer.ReadFill(clusters_[index], fill_table_ + fill_offsets_[index],
+                          fill_offsets_[index + 1] - fill_offsets_[index]);
+  }
+}
+
+void Deserializer::ReadFill(DeserializationCluster* cluster,
+                            const uint8_t* start,
+                            intptr_t size) {
+  stream_.SetStream(start, size);
+  cluster->ReadFill(this);
+#if defined(DEBUG)
+  int32_t section_marker = Read<int32_t>();
+  ASSERT(section_marker == kSectionMarker);
+#endif
+  ASSERT(CurrentBufferAddress() == start + size);
 }
 
 class HeapLocker : public StackResource {
@@ -6423,6 +6701,7 @@ void Deserializer::ReadProgramSnapshot(ObjectStore* object_store) {
       AddBaseObject(base_objects.At(i));
     }
 
+    read_fills_concurrently_ = true;
     Deserialize();
 
     // Read roots.
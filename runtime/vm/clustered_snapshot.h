@@ -6,6 +6,7 @@
 #define RUNTIME_VM_CLUSTERED_SNAPSHOT_H_
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 #include "vm/bitfield.h"
 #include "vm/datastream.h"
@@ -92,6 +93,12 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer) = 0;
 
+  // Whether ReadFill can run on a helper thread, at the same time as the
+  // fills of other such clusters. It must then not allocate, use handles or
+  // depend on the isolate, and only write the cluster's objects. Other fills
+  // run before these.
+  virtual bool CanReadFillConcurrently() const { return false; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {}
@@ -220,6 +227,10 @@ class Serializer : public ThreadStackResource {
 
   void Push(ObjectPtr object);
 
+  // Reserves a ref for an object that the calling cluster writes itself
+  // instead of tracing it. Returns false if the object was already pushed.
+  bool Claim(ObjectPtr object);
+
   void AddUntracedRef() { num_written_objects_++; }
 
   void Trace(ObjectPtr object);
@@ -679,6 +690,16 @@ class Deserializer : public ThreadStackResource {
   intptr_t code_order_length() const { return code_order_length_; }
 
  private:
+  // Creates a deserializer that reads fills of the clusters of [parent] on
+  // [thread].
+  Deserializer(Thread* thread, const Deserializer& parent);
+
+  void ReadFills();
+  void ReadConcurrentFills(Thread* thread, RelaxedAtomic<intptr_t>* next_fill);
+  void ReadFill(DeserializationCluster* cluster,
+                const uint8_t* start,
+                intptr_t size);
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
@@ -692,6 +713,16 @@ class Deserializer : public ThreadStackResource {
   intptr_t next_ref_index_;
   DeserializationCluster** clusters_;
   FieldTable* field_table_;
+  // Whether fills may be read on helper threads (see ReadFills).
+  bool read_fills_concurrently_ = false;
+  // The table of offsets of the cluster fills, from the start of the table.
+  const uint8_t* fill_table_ = nullptr;
+  intptr_t* fill_offsets_ = nullptr;
+  // The indices of the clusters that are filled concurrently.
+  intptr_t* concurrent_fills_ = nullptr;
+  intptr_t num_concurrent_fills_ = 0;
+
+  friend class DeserializationFillTask;
 };
 
 #define ReadFromTo(obj, ...) d->ReadFromTo(obj, ##__VA_ARGS__);
@@ -5,7 +5,9 @@
 #include "vm/compilation_trace.h"
 
 #include "vm/compiler/jit/compiler.h"
+#include "vm/dart_entry.h"
 #include "vm/globals.h"
+#include "vm/hash_table.h"
 #include "vm/log.h"
 #include "vm/longjump.h"
 #include "vm/object_store.h"
@@ -438,7 +440,9 @@ TypeFeedbackSaver::TypeFeedbackSaver(WriteStream* stream)
       field_(Field::Handle()),
       code_(Code::Handle()),
       call_sites_(Array::Handle()),
-      call_site_(ICData::Handle()) {}
+      call_site_(ICData::Handle()),
+      args_desc_(Array::Handle()),
+      arg_names_(Array::Handle()) {}
 
 // These flags affect deopt ids.
 static char* CompilerFlags() {
@@ -549,6 +553,18 @@ void TypeFeedbackSaver::VisitFunction(const Function& function) {
     str_ = String::RemovePrivateKey(str_);
     WriteString(str_);
 
+    args_desc_ = call_site_.arguments_descriptor();
+    ArgumentsDescriptor args_desc(args_desc_);
+    WriteInt(args_desc.TypeArgsLen());
+    WriteInt(args_desc.Count());
+    arg_names_ = args_desc.GetArgumentNames();
+    const intptr_t num_names = arg_names_.IsNull() ? 0 : arg_names_.Length();
+    WriteInt(num_names);
+    for (intptr_t name_index = 0; name_index < num_names; name_index++) {
+      str_ ^= arg_names_.At(name_index);
+      WriteString(str_);
+    }
+
     intptr_t num_checked_arguments = call_site_.NumArgsTested();
     WriteInt(num_checked_arguments);
 
@@ -603,6 +619,8 @@ TypeFeedbackLoader::TypeFeedbackLoader(Thread* thread)
       target_name_(String::Handle(zone_)),
       target_(Function::Handle(zone_)),
       args_desc_(Array::Handle(zone_)),
+      arg_names_(Array::Handle(zone_)),
+      feedback_(GrowableObjectArray::Handle(zone_)),
       functions_to_compile_(
           GrowableObjectArray::Handle(zone_, GrowableObjectArray::New())),
       error_(Error::Handle(zone_)) {}
@@ -685,14 +703,21 @@ ObjectPtr TypeFeedbackLoader::CheckHeader() {
   }
   stream_->Advance(version_len);
 
-  char* expected_features = CompilerFlags();
-  ASSERT(expected_features != NULL);
-  const intptr_t expected_len = strlen(expected_features);
-
   const char* features =
       reinterpret_cast<const char*>(stream_->AddressOfCurrentPosition());
   ASSERT(features != NULL);
   intptr_t buffer_len = Utils::StrNLen(features, stream_->PendingBytes());
+
+  if (FLAG_precompiled_mode) {
+    // The precompiler matches call sites by selector instead of deopt id, so
+    // feedback from a JIT with different compiler flags is still usable.
+    stream_->Advance(buffer_len + 1);
+    return Error::null();
+  }
+
+  char* expected_features = CompilerFlags();
+  ASSERT(expected_features != NULL);
+  const intptr_t expected_len = strlen(expected_features);
   if ((buffer_len != expected_len) ||
       (strncmp(features, expected_features, expected_len) != 0)) {
     const String& msg = String::Handle(String::NewFormatted(
@@ -733,7 +758,8 @@ ObjectPtr TypeFeedbackLoader::LoadClasses() {
 ObjectPtr TypeFeedbackLoader::LoadFields() {
   for (intptr_t cid = kNumPredefinedCids; cid < num_cids_; cid++) {
     cls_ = ReadClassByName();
-    bool skip = cls_.IsNull();
+    // Field guards are not used by precompiled code.
+    bool skip = cls_.IsNull() || FLAG_precompiled_mode;
 
     intptr_t num_fields = ReadInt();
     if (!skip && (num_fields > 0)) {
@@ -829,7 +855,15 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     }
   }
 
-  if (!skip) {
+  if (skip) {
+    // Nothing to compile.
+  } else if (FLAG_precompiled_mode) {
+    // The precompiler does not generate unoptimized code, so there is no
+    // ICData to merge into: the feedback is collected into fresh ICData.
+    feedback_ = GrowableObjectArray::New();
+    cls_ = func_.Owner();
+    lib_ = cls_.library();
+  } else {
     error_ = Compiler::CompileFunction(thread_, func_);
     if (error_.IsError()) {
       return error_.raw();
@@ -852,15 +886,33 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     intptr_t deopt_id = ReadInt();
     intptr_t rebind_rule = ReadInt();
     target_name_ = ReadString();
+    args_desc_ = ReadArgumentsDescriptor();
     intptr_t num_checked_arguments = ReadInt();
     intptr_t num_entries = ReadInt();
 
-    if (!skip) {
+    bool skip_call_site = skip;
+    if (skip) {
+      // Nothing to merge into.
+    } else if (FLAG_precompiled_mode) {
+      if (rebind_rule == ICData::kInstance) {
+        if (Library::IsPrivate(target_name_)) {
+          target_name_ = lib_.PrivateName(target_name_);
+        }
+        call_site_ =
+            ICData::New(func_, target_name_, args_desc_, deopt_id,
+                        num_checked_arguments, ICData::kInstance);
+        feedback_.Add(call_site_);
+      } else {
+        // Precompiled code binds non-instance calls statically.
+        skip_call_site = true;
+      }
+    } else {
       call_site_ ^= call_sites_.At(i);
       if ((call_site_.deopt_id() != deopt_id) ||
           (call_site_.rebind_rule() != rebind_rule) ||
           (call_site_.NumArgsTested() != num_checked_arguments)) {
         skip = true;
+        skip_call_site = true;
         if (FLAG_trace_compilation_trace) {
           THR_Print("Mismatched call site %s\n", call_site_.ToCString());
         }
@@ -869,7 +921,7 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
 
     for (intptr_t entry_index = 0; entry_index < num_entries; entry_index++) {
       intptr_t entry_usage = ReadInt();
-      bool skip_entry = skip;
+      bool skip_entry = skip_call_site;
       GrowableArray<intptr_t> cids(num_checked_arguments);
 
       for (intptr_t argument_index = 0; argument_index < num_checked_arguments;
@@ -910,10 +962,17 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     }
   }
 
-  if (!skip) {
-    func_.set_usage_counter(usage);
-    func_.set_inlining_depth(inlining_depth);
+  if (skip) {
+    return Error::null();
+  }
+
+  func_.set_usage_counter(usage);
+  func_.set_inlining_depth(inlining_depth);
 
+  if (FLAG_precompiled_mode) {
+    call_sites_ = Array::MakeFixedLength(feedback_);
+    AotTypeFeedback::Add(thread_, func_, call_sites_);
+  } else {
     // Delay compilation until all feedback is loaded so feedback is available
     // for inlined functions.
     functions_to_compile_.Add(func_);
@@ -922,6 +981,23 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
   return Error::null();
 }
 
+ArrayPtr TypeFeedbackLoader::ReadArgumentsDescriptor() {
+  intptr_t type_args_len = ReadInt();
+  intptr_t num_arguments = ReadInt();
+  intptr_t num_names = ReadInt();
+  if (num_names == 0) {
+    return ArgumentsDescriptor::NewBoxed(type_args_len, num_arguments);
+  }
+  arg_names_ = Array::New(num_names, Heap::kOld);
+  String& name = String::Handle(zone_);
+  for (intptr_t i = 0; i < num_names; i++) {
+    name = ReadString();
+    arg_names_.SetAt(i, name);
+  }
+  return ArgumentsDescriptor::NewBoxed(type_args_len, num_arguments,
+                                       arg_names_);
+}
+
 FunctionPtr TypeFeedbackLoader::FindFunction(FunctionLayout::Kind kind,
                                              intptr_t token_pos) {
   if (cls_name_.Equals(Symbols::TopLevel())) {
@@ -1028,6 +1104,49 @@ StringPtr TypeFeedbackLoader::ReadString() {
   return Symbols::New(thread_, cstr, len);
 }
 
+class TypeFeedbackMapTraits {
+ public:
+  static bool ReportStats() { return false; }
+  static const char* Name() { return "TypeFeedbackMapTraits"; }
+
+  static bool IsMatch(const Object& a, const Object& b) {
+    return a.raw() == b.raw();
+  }
+
+  static uword Hash(const Object& obj) { return Function::Cast(obj).Hash(); }
+};
+
+typedef UnorderedHashMap<TypeFeedbackMapTraits> TypeFeedbackMap;
+
+void AotTypeFeedback::Add(Thread* thread,
+                          const Function& function,
+                          const Array& feedback) {
+  ObjectStore* object_store = thread->isolate()->object_store();
+  if (object_store->type_feedback() == Array::null()) {
+    object_store->set_type_feedback(
+        Array::Handle(thread->zone(),
+                      HashTables::New<TypeFeedbackMap>(16, Heap::kOld)));
+  }
+  TypeFeedbackMap map(object_store->type_feedback());
+  map.UpdateOrInsert(function, feedback);
+  object_store->set_type_feedback(map.Release());
+}
+
+ArrayPtr AotTypeFeedback::Lookup(Thread* thread, const Function& function) {
+  ObjectStore* object_store = thread->isolate()->object_store();
+  if (object_store->type_feedback() == Array::null()) {
+    return Array::null();
+  }
+  TypeFeedbackMap map(object_store->type_feedback());
+  const ArrayPtr feedback = Array::RawCast(map.GetOrNull(function));
+  map.Release();
+  return feedback;
+}
+
+void AotTypeFeedback::Clear(Thread* thread) {
+  thread->isolate()->object_store()->set_type_feedback(Array::null_array());
+}
+
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
 }  // namespace dart
@@ -88,8 +88,17 @@ class TypeFeedbackSaver : public FunctionVisitor {
   Code& code_;
   Array& call_sites_;
   ICData& call_site_;
+  Array& args_desc_;
+  Array& arg_names_;
 };
 
+// Loads feedback saved by TypeFeedbackSaver.
+//
+// In the JIT the feedback is merged into the ICData of the unoptimized code
+// and hot functions are compiled with it. In precompiled mode nothing is
+// compiled: the feedback of instance calls is kept in AotTypeFeedback so that
+// the precompiler can use it for receiver class speculation and inlining
+// decisions (see FlowGraph::PopulateWithTypeFeedback).
 class TypeFeedbackLoader : public ValueObject {
  public:
   explicit TypeFeedbackLoader(Thread* thread);
@@ -102,6 +111,7 @@ class TypeFeedbackLoader : public ValueObject {
   ObjectPtr LoadClasses();
   ObjectPtr LoadFields();
   ObjectPtr LoadFunction();
+  ArrayPtr ReadArgumentsDescriptor();
   FunctionPtr FindFunction(FunctionLayout::Kind kind, intptr_t token_pos);
 
   ClassPtr ReadClassByName();
@@ -127,10 +137,26 @@ class TypeFeedbackLoader : public ValueObject {
   String& target_name_;
   Function& target_;
   Array& args_desc_;
+  Array& arg_names_;
+  GrowableObjectArray& feedback_;
   GrowableObjectArray& functions_to_compile_;
   Object& error_;
 };
 
+// Instance call feedback loaded for the precompiler, as an array of ICData
+// per function in the order of the JIT's deopt ids.
+//
+// This is kept apart from Function::ic_data_array, which the precompiler
+// clears when it compiles a function, so the feedback of a callee is still
+// available when the callee is inlined after being compiled itself.
+class AotTypeFeedback : public AllStatic {
+ public:
+  static void Add(Thread* thread, const Function& function,
+                  const Array& feedback);
+  static ArrayPtr Lookup(Thread* thread, const Function& function);
+  static void Clear(Thread* thread);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILATION_TRACE_H_
@@ -7,6 +7,7 @@
 #include "platform/unicode.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/aot/precompiler_tracer.h"
 #include "vm/compiler/assembler/assembler.h"
@@ -162,6 +163,10 @@ Precompiler::Precompiler(Thread* thread)
       dropped_typearg_count_(0),
       dropped_type_count_(0),
       dropped_library_count_(0),
+      eliminated_object_count_(0),
+      eliminated_closure_count_(0),
+      eliminated_array_count_(0),
+      eliminated_context_count_(0),
       libraries_(GrowableObjectArray::Handle(I->object_store()->libraries())),
       pending_functions_(
           GrowableObjectArray::Handle(GrowableObjectArray::New())),
@@ -403,6 +408,7 @@ void Precompiler::DoCompileAll() {
       // Clear these before dropping classes as they may hold onto otherwise
       // dead instances of classes we will remove or otherwise unused symbols.
       I->object_store()->set_unique_dynamic_targets(Array::null_array());
+      AotTypeFeedback::Clear(T);
       Class& null_class = Class::Handle(Z);
       Function& null_function = Function::Handle(Z);
       Field& null_field = Field::Handle(Z);
@@ -464,6 +470,12 @@ void Precompiler::DoCompileAll() {
     THR_Print(" %" Pd " type arguments,", dropped_typearg_count_);
     THR_Print(" %" Pd " classes,", dropped_class_count_);
     THR_Print(" %" Pd " libraries.\n", dropped_library_count_);
+
+    THR_Print("Eliminated allocations of %" Pd " objects,",
+              eliminated_object_count_);
+    THR_Print(" %" Pd " closures,", eliminated_closure_count_);
+    THR_Print(" %" Pd " arrays,", eliminated_array_count_);
+    THR_Print(" %" Pd " contexts.\n", eliminated_context_count_);
   }
 }
 
@@ -1085,6 +1097,13 @@ void Precompiler::AddTableSelector(const compiler::TableSelector* selector) {
   changed_ = true;
 }
 
+void Precompiler::RecordAllocationSinking(const AllocationSinking& sinking) {
+  eliminated_object_count_ += sinking.num_eliminated_objects();
+  eliminated_closure_count_ += sinking.num_eliminated_closures();
+  eliminated_array_count_ += sinking.num_eliminated_arrays();
+  eliminated_context_count_ += sinking.num_eliminated_contexts();
+}
+
 bool Precompiler::IsHitByTableSelector(const Function& function) {
   if (!(FLAG_use_bare_instructions && FLAG_use_table_dispatch)) {
     return false;
@@ -2449,6 +2468,7 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       }
 
       if (optimized()) {
+        flow_graph->PopulateWithTypeFeedback(function);
         flow_graph->PopulateWithICData(function);
       }
 
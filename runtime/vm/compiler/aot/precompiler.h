@@ -20,6 +20,7 @@
 namespace dart {
 
 // Forward declarations.
+class AllocationSinking;
 class Class;
 class Error;
 class Field;
@@ -237,6 +238,10 @@ class Precompiler : public ValueObject {
   void AddField(const Field& field);
   void AddTableSelector(const compiler::TableSelector* selector);
 
+  // Accumulates the number of allocations eliminated by the given run of
+  // the allocation sinking pass.
+  void RecordAllocationSinking(const AllocationSinking& sinking);
+
   enum class Phase {
     kPreparation,
     kCompilingConstructorsForInstructionCounts,
@@ -348,6 +353,10 @@ class Precompiler : public ValueObject {
   intptr_t dropped_type_count_;
   intptr_t dropped_typeparam_count_;
   intptr_t dropped_library_count_;
+  intptr_t eliminated_object_count_;
+  intptr_t eliminated_closure_count_;
+  intptr_t eliminated_array_count_;
+  intptr_t eliminated_context_count_;
 
   compiler::ObjectPoolBuilder global_object_pool_builder_;
   GrowableObjectArray& libraries_;
@@ -239,8 +239,28 @@ void BlockScheduler::ReorderBlocksJIT(FlowGraph* flow_graph) {
   }
 }
 
-// Moves blocks ending in a throw/rethrow, as well as any block post-dominated
-// by such a throwing block, to the end.
+// Returns true if [block] contains an instance call which type feedback
+// (see --load_type_feedback) shows was never reached, even though the
+// function owning the call was executed during the profiled run.
+static bool IsUnreachedInProfile(BlockEntryInstr* block) {
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    InstanceCallInstr* call = it.Current()->AsInstanceCall();
+    // Calls the feedback does not cover also have empty IC data in AOT, so
+    // only trust calls that were matched with feedback.
+    if ((call == nullptr) || !call->has_type_feedback() ||
+        (call->ic_data()->NumberOfChecks() > 0)) {
+      continue;
+    }
+    const Function& owner = Function::Handle(call->ic_data()->Owner());
+    if (owner.usage_counter() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Moves blocks ending in a throw/rethrow or never reached according to type
+// feedback, as well as any block post-dominated by such a block, to the end.
 void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
   if (!FLAG_reorder_basic_blocks) {
     return;
@@ -255,11 +275,11 @@ void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
   // predecessors need to be marked as well.
   GrowableArray<BlockEntryInstr*> worklist;
 
-  // Add all throwing blocks to the worklist.
+  // Add all throwing and unreached blocks to the worklist.
   for (intptr_t i = 0; i < block_count; ++i) {
     auto block = reverse_postorder[i];
     auto last = block->last_instruction();
-    if (last->IsThrow() || last->IsReThrow()) {
+    if (last->IsThrow() || last->IsReThrow() || IsUnreachedInProfile(block)) {
       const intptr_t preorder_nr = block->preorder_number();
       is_terminating[preorder_nr] = true;
       worklist.Add(block);
@@ -267,7 +287,7 @@ void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
   }
 
   // Follow all indirect predecessors which unconditionally will end up in a
-  // throwing block.
+  // throwing or unreached block.
   while (worklist.length() > 0) {
     auto block = worklist.RemoveLast();
     for (intptr_t i = 0; i < block->PredecessorCount(); ++i) {
@@ -282,8 +302,8 @@ void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
     }
   }
 
-  // Emit code in reverse postorder but move any throwing blocks (except the
-  // function entry, which needs to come first) to the very end.
+  // Emit code in reverse postorder but move any throwing or unreached blocks
+  // (except the function entry, which needs to come first) to the very end.
   auto codegen_order = flow_graph->CodegenBlockOrder(true);
   for (intptr_t i = 0; i < block_count; ++i) {
     auto block = reverse_postorder[i];
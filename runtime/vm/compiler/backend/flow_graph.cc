@@ -5,6 +5,7 @@
 #include "vm/compiler/backend/flow_graph.h"
 
 #include "vm/bit_vector.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
@@ -2360,6 +2361,89 @@ void FlowGraph::PopulateWithICData(const Function& function) {
   }
 }
 
+static int LowestDeoptIdFirst(InstanceCallInstr* const* a,
+                              InstanceCallInstr* const* b) {
+  return (*a)->deopt_id() - (*b)->deopt_id();
+}
+
+void FlowGraph::PopulateWithTypeFeedback(const Function& function) {
+  ASSERT(CompilerState::Current().is_aot());
+  Zone* zone = Thread::Current()->zone();
+
+  const Array& feedback = Array::Handle(
+      zone, AotTypeFeedback::Lookup(Thread::Current(), function));
+  if (feedback.IsNull() || (feedback.Length() == 0)) {
+    return;
+  }
+
+  GrowableArray<InstanceCallInstr*> calls;
+  for (BlockIterator block_it = reverse_postorder_iterator(); !block_it.Done();
+       block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      InstanceCallInstr* call = it.Current()->AsInstanceCall();
+      if ((call != nullptr) && !call->HasICData()) {
+        calls.Add(call);
+      }
+    }
+  }
+  calls.Sort(LowestDeoptIdFirst);
+
+  GrowableArray<bool> used(feedback.Length());
+  for (intptr_t i = 0; i < feedback.Length(); i++) {
+    used.Add(false);
+  }
+
+  ICData& feedback_ic_data = ICData::Handle(zone);
+  Function& target = Function::Handle(zone);
+  GrowableArray<intptr_t> class_ids;
+  for (intptr_t i = 0; i < calls.length(); i++) {
+    InstanceCallInstr* call = calls[i];
+    intptr_t index = 0;
+    for (; index < feedback.Length(); index++) {
+      if (used[index]) continue;
+      feedback_ic_data ^= feedback.At(index);
+      if (feedback_ic_data.target_name() == call->function_name().raw()) {
+        break;
+      }
+    }
+    if (index == feedback.Length()) {
+      continue;
+    }
+    used[index] = true;
+
+    const Array& args_desc_array =
+        Array::Handle(zone, call->GetArgumentsDescriptor());
+    ArgumentsDescriptor args_desc(args_desc_array);
+    ArgumentsDescriptor feedback_args_desc(
+        Array::Handle(zone, feedback_ic_data.arguments_descriptor()));
+    if ((feedback_ic_data.NumArgsTested() != call->checked_argument_count()) ||
+        (feedback_args_desc.TypeArgsLen() != args_desc.TypeArgsLen()) ||
+        (feedback_args_desc.Count() != args_desc.Count()) ||
+        (feedback_args_desc.PositionalCount() != args_desc.PositionalCount())) {
+      continue;
+    }
+
+    const ICData& ic_data = ICData::ZoneHandle(
+        zone, ICData::New(function, call->function_name(), args_desc_array,
+                          call->deopt_id(), call->checked_argument_count(),
+                          ICData::kInstance));
+    for (intptr_t j = 0; j < feedback_ic_data.NumberOfChecks(); j++) {
+      class_ids.Clear();
+      feedback_ic_data.GetClassIdsAt(j, &class_ids);
+      target = feedback_ic_data.GetTargetAt(j);
+      const intptr_t count = feedback_ic_data.GetCountAt(j);
+      if (class_ids.length() == 1) {
+        ic_data.AddReceiverCheck(class_ids[0], target, count);
+      } else {
+        ic_data.AddCheck(class_ids, target, count);
+      }
+    }
+    call->set_ic_data(&ic_data);
+    call->set_has_type_feedback();
+  }
+}
+
 // Optimize (a << b) & c pattern: if c is a positive Smi or zero, then the
 // shift can be a truncating Smi shift-left and result is always Smi.
 // Merging occurs only per basic-block.
@@ -395,6 +395,13 @@ class FlowGraph : public ZoneAllocated {
   // them.
   void PopulateWithICData(const Function& function);
 
+  // Attaches ICData's built from type feedback loaded into the precompiler
+  // (see TypeFeedbackLoader) to instance calls which don't already have them.
+  // Deopt ids of this graph need not match those of the JIT which recorded
+  // the feedback, so call sites are matched by selector and by their order
+  // among the calls with the same selector.
+  void PopulateWithTypeFeedback(const Function& function);
+
   void SelectRepresentations();
 
   void WidenSmiToInt32();
@@ -4125,11 +4125,17 @@ class InstanceCallInstr : public InstanceCallBaseInstr {
   const CallTargets& Targets();
   void SetTargets(const CallTargets* targets) { targets_ = targets; }
 
+  // Whether the IC data of this call was populated from loaded type feedback
+  // (see FlowGraph::PopulateWithTypeFeedback) rather than left empty.
+  bool has_type_feedback() const { return has_type_feedback_; }
+  void set_has_type_feedback() { has_type_feedback_ = true; }
+
  private:
   const CallTargets* targets_ = nullptr;
   const class BinaryFeedback* binary_ = nullptr;
   const intptr_t checked_argument_count_;
   const AbstractType* receivers_static_type_ = nullptr;
+  bool has_type_feedback_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(InstanceCallInstr);
 };
@@ -6099,30 +6105,14 @@ class AllocateUninitializedContextInstr
 // It does not produce any real code only deoptimization information.
 class MaterializeObjectInstr : public Definition {
  public:
-  MaterializeObjectInstr(AllocateObjectInstr* allocation,
-                         const ZoneGrowableArray<const Slot*>& slots,
-                         ZoneGrowableArray<Value*>* values)
-      : allocation_(allocation),
-        cls_(allocation->cls()),
-        num_variables_(-1),
-        slots_(slots),
-        values_(values),
-        locations_(NULL),
-        visited_for_liveness_(false),
-        registers_remapped_(false) {
-    ASSERT(slots_.length() == values_->length());
-    for (intptr_t i = 0; i < InputCount(); i++) {
-      InputAt(i)->set_instruction(this);
-      InputAt(i)->set_use_index(i);
-    }
-  }
-
-  MaterializeObjectInstr(AllocateUninitializedContextInstr* allocation,
+  MaterializeObjectInstr(AllocationInstr* allocation,
+                         const Class& cls,
+                         intptr_t num_elements,
                          const ZoneGrowableArray<const Slot*>& slots,
                          ZoneGrowableArray<Value*>* values)
       : allocation_(allocation),
-        cls_(Class::ZoneHandle(Object::context_class())),
-        num_variables_(allocation->num_context_variables()),
+        cls_(cls),
+        num_elements_(num_elements),
         slots_(slots),
         values_(values),
         locations_(NULL),
@@ -6135,10 +6125,12 @@ class MaterializeObjectInstr : public Definition {
     }
   }
 
-  Definition* allocation() const { return allocation_; }
+  AllocationInstr* allocation() const { return allocation_; }
   const Class& cls() const { return cls_; }
 
-  intptr_t num_variables() const { return num_variables_; }
+  // Number of context variables for contexts, number of elements for arrays
+  // and -1 for all other objects.
+  intptr_t num_elements() const { return num_elements_; }
 
   intptr_t FieldOffsetAt(intptr_t i) const {
     return slots_[i]->offset_in_bytes();
@@ -6182,9 +6174,9 @@ class MaterializeObjectInstr : public Definition {
     (*values_)[i] = value;
   }
 
-  Definition* allocation_;
+  AllocationInstr* allocation_;
   const Class& cls_;
-  intptr_t num_variables_;
+  intptr_t num_elements_;
   const ZoneGrowableArray<const Slot*>& slots_;
   ZoneGrowableArray<Value*>* values_;
   Location* locations_;
@@ -6561,7 +6553,9 @@ class AllocateContextInstr : public TemplateAllocation<0, NoThrow> {
  public:
   AllocateContextInstr(TokenPosition token_pos,
                        const ZoneGrowableArray<const Slot*>& context_slots)
-      : token_pos_(token_pos), context_slots_(context_slots) {}
+      : token_pos_(token_pos),
+        context_slots_(context_slots),
+        identity_(AliasIdentity::Unknown()) {}
 
   DECLARE_INSTRUCTION(AllocateContext)
   virtual CompileType ComputeType() const;
@@ -6582,11 +6576,15 @@ class AllocateContextInstr : public TemplateAllocation<0, NoThrow> {
         context_slots().length());
   }
 
+  virtual AliasIdentity Identity() const { return identity_; }
+  virtual void SetIdentity(AliasIdentity identity) { identity_ = identity; }
+
   PRINT_OPERANDS_TO_SUPPORT
 
  private:
   const TokenPosition token_pos_;
   const ZoneGrowableArray<const Slot*>& context_slots_;
+  AliasIdentity identity_;
 
   DISALLOW_COPY_AND_ASSIGN(AllocateContextInstr);
 };
@@ -117,6 +117,7 @@ FlowGraph* TestPipeline::RunPasses(
                                          osr_id, optimized);
 
   if (mode_ == CompilerPass::kAOT) {
+    flow_graph_->PopulateWithTypeFeedback(function_);
     flow_graph_->PopulateWithICData(function_);
   }
 
@@ -348,10 +348,25 @@ class CallSites : public ValueObject {
     }
   }
 
+  // Under AOT, call counts are only available from type feedback loaded into
+  // the precompiler. They are scaled down to the number of times the call
+  // site is executed per invocation of the caller, which is what the static
+  // estimate approximates.
+  static intptr_t AotCallCount(const Function& caller,
+                               intptr_t call_count,
+                               intptr_t nesting_depth) {
+    const intptr_t usage = caller.usage_counter();
+    if ((call_count > 0) && (usage > 0)) {
+      return Utils::Maximum<intptr_t>(1, call_count / usage);
+    }
+    return AotCallCountApproximation(nesting_depth);
+  }
+
   // Computes the ratio for each call site in a method, defined as the
   // number of times a call site is executed over the maximum number of
   // times any call site is executed in the method. JIT uses actual call
-  // counts whereas AOT uses a static estimate based on nesting depth.
+  // counts whereas AOT uses type feedback if available and a static estimate
+  // based on nesting depth otherwise.
   void ComputeCallSiteRatio(intptr_t static_call_start_ix,
                             intptr_t instance_call_start_ix) {
     const intptr_t num_static_calls =
@@ -366,7 +381,8 @@ class CallSites : public ValueObject {
           instance_calls_[i + instance_call_start_ix];
       intptr_t aggregate_count =
           CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
+              ? AotCallCount(info.caller(), info.call->CallCount(),
+                             info.nesting_depth)
               : info.call->CallCount();
       instance_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
@@ -377,7 +393,8 @@ class CallSites : public ValueObject {
       const StaticCallInfo& info = static_calls_[i + static_call_start_ix];
       intptr_t aggregate_count =
           CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
+              ? AotCallCount(info.caller(), info.call->CallCount(),
+                             info.nesting_depth)
               : info.call->CallCount();
       static_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
@@ -1052,6 +1069,7 @@ class CallSiteInliner : public ValueObject {
         }
 #if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
         if (CompilerState::Current().is_aot()) {
+          callee_graph->PopulateWithTypeFeedback(parsed_function->function());
           callee_graph->PopulateWithICData(parsed_function->function());
         }
 #endif
@@ -7,8 +7,10 @@
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/compiler_pass.h"
 #include "vm/object.h"
+#include "vm/resolver.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -289,6 +291,148 @@ ISOLATE_UNIT_TEST_CASE(Inliner_List_generate) {
   }
 }
 
+// Verifies that type feedback loaded into the precompiler is attached to
+// the matching instance calls.
+ISOLATE_UNIT_TEST_CASE(Inliner_TypeFeedbackAOT) {
+  const char* kScript = R"(
+    class A { int foo() => 1; }
+    class B { int foo() => 2; }
+    int test(dynamic x) => x.foo();
+    main() {
+      test(A());
+      test(B());
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "test"));
+  const auto& cls_a = Class::Handle(GetClass(root_library, "A"));
+  const auto& cls_b = Class::Handle(GetClass(root_library, "B"));
+  EXPECT(Error::Handle(cls_a.EnsureIsFinalized(thread)).IsNull());
+  EXPECT(Error::Handle(cls_b.EnsureIsFinalized(thread)).IsNull());
+
+  const auto& selector = String::Handle(Symbols::New(thread, "foo"));
+  const auto& target_a = Function::Handle(
+      Resolver::ResolveDynamicAnyArgs(thread->zone(), cls_a, selector));
+  const auto& target_b = Function::Handle(
+      Resolver::ResolveDynamicAnyArgs(thread->zone(), cls_b, selector));
+  EXPECT(!target_a.IsNull() && !target_b.IsNull());
+
+  // Deopt ids of the recorded feedback need not match the precompiler's.
+  const intptr_t kFeedbackDeoptId = 42;
+  const auto& ic_data = ICData::ZoneHandle(ICData::New(
+      function, selector, Array::Handle(ArgumentsDescriptor::NewBoxed(0, 1)),
+      kFeedbackDeoptId, /*num_args_tested=*/1, ICData::kInstance));
+  ic_data.AddReceiverCheck(cls_a.id(), target_a, 90);
+  ic_data.AddReceiverCheck(cls_b.id(), target_b, 10);
+  const auto& feedback = Array::Handle(Array::New(1));
+  feedback.SetAt(0, ic_data);
+  AotTypeFeedback::Add(thread, function, feedback);
+
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({CompilerPass::kComputeSSA});
+
+  InstanceCallInstr* call = nullptr;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (auto instance_call = it.Current()->AsInstanceCall()) {
+        call = instance_call;
+      }
+    }
+  }
+  EXPECT(call != nullptr);
+  EXPECT(call->HasICData());
+  EXPECT(call->has_type_feedback());
+  EXPECT_EQ(2, call->ic_data()->NumberOfChecks());
+  EXPECT_EQ(100, call->CallCount());
+  EXPECT_EQ(call->deopt_id(), call->ic_data()->deopt_id());
+}
+
+// Verifies that feedback for a callee is still used when the callee is
+// inlined after the precompiler has compiled it, which clears the callee's
+// ic_data_array.
+ISOLATE_UNIT_TEST_CASE(Inliner_TypeFeedbackAOT_CalleeCompiledFirst) {
+  const char* kScript = R"(
+    class A { int foo() => 1; }
+    class B { int foo() => 2; }
+    int callee(dynamic x) => x.foo();
+    int caller(dynamic x) => callee(x);
+    main() {
+      caller(A());
+      caller(B());
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& callee = Function::Handle(GetFunction(root_library, "callee"));
+  const auto& caller = Function::Handle(GetFunction(root_library, "caller"));
+  const auto& cls_a = Class::Handle(GetClass(root_library, "A"));
+  const auto& cls_b = Class::Handle(GetClass(root_library, "B"));
+  EXPECT(Error::Handle(cls_a.EnsureIsFinalized(thread)).IsNull());
+  EXPECT(Error::Handle(cls_b.EnsureIsFinalized(thread)).IsNull());
+
+  const auto& selector = String::Handle(Symbols::New(thread, "foo"));
+  const auto& target_a = Function::Handle(
+      Resolver::ResolveDynamicAnyArgs(thread->zone(), cls_a, selector));
+  const auto& target_b = Function::Handle(
+      Resolver::ResolveDynamicAnyArgs(thread->zone(), cls_b, selector));
+  EXPECT(!target_a.IsNull() && !target_b.IsNull());
+
+  const auto& ic_data = ICData::Handle(ICData::New(
+      callee, selector, Array::Handle(ArgumentsDescriptor::NewBoxed(0, 1)),
+      /*deopt_id=*/1, /*num_args_tested=*/1, ICData::kInstance));
+  ic_data.AddReceiverCheck(cls_a.id(), target_a, 50);
+  ic_data.AddReceiverCheck(cls_b.id(), target_b, 50);
+  const auto& feedback = Array::Handle(Array::New(1));
+  feedback.SetAt(0, ic_data);
+  AotTypeFeedback::Add(thread, callee, feedback);
+
+  // Compile the callee first, as the precompiler would, and clear what the
+  // precompiler clears after compiling a function.
+  {
+    TestPipeline pipeline(callee, CompilerPass::kAOT);
+    pipeline.RunPasses({});
+  }
+  callee.ClearICDataArray();
+
+  // Inlining the callee into the caller should dispatch on the receiver
+  // classes recorded in the feedback instead of leaving a generic call.
+  TestPipeline pipeline(caller, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({
+      CompilerPass::kComputeSSA,
+      CompilerPass::kApplyICData,
+      CompilerPass::kTryOptimizePatterns,
+      CompilerPass::kSetOuterInliningId,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyClassIds,
+      CompilerPass::kInlining,
+  });
+
+  bool has_static_call = false;
+  bool has_generic_call = false;
+  bool has_cid_dispatch = false;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsStaticCall()) {
+        has_static_call = true;
+      } else if (current->IsInstanceCall()) {
+        has_generic_call = true;
+      } else if (current->IsPolymorphicInstanceCall() ||
+                 current->IsLoadClassId()) {
+        has_cid_dispatch = true;
+      }
+    }
+  }
+  EXPECT(!has_static_call);
+  EXPECT(!has_generic_call);
+  EXPECT(has_cid_dispatch);
+}
+
 #endif  // defined(DART_PRECOMPILER)
 
 }  // namespace dart
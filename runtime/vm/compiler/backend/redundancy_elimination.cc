@@ -10,6 +10,7 @@
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/loops.h"
 #include "vm/hash_map.h"
+#include "vm/object_store.h"
 #include "vm/stack_frame.h"
 
 namespace dart {
@@ -443,6 +444,7 @@ class Place : public ValueObject {
   static bool IsAllocation(Definition* defn) {
     return (defn != NULL) &&
            (defn->IsAllocateObject() || defn->IsCreateArray() ||
+            defn->IsAllocateContext() ||
             defn->IsAllocateUninitializedContext() ||
             (defn->IsStaticCall() &&
              defn->AsStaticCall()->IsRecognizedFactory()));
@@ -1775,6 +1777,46 @@ class LoadOptimizer : public ValueObject {
             (array_store->class_id() == kTypedDataFloat32x4ArrayCid));
   }
 
+  // Returns true if all fields (or elements) of an object produced by the
+  // given allocation have statically known initial values.
+  static bool IsAllocationWithInitialValues(Definition* defn) {
+    return defn->IsAllocateObject() || defn->IsCreateArray() ||
+           defn->IsAllocateContext();
+  }
+
+  // Compute initial value of the given [slot] of an object allocated by
+  // [alloc]. Returns false if initial value is not known.
+  bool InitialValueOf(Definition* alloc,
+                      const Slot& slot,
+                      Definition** initial_value) {
+    *initial_value = graph_->constant_null();
+    if (auto alloc_object = alloc->AsAllocateObject()) {
+      if (alloc_object->type_arguments() != nullptr) {
+        const Slot& type_args_slot = Slot::GetTypeArgumentsSlotFor(
+            graph_->thread(), alloc_object->cls());
+        if (slot.IsIdentical(type_args_slot)) {
+          *initial_value = alloc_object->type_arguments()->definition();
+        }
+      }
+      return true;
+    } else if (auto alloc_array = alloc->AsCreateArray()) {
+      if (slot.IsIdentical(Slot::GetTypeArgumentsSlotAt(
+              graph_->thread(),
+              compiler::target::Array::type_arguments_offset()))) {
+        *initial_value = alloc_array->element_type()->definition();
+        return true;
+      }
+      if (slot.IsIdentical(Slot::Array_length())) {
+        *initial_value = alloc_array->num_elements()->definition();
+        return true;
+      }
+      return false;
+    } else if (alloc->IsAllocateContext()) {
+      return slot.IsContextSlot();
+    }
+    return false;
+  }
+
   // Compute sets of loads generated and killed by each block.
   // Additionally compute upwards exposed and generated loads for each block.
   // Exposed loads are those that can be replaced if a corresponding
@@ -1905,8 +1947,12 @@ class LoadOptimizer : public ValueObject {
         // side-effects. If we add 'null' as known values for these fields
         // here we will incorrectly propagate this null across constructor
         // invocation.
-        if (auto alloc = instr->AsAllocateObject()) {
-          for (Value* use = alloc->input_use_list(); use != NULL;
+        //
+        // Arrays and contexts are handled in the same way: their elements
+        // and variables are null-initialized, type arguments of an array
+        // are given by its element type.
+        if (IsAllocationWithInitialValues(defn)) {
+          for (Value* use = defn->input_use_list(); use != NULL;
                use = use->next_use()) {
             // Look for all immediate loads/stores from this object.
             if (use->use_index() != 0) {
@@ -1921,31 +1967,37 @@ class LoadOptimizer : public ValueObject {
                            use->instruction()->AsStoreInstanceField()) {
               slot = &store->slot();
               place_id = GetPlaceId(store);
+            } else if (defn->IsCreateArray() &&
+                       (use->instruction()->IsLoadIndexed() ||
+                        use->instruction()->IsStoreIndexed())) {
+              // Only forward null into elements accessed by constant
+              // indices: X[C] places are precisely tracked per element.
+              place_id = GetPlaceId(use->instruction());
+              if (aliased_set_->places()[place_id]->kind() !=
+                  Place::kConstantIndexed) {
+                continue;
+              }
+            } else {
+              continue;
             }
 
+            Definition* forward_def = graph_->constant_null();
             if (slot != nullptr) {
-              // Found a load/store. Initialize current value of the field
-              // to null for normal fields, or with type arguments.
-
               // If the object escapes then don't forward final fields - see
               // the comment above for explanation.
-              if (aliased_set_->CanBeAliased(alloc) && slot->IsDartField() &&
-                  slot->is_immutable()) {
+              if (aliased_set_->CanBeAliased(defn) && slot->is_immutable() &&
+                  (slot->IsDartField() || slot->IsLocalVariable())) {
                 continue;
               }
 
-              Definition* forward_def = graph_->constant_null();
-              if (alloc->type_arguments() != nullptr) {
-                const Slot& type_args_slot = Slot::GetTypeArgumentsSlotFor(
-                    graph_->thread(), alloc->cls());
-                if (slot->IsIdentical(type_args_slot)) {
-                  forward_def = alloc->type_arguments()->definition();
-                }
+              if (!InitialValueOf(defn, *slot, &forward_def)) {
+                continue;
               }
-              gen->Add(place_id);
-              if (out_values == nullptr) out_values = CreateBlockOutValues();
-              (*out_values)[place_id] = forward_def;
             }
+
+            gen->Add(place_id);
+            if (out_values == nullptr) out_values = CreateBlockOutValues();
+            (*out_values)[place_id] = forward_def;
           }
           continue;
         }
@@ -2890,10 +2942,51 @@ void DeadStoreElimination::Optimize(FlowGraph* graph) {
 // Allocation Sinking
 //
 
+// Maximum length of an array which can be sunk: every element of a sunk
+// array becomes an input of each MaterializeObject describing it.
+static const intptr_t kMaxAllocationSinkingNumElements = 32;
+
+// Returns the length of the array allocated by the given CreateArray if it
+// is a constant small enough to allow allocation sinking or -1 otherwise.
+static intptr_t ArrayLengthForAllocationSinking(CreateArrayInstr* alloc) {
+  if (!alloc->num_elements()->BindsToConstant()) {
+    return -1;
+  }
+  const Object& length = alloc->num_elements()->BoundConstant();
+  if (!length.IsSmi()) {
+    return -1;
+  }
+  const intptr_t value = Smi::Cast(length).Value();
+  if ((value < 0) || (value > kMaxAllocationSinkingNumElements)) {
+    return -1;
+  }
+  return value;
+}
+
 // Returns true if the given instruction is an allocation that
 // can be sunk by the Allocation Sinking pass.
 static bool IsSupportedAllocation(Instruction* instr) {
-  return instr->IsAllocateObject() || instr->IsAllocateUninitializedContext();
+  return instr->IsAllocateObject() || instr->IsAllocateUninitializedContext() ||
+         instr->IsAllocateContext() ||
+         (instr->IsCreateArray() &&
+          (ArrayLengthForAllocationSinking(instr->AsCreateArray()) >= 0));
+}
+
+// Returns the index of the element written by the given store if it is
+// a store into a sinkable array at a constant index within array bounds.
+// Otherwise returns -1.
+static intptr_t ArrayElementStoreIndex(StoreIndexedInstr* store) {
+  CreateArrayInstr* array = store->array()->definition()->AsCreateArray();
+  if ((array == nullptr) || (store->class_id() != kArrayCid) ||
+      !store->index()->BindsToConstant() ||
+      !store->index()->BoundConstant().IsSmi()) {
+    return -1;
+  }
+  const intptr_t index = Smi::Cast(store->index()->BoundConstant()).Value();
+  if ((index < 0) || (index >= ArrayLengthForAllocationSinking(array))) {
+    return -1;
+  }
+  return index;
 }
 
 enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
@@ -2903,6 +2996,7 @@ enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
 //
 //     - any store into the allocation candidate itself is unconditionally safe
 //       as it just changes the rematerialization state of this candidate;
+//       for arrays this is limited to stores at constant in-bounds indices;
 //     - store into another object is only safe if another object is allocation
 //       candidate.
 //
@@ -2934,12 +3028,27 @@ static bool IsSafeUse(Value* use, SafeUseCheck check_type) {
     return true;
   }
 
+  StoreIndexedInstr* store_indexed = use->instruction()->AsStoreIndexed();
+  if (store_indexed != NULL) {
+    if (ArrayElementStoreIndex(store_indexed) < 0) {
+      return false;
+    }
+    if (use == store_indexed->value()) {
+      Definition* array = store_indexed->array()->definition();
+      return IsSupportedAllocation(array) &&
+             ((check_type == kOptimisticCheck) ||
+              array->Identity().IsAllocationSinkingCandidate());
+    }
+    return use == store_indexed->array();
+  }
+
   return false;
 }
 
 // Right now we are attempting to sink allocation only into
 // deoptimization exit. So candidate should only be used in StoreInstanceField
-// instructions that write into fields of the allocated object.
+// (or StoreIndexed for arrays) instructions that write into fields of the
+// allocated object.
 static bool IsAllocationSinkingCandidate(Definition* alloc,
                                          SafeUseCheck check_type) {
   for (Value* use = alloc->input_use_list(); use != NULL;
@@ -2964,9 +3073,26 @@ static Definition* StoreInto(Value* use) {
     return store->instance()->definition();
   }
 
+  StoreIndexedInstr* store_indexed = use->instruction()->AsStoreIndexed();
+  if (store_indexed != NULL) {
+    return store_indexed->array()->definition();
+  }
+
   return NULL;
 }
 
+// Returns true if the given instruction loads a field or an element of the
+// given allocation.
+static bool IsLoadFrom(Instruction* instr, Definition* alloc) {
+  if (LoadFieldInstr* load = instr->AsLoadField()) {
+    return load->instance()->definition() == alloc;
+  }
+  if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    return load->array()->definition() == alloc;
+  }
+  return false;
+}
+
 // Remove the given allocation from the graph. It is not observable.
 // If deoptimization occurs the object will be materialized.
 void AllocationSinking::EliminateAllocation(Definition* alloc) {
@@ -2997,6 +3123,20 @@ void AllocationSinking::EliminateAllocation(Definition* alloc) {
     ASSERT(alloc->ArgumentCount() == 1);
     ASSERT(!alloc->HasPushArguments());
   }
+
+  if (auto alloc_object = alloc->AsAllocateObject()) {
+    if (alloc_object->cls().IsClosureClass()) {
+      num_eliminated_closures_++;
+    } else {
+      num_eliminated_objects_++;
+    }
+  } else if (alloc->IsCreateArray()) {
+    num_eliminated_arrays_++;
+  } else {
+    ASSERT(alloc->IsAllocateContext() ||
+           alloc->IsAllocateUninitializedContext());
+    num_eliminated_contexts_++;
+  }
 }
 
 // Find allocation instructions that can be potentially eliminated and
@@ -3087,9 +3227,8 @@ void AllocationSinking::RemoveUnusedMaterializations() {
       // candidate in the beginning so it is safe to assume that any encountered
       // load was inserted by CreateMaterializationAt.
       for (intptr_t i = 0; i < mat->InputCount(); i++) {
-        LoadFieldInstr* load = mat->InputAt(i)->definition()->AsLoadField();
-        if ((load != NULL) &&
-            (load->instance()->definition() == mat->allocation())) {
+        Definition* load = mat->InputAt(i)->definition();
+        if (IsLoadFrom(load, mat->allocation())) {
           load->ReplaceUsesWith(flow_graph_->constant_null());
           load->RemoveFromGraph();
         }
@@ -3150,14 +3289,15 @@ void AllocationSinking::DiscoverFailedCandidates() {
       alloc->set_env_use_list(NULL);
       for (Value* use = alloc->input_use_list(); use != NULL;
            use = use->next_use()) {
-        if (use->instruction()->IsLoadField()) {
-          LoadFieldInstr* load = use->instruction()->AsLoadField();
+        if (IsLoadFrom(use->instruction(), alloc)) {
+          Definition* load = use->instruction()->AsDefinition();
           load->ReplaceUsesWith(flow_graph_->constant_null());
           load->RemoveFromGraph();
         } else {
           ASSERT(use->instruction()->IsMaterializeObject() ||
                  use->instruction()->IsPhi() ||
-                 use->instruction()->IsStoreInstanceField());
+                 use->instruction()->IsStoreInstanceField() ||
+                 use->instruction()->IsStoreIndexed());
         }
       }
     } else {
@@ -3240,6 +3380,13 @@ void AllocationSinking::Optimize() {
       }
     }
   }
+
+  if (FLAG_trace_optimization && (NumEliminated() > 0)) {
+    THR_Print("allocation sinking eliminated %" Pd " objects, %" Pd
+              " closures, %" Pd " arrays, %" Pd " contexts\n",
+              num_eliminated_objects_, num_eliminated_closures_,
+              num_eliminated_arrays_, num_eliminated_contexts_);
+  }
 }
 
 // Remove materializations from the graph. Register allocator will treat them
@@ -3313,23 +3460,45 @@ void AllocationSinking::CreateMaterializationAt(
   // instruction.
   Instruction* load_point = FirstMaterializationAt(exit);
 
-  // Insert load instruction for every field.
+  // Insert load instruction for every field and element.
   for (auto slot : slots) {
-    LoadFieldInstr* load =
-        new (Z) LoadFieldInstr(new (Z) Value(alloc), *slot, alloc->token_pos());
+    Definition* load = nullptr;
+    if (slot->IsArrayElement()) {
+      const intptr_t index =
+          compiler::target::Array::index_at_offset(slot->offset_in_bytes());
+      load = new (Z) LoadIndexedInstr(
+          new (Z) Value(alloc),
+          new (Z) Value(
+              flow_graph_->GetConstant(Smi::ZoneHandle(Z, Smi::New(index)))),
+          /*index_unboxed=*/false,
+          compiler::target::Instance::ElementSizeFor(kArrayCid), kArrayCid,
+          kAlignedAccess, DeoptId::kNone, alloc->token_pos());
+    } else {
+      load = new (Z)
+          LoadFieldInstr(new (Z) Value(alloc), *slot, alloc->token_pos());
+    }
     flow_graph_->InsertBefore(load_point, load, nullptr, FlowGraph::kValue);
     values->Add(new (Z) Value(load));
   }
 
-  MaterializeObjectInstr* mat = nullptr;
-  if (alloc->IsAllocateObject()) {
-    mat = new (Z)
-        MaterializeObjectInstr(alloc->AsAllocateObject(), slots, values);
+  const Class* cls = nullptr;
+  intptr_t num_elements = -1;
+  if (auto alloc_object = alloc->AsAllocateObject()) {
+    cls = &alloc_object->cls();
+  } else if (auto alloc_context = alloc->AsAllocateContext()) {
+    cls = &Class::ZoneHandle(Object::context_class());
+    num_elements = alloc_context->num_context_variables();
+  } else if (auto alloc_context = alloc->AsAllocateUninitializedContext()) {
+    cls = &Class::ZoneHandle(Object::context_class());
+    num_elements = alloc_context->num_context_variables();
+  } else if (auto alloc_array = alloc->AsCreateArray()) {
+    cls = &Class::ZoneHandle(Z, isolate()->object_store()->array_class());
+    num_elements = ArrayLengthForAllocationSinking(alloc_array);
   } else {
-    ASSERT(alloc->IsAllocateUninitializedContext());
-    mat = new (Z) MaterializeObjectInstr(
-        alloc->AsAllocateUninitializedContext(), slots, values);
+    UNREACHABLE();
   }
+  MaterializeObjectInstr* mat = new (Z) MaterializeObjectInstr(
+      alloc->AsAllocation(), *cls, num_elements, slots, values);
 
   flow_graph_->InsertBefore(exit, mat, nullptr, FlowGraph::kValue);
 
@@ -3417,6 +3586,15 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
     if ((store != NULL) && (store->instance()->definition() == alloc)) {
       AddSlot(slots, store->slot());
     }
+    StoreIndexedInstr* store_indexed = use->instruction()->AsStoreIndexed();
+    if ((store_indexed != NULL) &&
+        (store_indexed->array()->definition() == alloc)) {
+      const intptr_t index = ArrayElementStoreIndex(store_indexed);
+      ASSERT(index >= 0);
+      AddSlot(slots, Slot::GetArrayElementSlot(
+                         flow_graph_->thread(),
+                         compiler::target::Array::element_offset(index)));
+    }
   }
 
   if (auto alloc_object = alloc->AsAllocateObject()) {
@@ -3424,6 +3602,10 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
       AddSlot(slots, Slot::GetTypeArgumentsSlotFor(flow_graph_->thread(),
                                                    alloc_object->cls()));
     }
+  } else if (alloc->IsCreateArray()) {
+    AddSlot(slots, Slot::GetTypeArgumentsSlotAt(
+                       flow_graph_->thread(),
+                       compiler::target::Array::type_arguments_offset()));
   }
 
   // Collect all instructions that mention this object in the environment.
@@ -19,10 +19,26 @@ class CSEInstructionMap;
 class AllocationSinking : public ZoneAllocated {
  public:
   explicit AllocationSinking(FlowGraph* flow_graph)
-      : flow_graph_(flow_graph), candidates_(5), materializations_(5) {}
+      : flow_graph_(flow_graph),
+        candidates_(5),
+        materializations_(5),
+        num_eliminated_objects_(0),
+        num_eliminated_closures_(0),
+        num_eliminated_arrays_(0),
+        num_eliminated_contexts_(0) {}
 
   const GrowableArray<Definition*>& candidates() const { return candidates_; }
 
+  // Number of allocations of each kind removed from the graph by Optimize.
+  intptr_t num_eliminated_objects() const { return num_eliminated_objects_; }
+  intptr_t num_eliminated_closures() const { return num_eliminated_closures_; }
+  intptr_t num_eliminated_arrays() const { return num_eliminated_arrays_; }
+  intptr_t num_eliminated_contexts() const { return num_eliminated_contexts_; }
+  intptr_t NumEliminated() const {
+    return num_eliminated_objects_ + num_eliminated_closures_ +
+           num_eliminated_arrays_ + num_eliminated_contexts_;
+  }
+
   // Find the materialization inserted for the given allocation
   // at the given exit.
   MaterializeObjectInstr* MaterializationFor(Definition* alloc,
@@ -81,6 +97,11 @@ class AllocationSinking : public ZoneAllocated {
   GrowableArray<MaterializeObjectInstr*> materializations_;
 
   ExitsCollector exits_collector_;
+
+  intptr_t num_eliminated_objects_;
+  intptr_t num_eliminated_closures_;
+  intptr_t num_eliminated_arrays_;
+  intptr_t num_eliminated_contexts_;
 };
 
 // A simple common subexpression elimination based
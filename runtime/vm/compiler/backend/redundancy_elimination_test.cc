@@ -1114,4 +1114,248 @@ ISOLATE_UNIT_TEST_CASE(LoadOptimizer_RedundantInitializerCallInLoop) {
   EXPECT(load_field_in_loop2->calls_initializer());
 }
 
+// Builds the following graph and runs allocation sinking on it:
+//
+// B0[graph_entry]
+// B1[function_entry]:
+//   v0 <- CreateArray(null, 2)
+//   StoreIndexed(v0, 0, 1)
+//   StoreIndexed(v0, 1, 2)
+//   v1 <- LoadIndexed(v0, 1)
+// #if make_it_escape
+//   Return v0
+// #else
+//   Return v1
+// #endif
+static void TestAllocationSinkingOfArray(Thread* thread, bool make_it_escape) {
+  using compiler::BlockBuilder;
+  CompilerState S(thread, /*is_aot=*/false);
+  FlowGraphBuilderHelper H;
+
+  const intptr_t kIndexScale =
+      compiler::target::Instance::ElementSizeFor(kArrayCid);
+
+  auto b1 = H.flow_graph()->graph_entry()->normal_entry();
+  CreateArrayInstr* v0;
+  LoadIndexedInstr* v1;
+  ReturnInstr* ret;
+
+  {
+    BlockBuilder builder(H.flow_graph(), b1);
+    v0 = builder.AddDefinition(new CreateArrayInstr(
+        TokenPosition::kNoSource, new Value(H.flow_graph()->constant_null()),
+        new Value(H.IntConstant(2)), S.GetNextDeoptId()));
+    for (intptr_t i = 0; i < 2; i++) {
+      builder.AddInstruction(new StoreIndexedInstr(
+          new Value(v0), new Value(H.IntConstant(i)),
+          new Value(H.IntConstant(i + 1)), kEmitStoreBarrier,
+          /*index_unboxed=*/false, kIndexScale, kArrayCid, kAlignedAccess,
+          DeoptId::kNone, TokenPosition::kNoSource));
+    }
+    v1 = builder.AddDefinition(new LoadIndexedInstr(
+        new Value(v0), new Value(H.IntConstant(1)), /*index_unboxed=*/false,
+        kIndexScale, kArrayCid, kAlignedAccess, DeoptId::kNone,
+        TokenPosition::kNoSource));
+    Definition* result = make_it_escape ? static_cast<Definition*>(v0) : v1;
+    ret = builder.AddInstruction(new ReturnInstr(
+        TokenPosition::kNoSource, new Value(result), S.GetNextDeoptId()));
+  }
+  H.FinishGraph();
+  DominatorBasedCSE::Optimize(H.flow_graph());
+
+  // Load from the array is forwarded regardless of escaping.
+  EXPECT_PROPERTY(v1, it.next() == nullptr && it.previous() == nullptr);
+
+  AllocationSinking sinking(H.flow_graph());
+  sinking.Optimize();
+
+  if (make_it_escape) {
+    EXPECT_EQ(0, sinking.NumEliminated());
+    EXPECT_PROPERTY(v0, it.next() != nullptr && it.previous() != nullptr);
+    EXPECT_PROPERTY(ret, it.value()->definition() == v0);
+  } else {
+    EXPECT_EQ(1, sinking.num_eliminated_arrays());
+    EXPECT_EQ(1, sinking.NumEliminated());
+    EXPECT_PROPERTY(v0, it.next() == nullptr && it.previous() == nullptr);
+    EXPECT_PROPERTY(ret, it.value()->BindsToConstant() &&
+                             it.value()->BoundConstant().raw() ==
+                                 Smi::New(2));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_Array) {
+  TestAllocationSinkingOfArray(thread, /*make_it_escape=*/false);
+}
+
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_Array_Escape) {
+  TestAllocationSinkingOfArray(thread, /*make_it_escape=*/true);
+}
+
+// Attaches an environment which mentions [defn] to [instr], replacing the
+// dummy environment added by BlockBuilder.
+static void SetEnvironmentMentioning(FlowGraph* flow_graph,
+                                     Instruction* instr,
+                                     Definition* defn) {
+  GrowableArray<Definition*> definitions;
+  definitions.Add(defn);
+  Environment* env = Environment::From(Thread::Current()->zone(), definitions,
+                                       0, flow_graph->parsed_function());
+  instr->SetEnvironment(env);
+  for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+    it.CurrentValue()->definition()->AddEnvUse(it.CurrentValue());
+  }
+}
+
+// Returns the MaterializeObject for [alloc] right before [exit], if any.
+static MaterializeObjectInstr* MaterializationBefore(Instruction* exit,
+                                                     Definition* alloc) {
+  for (Instruction* instr = exit->previous(); instr->IsMaterializeObject();
+       instr = instr->previous()) {
+    if (instr->AsMaterializeObject()->allocation() == alloc) {
+      return instr->AsMaterializeObject();
+    }
+  }
+  return nullptr;
+}
+
+// Builds the following graph and runs allocation sinking on it:
+//
+// B0[graph_entry]
+// B1[function_entry](v0)
+//   v1 <- CreateArray(null, 2)
+//   StoreIndexed(v1, 0, 1)
+//   StoreIndexed(v1, 1, 2)
+//   CheckSmi(v0) env=[v1]
+//   v2 <- LoadIndexed(v1, 1)
+//   Return v2
+//
+// The array does not escape, but it is still needed when CheckSmi
+// deoptimizes, so it has to be rebuilt there from its elements.
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_Array_Materialization) {
+  using compiler::BlockBuilder;
+  CompilerState S(thread, /*is_aot=*/false);
+  FlowGraphBuilderHelper H;
+
+  const intptr_t kIndexScale =
+      compiler::target::Instance::ElementSizeFor(kArrayCid);
+
+  auto b1 = H.flow_graph()->graph_entry()->normal_entry();
+  CreateArrayInstr* v1;
+  CheckSmiInstr* check;
+  LoadIndexedInstr* v2;
+  ReturnInstr* ret;
+
+  {
+    BlockBuilder builder(H.flow_graph(), b1);
+    Definition* v0 = builder.AddParameter(0, 0, /*with_frame=*/true, kTagged);
+    v1 = builder.AddDefinition(new CreateArrayInstr(
+        TokenPosition::kNoSource, new Value(H.flow_graph()->constant_null()),
+        new Value(H.IntConstant(2)), S.GetNextDeoptId()));
+    for (intptr_t i = 0; i < 2; i++) {
+      builder.AddInstruction(new StoreIndexedInstr(
+          new Value(v1), new Value(H.IntConstant(i)),
+          new Value(H.IntConstant(i + 1)), kEmitStoreBarrier,
+          /*index_unboxed=*/false, kIndexScale, kArrayCid, kAlignedAccess,
+          DeoptId::kNone, TokenPosition::kNoSource));
+    }
+    check = builder.AddInstruction(new CheckSmiInstr(
+        new Value(v0), S.GetNextDeoptId(), TokenPosition::kNoSource));
+    v2 = builder.AddDefinition(new LoadIndexedInstr(
+        new Value(v1), new Value(H.IntConstant(1)), /*index_unboxed=*/false,
+        kIndexScale, kArrayCid, kAlignedAccess, DeoptId::kNone,
+        TokenPosition::kNoSource));
+    ret = builder.AddInstruction(new ReturnInstr(
+        TokenPosition::kNoSource, new Value(v2), S.GetNextDeoptId()));
+  }
+  H.FinishGraph();
+  SetEnvironmentMentioning(H.flow_graph(), check, v1);
+  DominatorBasedCSE::Optimize(H.flow_graph());
+
+  AllocationSinking sinking(H.flow_graph());
+  sinking.Optimize();
+
+  EXPECT_EQ(1, sinking.num_eliminated_arrays());
+  EXPECT_PROPERTY(v1, it.next() == nullptr && it.previous() == nullptr);
+  EXPECT_PROPERTY(ret, it.value()->BindsToConstant() &&
+                           it.value()->BoundConstant().raw() == Smi::New(2));
+
+  MaterializeObjectInstr* mat = MaterializationBefore(check, v1);
+  EXPECT(mat != nullptr);
+  if (mat == nullptr) return;
+  EXPECT(mat->cls().id() == kArrayCid);
+  EXPECT_EQ(2, mat->num_elements());
+  EXPECT(check->env()->ValueAt(0)->definition() == mat);
+
+  // Both elements and the type arguments are described by the
+  // materialization, with the values that were stored.
+  EXPECT_EQ(3, mat->InputCount());
+  bool seen_type_arguments = false;
+  bool seen_element[2] = {false, false};
+  for (intptr_t i = 0; i < mat->InputCount(); i++) {
+    const intptr_t offset = mat->FieldOffsetAt(i);
+    Value* value = mat->InputAt(i);
+    if (offset == compiler::target::Array::type_arguments_offset()) {
+      seen_type_arguments = true;
+      EXPECT(value->BindsToConstant() && value->BoundConstant().IsNull());
+      continue;
+    }
+    const intptr_t index = compiler::target::Array::index_at_offset(offset);
+    EXPECT(0 <= index && index < 2);
+    if (index < 0 || index >= 2) continue;
+    seen_element[index] = true;
+    EXPECT(value->BindsToConstant() &&
+           value->BoundConstant().raw() == Smi::New(index + 1));
+  }
+  EXPECT(seen_type_arguments);
+  EXPECT(seen_element[0] && seen_element[1]);
+}
+
+// Context allocations are not lowered in AOT mode: check that
+// AllocateContext is eliminated when the context does not escape.
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_AllocateContext) {
+  using compiler::BlockBuilder;
+  CompilerState S(thread, /*is_aot=*/true);
+  FlowGraphBuilderHelper H;
+
+  // We are going to build the following graph:
+  //
+  // B0[graph_entry]
+  // B1[function_entry]:
+  //   v0 <- AllocateContext()
+  //   StoreField(v0 . Context.parent = null)
+  //   v1 <- LoadField(v0, Context.parent)
+  //   Return v1
+
+  auto b1 = H.flow_graph()->graph_entry()->normal_entry();
+  AllocateContextInstr* v0;
+  LoadFieldInstr* v1;
+  ReturnInstr* ret;
+
+  {
+    BlockBuilder builder(H.flow_graph(), b1);
+    v0 = builder.AddDefinition(new AllocateContextInstr(
+        TokenPosition::kNoSource, *new ZoneGrowableArray<const Slot*>(0)));
+    builder.AddInstruction(new StoreInstanceFieldInstr(
+        Slot::Context_parent(), new Value(v0),
+        new Value(H.flow_graph()->constant_null()), kNoStoreBarrier,
+        TokenPosition::kNoSource,
+        StoreInstanceFieldInstr::Kind::kInitializing));
+    v1 = builder.AddDefinition(new LoadFieldInstr(
+        new Value(v0), Slot::Context_parent(), TokenPosition::kNoSource));
+    ret = builder.AddInstruction(new ReturnInstr(
+        TokenPosition::kNoSource, new Value(v1), S.GetNextDeoptId()));
+  }
+  H.FinishGraph();
+  DominatorBasedCSE::Optimize(H.flow_graph());
+
+  AllocationSinking sinking(H.flow_graph());
+  sinking.Optimize();
+
+  EXPECT_EQ(1, sinking.num_eliminated_contexts());
+  EXPECT_PROPERTY(v0, it.next() == nullptr && it.previous() == nullptr);
+  EXPECT_PROPERTY(v1, it.next() == nullptr && it.previous() == nullptr);
+  EXPECT_PROPERTY(
+      ret, it.value()->definition() == H.flow_graph()->constant_null());
+}
+
 }  // namespace dart
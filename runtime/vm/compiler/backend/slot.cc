@@ -60,6 +60,8 @@ const char* Slot::KindToCString(Kind k) {
       return "CapturedVariable";
     case Kind::kDartField:
       return "DartField";
+    case Kind::kArrayElement:
+      return "ArrayElement";
     default:
       UNREACHABLE();
       return nullptr;
@@ -87,6 +89,10 @@ bool Slot::ParseKind(const char* str, Kind* out) {
     *out = Kind::kDartField;
     return true;
   }
+  if (strcmp(str, "ArrayElement") == 0) {
+    *out = Kind::kArrayElement;
+    return true;
+  }
   return false;
 }
 
@@ -175,6 +181,14 @@ const Slot& Slot::GetTypeArgumentsIndexSlot(Thread* thread, intptr_t index) {
   return SlotCache::Instance(thread).Canonicalize(slot);
 }
 
+const Slot& Slot::GetArrayElementSlot(Thread* thread,
+                                      intptr_t offset_in_bytes) {
+  const Slot& slot =
+      Slot(Kind::kArrayElement, IsNullableBit::encode(true), kDynamicCid,
+           offset_in_bytes, ":array_element", /*static_type=*/nullptr);
+  return SlotCache::Instance(thread).Canonicalize(slot);
+}
+
 const Slot& Slot::Get(const Field& field,
                       const ParsedFunction* parsed_function) {
   Thread* thread = Thread::Current();
@@ -285,6 +299,7 @@ bool Slot::Equals(const Slot* other) const {
   switch (kind_) {
     case Kind::kTypeArguments:
     case Kind::kTypeArgumentsIndex:
+    case Kind::kArrayElement:
       return (offset_in_bytes_ == other->offset_in_bytes_);
 
     case Kind::kCapturedVariable:
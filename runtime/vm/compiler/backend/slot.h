@@ -110,6 +110,11 @@ class Slot : public ZoneAllocated {
 
     // A slot that corresponds to a Dart field (has corresponding Field object).
     kDartField,
+
+    // A slot at a specific constant offset within the elements of an Array.
+    // Only used to describe the state of dematerialized arrays (see
+    // AllocationSinking and MaterializeObjectInstr).
+    kArrayElement,
   };
   // clang-format on
 
@@ -132,6 +137,11 @@ class Slot : public ZoneAllocated {
   // Returns a slot at a specific [index] in a [RawTypeArgument] vector.
   static const Slot& GetTypeArgumentsIndexSlot(Thread* thread, intptr_t index);
 
+  // Returns a slot that represents an element of an Array at the given
+  // [offset_in_bytes].
+  static const Slot& GetArrayElementSlot(Thread* thread,
+                                         intptr_t offset_in_bytes);
+
   // Returns a slot that represents the given captured local variable.
   static const Slot& GetContextVariableSlotFor(Thread* thread,
                                                const LocalVariable& var);
@@ -154,6 +164,7 @@ class Slot : public ZoneAllocated {
   bool IsLocalVariable() const { return kind() == Kind::kCapturedVariable; }
   bool IsTypeArguments() const { return kind() == Kind::kTypeArguments; }
   bool IsArgumentOfType() const { return kind() == Kind::kTypeArgumentsIndex; }
+  bool IsArrayElement() const { return kind() == Kind::kArrayElement; }
 
   const char* Name() const;
 
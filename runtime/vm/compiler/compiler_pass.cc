@@ -22,6 +22,9 @@
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/aot/precompiler.h"
 #endif
+#include "vm/isolate.h"
+#include "vm/json_stream.h"
+#include "vm/os.h"
 #include "vm/timeline.h"
 
 #define COMPILER_PASS_REPEAT(Name, Body)                                       \
@@ -63,6 +66,11 @@ DEFINE_FLAG(bool,
             late_round_trip_serialization,
             false,
             "Perform late round trip serialization compiler pass.");
+DEFINE_FLAG(bool,
+            profile_compiler_passes,
+            false,
+            "Collect time, zone memory and IL size change of compiler passes. "
+            "Printed when the isolate group shuts down.");
 DECLARE_FLAG(bool, print_flow_graph);
 DECLARE_FLAG(bool, print_flow_graph_optimized);
 
@@ -172,6 +180,18 @@ void CompilerPass::ParseFilters(const char* filter) {
   }
 }
 
+static intptr_t CountInstructions(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      count++;
+    }
+  }
+  return count;
+}
+
 void CompilerPass::Run(CompilerPassState* state) const {
   if (IsFlagSet(kDisabled)) {
     return;
@@ -192,7 +212,30 @@ void CompilerPass::Run(CompilerPassState* state) const {
     PrintGraph(state, kTraceBefore, round);
     {
       TIMELINE_DURATION(thread, CompilerVerbose, name());
-      repeat = DoBody(state);
+      if (FLAG_profile_compiler_passes) {
+        const intptr_t instructions_before =
+            CountInstructions(state->flow_graph());
+        const uintptr_t zone_bytes_before = thread->zone()->SizeInBytes();
+        const int64_t start_micros = OS::GetCurrentMonotonicMicros();
+        repeat = DoBody(state);
+        const int64_t micros = OS::GetCurrentMonotonicMicros() - start_micros;
+        const intptr_t zone_bytes =
+            thread->zone()->SizeInBytes() - zone_bytes_before;
+        const intptr_t instructions_delta =
+            CountInstructions(state->flow_graph()) - instructions_before;
+        thread->isolate_group()->compiler_pass_stats()->Record(
+            id(), micros, zone_bytes, instructions_delta);
+#if defined(SUPPORT_TIMELINE)
+        if (tbes.enabled()) {
+          tbes.SetNumArguments(2);
+          tbes.FormatArgument(0, "zoneBytes", "%" Pd, zone_bytes);
+          tbes.FormatArgument(1, "instructionsDelta", "%" Pd,
+                              instructions_delta);
+        }
+#endif  // defined(SUPPORT_TIMELINE)
+      } else {
+        repeat = DoBody(state);
+      }
       thread->CheckForSafepoint();
     }
     PrintGraph(state, kTraceAfter, round);
@@ -503,6 +546,11 @@ COMPILER_PASS(AllocationSinking_Sink, {
   if (flow_graph->graph_entry()->catch_entries().is_empty()) {
     state->sinking = new AllocationSinking(flow_graph);
     state->sinking->Optimize();
+#if defined(DART_PRECOMPILER)
+    if (state->precompiler != nullptr) {
+      state->precompiler->RecordAllocationSinking(*state->sinking);
+    }
+#endif
   }
 });
 
@@ -579,4 +627,71 @@ COMPILER_PASS(RoundTripSerialization, {
   ASSERT(state->flow_graph() != nullptr);
 })
 
+void CompilerPassStats::Record(CompilerPass::Id id,
+                               int64_t micros,
+                               intptr_t zone_bytes,
+                               intptr_t instructions_delta) {
+  PassStats& stats = stats_[id];
+  stats.runs.fetch_add(1);
+  stats.micros.fetch_add(micros);
+  stats.zone_bytes.fetch_add(zone_bytes);
+  stats.instructions_delta.fetch_add(instructions_delta);
+}
+
+namespace {
+struct PassMicros {
+  CompilerPass::Id id;
+  int64_t micros;
+};
+}  // namespace
+
+static int MostExpensiveFirst(const PassMicros* a, const PassMicros* b) {
+  if (a->micros == b->micros) return 0;
+  return (a->micros > b->micros) ? -1 : 1;
+}
+
+void CompilerPassStats::Print(const char* name) const {
+  GrowableArray<PassMicros> passes;
+  for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+    const auto id = static_cast<CompilerPass::Id>(i);
+    if ((CompilerPass::Get(id) != nullptr) && (runs(id) > 0)) {
+      passes.Add({id, micros(id)});
+    }
+  }
+  if (passes.is_empty()) {
+    return;
+  }
+  passes.Sort(MostExpensiveFirst);
+
+  OS::PrintErr("Compiler passes of %s:\n", name);
+  OS::PrintErr("%-45s %10s %12s %14s %12s\n", "Pass", "Runs", "Time (us)",
+               "Zone (bytes)", "IL delta");
+  for (intptr_t i = 0; i < passes.length(); i++) {
+    const CompilerPass::Id id = passes[i].id;
+    OS::PrintErr("%-45s %10" Pd64 " %12" Pd64 " %14" Pd64 " %12" Pd64 "\n",
+                 CompilerPass::Get(id)->name(), runs(id), micros(id),
+                 zone_bytes(id), instructions_delta(id));
+  }
+}
+
+#ifndef PRODUCT
+void CompilerPassStats::PrintJSON(JSONStream* stream) const {
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_CompilerPassStats");
+  JSONArray passes(&jsobj, "passes");
+  for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+    const auto id = static_cast<CompilerPass::Id>(i);
+    if ((CompilerPass::Get(id) == nullptr) || (runs(id) == 0)) {
+      continue;
+    }
+    JSONObject pass(&passes);
+    pass.AddProperty("name", CompilerPass::Get(id)->name());
+    pass.AddProperty64("runs", runs(id));
+    pass.AddProperty64("micros", micros(id));
+    pass.AddProperty64("zoneBytes", zone_bytes(id));
+    pass.AddProperty64("instructionsDelta", instructions_delta(id));
+  }
+}
+#endif  // !PRODUCT
+
 }  // namespace dart
@@ -11,6 +11,7 @@
 
 #include <initializer_list>
 
+#include "platform/atomic.h"
 #include "vm/growable_array.h"
 #include "vm/token_position.h"
 #include "vm/zone.h"
@@ -59,6 +60,7 @@ class BlockScheduler;
 class CallSpecializer;
 class FlowGraph;
 class Function;
+class JSONStream;
 class Precompiler;
 class SpeculativeInliningPolicy;
 class TimelineStream;
@@ -120,7 +122,7 @@ class CompilerPass {
   static constexpr intptr_t kNumPasses = 0 COMPILER_PASS_LIST(ADD_ONE);
 #undef ADD_ONE
 
-  CompilerPass(Id id, const char* name) : name_(name), flags_(0) {
+  CompilerPass(Id id, const char* name) : id_(id), name_(name), flags_(0) {
     ASSERT(passes_[id] == NULL);
     passes_[id] = this;
 
@@ -141,6 +143,7 @@ class CompilerPass {
 
   void Run(CompilerPassState* state) const;
 
+  Id id() const { return id_; }
   intptr_t flags() const { return flags_; }
   const char* name() const { return name_; }
 
@@ -197,10 +200,55 @@ class CompilerPass {
 
   static CompilerPass* passes_[];
 
+  const Id id_;
   const char* name_;
   intptr_t flags_;
 };
 
+// Cumulative cost of each compiler pass over all compilations in an isolate
+// group, collected with --profile_compiler_passes. Updated concurrently by
+// the mutator and background compiler threads.
+//
+// Time and zone memory of a pass include passes it runs itself (e.g. the
+// inliner optimizing callee graphs).
+class CompilerPassStats {
+ public:
+  CompilerPassStats() {}
+
+  void Record(CompilerPass::Id id,
+              int64_t micros,
+              intptr_t zone_bytes,
+              intptr_t instructions_delta);
+
+  int64_t runs(CompilerPass::Id id) const { return stats_[id].runs; }
+  int64_t micros(CompilerPass::Id id) const { return stats_[id].micros; }
+  int64_t zone_bytes(CompilerPass::Id id) const {
+    return stats_[id].zone_bytes;
+  }
+  int64_t instructions_delta(CompilerPass::Id id) const {
+    return stats_[id].instructions_delta;
+  }
+
+  // Prints the passes which ran, most expensive first.
+  void Print(const char* name) const;
+
+#ifndef PRODUCT
+  void PrintJSON(JSONStream* stream) const;
+#endif
+
+ private:
+  struct PassStats {
+    RelaxedAtomic<int64_t> runs = {0};
+    RelaxedAtomic<int64_t> micros = {0};
+    RelaxedAtomic<int64_t> zone_bytes = {0};
+    RelaxedAtomic<int64_t> instructions_delta = {0};
+  };
+
+  PassStats stats_[CompilerPass::kNumPasses];
+
+  DISALLOW_COPY_AND_ASSIGN(CompilerPassStats);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILER_COMPILER_PASS_H_
@@ -0,0 +1,56 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/compiler_pass.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/flags.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, profile_compiler_passes);
+
+ISOLATE_UNIT_TEST_CASE(CompilerPass_ProfileCompilerPasses) {
+  const char* kScript = R"(
+    int foo(int x) {
+      var sum = 0;
+      for (var i = 0; i < x; i++) {
+        sum += i;
+      }
+      return sum;
+    }
+    main() => foo(10);
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  CompilerPassStats* stats = thread->isolate_group()->compiler_pass_stats();
+
+  // Nothing is recorded unless --profile_compiler_passes is set.
+  {
+    const int64_t runs_before = stats->runs(CompilerPass::kComputeSSA);
+    TestPipeline pipeline(function, CompilerPass::kJIT);
+    pipeline.RunPasses({CompilerPass::kComputeSSA});
+    EXPECT_EQ(runs_before, stats->runs(CompilerPass::kComputeSSA));
+  }
+
+  {
+    SetFlagScope<bool> sfs(&FLAG_profile_compiler_passes, true);
+    const int64_t ssa_runs = stats->runs(CompilerPass::kComputeSSA);
+    const int64_t licm_runs = stats->runs(CompilerPass::kLICM);
+    const int64_t ssa_zone_bytes = stats->zone_bytes(CompilerPass::kComputeSSA);
+    TestPipeline pipeline(function, CompilerPass::kJIT);
+    pipeline.RunPasses({
+        CompilerPass::kComputeSSA,
+        CompilerPass::kTypePropagation,
+    });
+    EXPECT_EQ(ssa_runs + 1, stats->runs(CompilerPass::kComputeSSA));
+    EXPECT_EQ(licm_runs, stats->runs(CompilerPass::kLICM));
+    EXPECT(stats->zone_bytes(CompilerPass::kComputeSSA) >= ssa_zone_bytes);
+    EXPECT(stats->micros(CompilerPass::kComputeSSA) >= 0);
+  }
+}
+
+}  // namespace dart
@@ -20,6 +20,13 @@ DEFINE_FLAG(bool,
             false,
             "Generate always trampolines (for testing purposes).");
 
+DEFINE_FLAG(bool,
+            order_code_by_usage,
+            true,
+            "Place the instructions of functions which were executed during "
+            "the profiled run (see --load_type_feedback) at the start of the "
+            "text section, most used first.");
+
 const intptr_t kTrampolineSize =
     Utils::RoundUp(PcRelativeTrampolineJumpPattern::kLengthInBytes,
                    ImageWriter::kBareInstructionsAlignment);
@@ -40,6 +47,10 @@ void CodeRelocator::Relocate(bool is_vm_isolate) {
   auto& current_caller = Code::Handle(zone);
   auto& call_targets = Array::Handle(zone);
 
+  if (FLAG_order_code_by_usage) {
+    OrderCodeObjectsByUsage();
+  }
+
   // Do one linear pass over all code objects and determine:
   //
   //    * the maximum instruction size
@@ -100,6 +111,60 @@ void CodeRelocator::Relocate(bool is_vm_isolate) {
   }
 }
 
+struct CodeUsage {
+  CodePtr code;
+  intptr_t usage;
+  intptr_t index;
+};
+
+static int MostUsedFirst(const CodeUsage* a, const CodeUsage* b) {
+  if (a->usage != b->usage) {
+    return a->usage > b->usage ? -1 : 1;
+  }
+  // Keep the discovery order among equally used code objects.
+  return a->index < b->index ? -1 : (a->index > b->index ? 1 : 0);
+}
+
+void CodeRelocator::OrderCodeObjectsByUsage() {
+  auto zone = thread_->zone();
+  auto& code = Code::Handle(zone);
+  auto& function = Function::Handle(zone);
+
+  // Usage counters are only non-zero if type feedback was loaded, in which
+  // case the executed functions are packed together to reduce i-cache and
+  // iTLB misses, and everything else is considered cold.
+  GrowableArray<CodeUsage> hot;
+  for (intptr_t i = 0; i < code_objects_->length(); ++i) {
+    code = (*code_objects_)[i];
+    if (!code.IsFunctionCode()) continue;
+    function = code.function();
+    if (function.usage_counter() > 0) {
+      hot.Add({code.raw(), function.usage_counter(), i});
+    }
+  }
+  if (hot.is_empty()) {
+    return;
+  }
+  hot.Sort(MostUsedFirst);
+
+  const intptr_t length = code_objects_->length();
+  GrowableArray<bool> is_hot(length);
+  is_hot.FillWith(false, 0, length);
+  GrowableArray<CodePtr> order(length);
+  for (const auto& entry : hot) {
+    is_hot[entry.index] = true;
+    order.Add(entry.code);
+  }
+  for (intptr_t i = 0; i < length; ++i) {
+    if (!is_hot[i]) {
+      order.Add((*code_objects_)[i]);
+    }
+  }
+  for (intptr_t i = 0; i < length; ++i) {
+    (*code_objects_)[i] = order[i];
+  }
+}
+
 void CodeRelocator::FindInstructionAndCallLimits() {
   auto zone = thread_->zone();
   auto& current_caller = Code::Handle(zone);
@@ -161,6 +161,10 @@ class CodeRelocator : public StackResource {
 
   void Relocate(bool is_vm_isolate);
 
+  // Moves code of functions with a positive usage counter to the front of
+  // [code_objects_], ordered by decreasing usage.
+  void OrderCodeObjectsByUsage();
+
   void FindInstructionAndCallLimits();
 
   bool AddInstructionsToText(CodePtr code);
@@ -200,7 +204,7 @@ class CodeRelocator : public StackResource {
   NoSafepointScope no_savepoint_scope_;
   Thread* thread_;
 
-  const GrowableArray<CodePtr>* code_objects_;
+  GrowableArray<CodePtr>* code_objects_;
   GrowableArray<ImageWriterCommand>* commands_;
 
   // The size of largest instructions object in bytes.
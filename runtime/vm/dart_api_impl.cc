@@ -1531,6 +1531,18 @@ DART_EXPORT void* Dart_IsolateGroupData(Dart_Isolate isolate) {
   return reinterpret_cast<Isolate*>(isolate)->group()->embedder_data();
 }
 
+DART_EXPORT Dart_Handle Dart_SaveIsolateGroupTemplate() {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  DARTSCOPE(Thread::Current());
+  T->isolate_group()->SaveFieldTableTemplate(T);
+  return Api::Success();
+#else
+  return Api::NewError(
+      "%s: Isolate templates are only supported in precompiled mode.",
+      CURRENT_FUNC);
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
 DART_EXPORT Dart_Handle Dart_DebugName() {
   DARTSCOPE(Thread::Current());
   Isolate* I = T->isolate();
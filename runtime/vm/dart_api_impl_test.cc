@@ -3979,6 +3979,13 @@ TEST_CASE(DartAPI_IsolateServiceID) {
   free(const_cast<char*>(id));
 }
 
+// The precompiled runtime is covered by
+// runtime/tests/vm/dart/isolates/spawn_from_template_test.dart.
+TEST_CASE(DartAPI_SaveIsolateGroupTemplate) {
+  EXPECT_ERROR(Dart_SaveIsolateGroupTemplate(),
+               "only supported in precompiled mode");
+}
+
 static void MyMessageNotifyCallback(Dart_Isolate dest_isolate) {}
 
 VM_UNIT_TEST_CASE(DartAPI_SetMessageCallbacks) {
@@ -6937,6 +6944,110 @@ TEST_CASE(DartAPI_PostCObject_DoesNotRunFinalizerOnFailure) {
   free(my_str);  // Never a double-free.
 }
 
+TEST_CASE(DartAPI_PostCObjects_DoesNotRunFinalizerOnFailure) {
+  char* my_str =
+      Utils::StrDup("Ownership of this memory remains with the caller");
+
+  Dart_CObject external;
+  external.type = Dart_CObject_kExternalTypedData;
+  external.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  external.value.as_external_typed_data.length = strlen(my_str);
+  external.value.as_external_typed_data.data =
+      reinterpret_cast<uint8_t*>(my_str);
+  external.value.as_external_typed_data.peer = my_str;
+  external.value.as_external_typed_data.callback = UnreachableFinalizer;
+  Dart_CObject null_object;
+  null_object.type = Dart_CObject_kNull;
+  Dart_CObject* messages[] = {&external, &null_object, &external};
+
+  EXPECT(!Dart_PostCObjects(ILLEGAL_PORT, ARRAY_SIZE(messages), messages));
+  EXPECT(!Dart_PostCObjects(ILLEGAL_PORT, -1, messages));
+  EXPECT(!Dart_PostCObjects(ILLEGAL_PORT, 1, NULL));
+
+  free(my_str);  // Never a double-free.
+}
+
+static void FreeFinalizer(void* isolate_callback_data,
+                          Dart_WeakPersistentHandle handle,
+                          void* peer) {
+  free(peer);
+}
+
+static void NewNativePort_sendBatch(Dart_Port dest_port_id,
+                                    Dart_CObject* message) {
+  // Gets a send port message.
+  EXPECT_NOTNULL(message);
+  EXPECT_EQ(Dart_CObject_kArray, message->type);
+  EXPECT_EQ(Dart_CObject_kSendPort, message->value.as_array.values[0]->type);
+
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(malloc(3));
+  bytes[0] = 4;
+  bytes[1] = 5;
+  bytes[2] = 6;
+  Dart_CObject first;
+  first.type = Dart_CObject_kInt32;
+  first.value.as_int32 = 1;
+  Dart_CObject external;
+  external.type = Dart_CObject_kExternalTypedData;
+  external.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  external.value.as_external_typed_data.length = 3;
+  external.value.as_external_typed_data.data = bytes;
+  external.value.as_external_typed_data.peer = bytes;
+  external.value.as_external_typed_data.callback = FreeFinalizer;
+  Dart_CObject last;
+  last.type = Dart_CObject_kString;
+  last.value.as_string = const_cast<char*>("last");
+  Dart_CObject* messages[] = {&first, &external, &last};
+
+  // Post all three messages at once.
+  bool success = Dart_PostCObjects(
+      message->value.as_array.values[0]->value.as_send_port.id,
+      ARRAY_SIZE(messages), messages);
+  EXPECT(success);
+  if (!success) {
+    free(bytes);
+  }
+}
+
+TEST_CASE(DartAPI_NativePortPostCObjects) {
+  const char* kScriptChars =
+      "import 'dart:isolate';\n"
+      "void callPort(SendPort port) {\n"
+      "  var received = [];\n"
+      "  var receivePort = new RawReceivePort();\n"
+      "  var replyPort = receivePort.sendPort;\n"
+      "  port.send(<dynamic>[replyPort]);\n"
+      "  receivePort.handler = (message) {\n"
+      "    received.add(message);\n"
+      "    if (received.length == 3) {\n"
+      "      receivePort.close();\n"
+      "      throw new Exception(received);\n"
+      "    }\n"
+      "  };\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_EnterScope();
+
+  Dart_Port port_id =
+      Dart_NewNativePort("PortBatch", NewNativePort_sendBatch, true);
+  Dart_Handle send_port = Dart_NewSendPort(port_id);
+  EXPECT_VALID(send_port);
+
+  Dart_Handle dart_args[1];
+  dart_args[0] = send_port;
+  Dart_Handle result = Dart_Invoke(lib, NewString("callPort"), 1, dart_args);
+  EXPECT_VALID(result);
+  result = Dart_RunLoop();
+  EXPECT(Dart_IsError(result));
+  EXPECT(Dart_ErrorHasException(result));
+  // Messages arrive in the order they were batched.
+  EXPECT_SUBSTRING("Exception: [1, [4, 5, 6], last]\n", Dart_GetError(result));
+
+  Dart_ExitScope();
+
+  EXPECT(Dart_CloseNativePort(port_id));
+}
+
 VM_UNIT_TEST_CASE(DartAPI_NewNativePort) {
   // Create a port with a bogus handler.
   Dart_Port error_port = Dart_NewNativePort("Foo", NULL, true);
@@ -25,7 +25,10 @@ ApiMessageReader::ApiMessageReader(Message* msg)
       backward_references_(kNumInitialReferences),
       vm_isolate_references_(kNumInitialReferences),
       vm_symbol_references_(NULL),
-      finalizable_data_(msg->finalizable_data()) {}
+      finalizable_data_(msg->finalizable_data()) {
+  // Messages to native ports are never written in the clustered format.
+  ASSERT(!msg->IsClustered());
+}
 
 ApiMessageReader::~ApiMessageReader() {}
 
@@ -4731,7 +4731,7 @@ TokenPosition Debugger::FindExactTokenPosition(const Script& script,
   intptr_t col = -1;
   Zone* zone = Thread::Current()->zone();
   kernel::KernelLineStartsReader line_starts_reader(
-      TypedData::Handle(zone, script.line_starts()), zone);
+      TypedDataBase::Handle(zone, script.line_starts()), zone);
   line_starts_reader.LocationForPosition(start_of_line.value(), &line, &col);
   return TokenPosition(start_of_line.value() + (column_number - col));
 }
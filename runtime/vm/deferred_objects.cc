@@ -233,6 +233,16 @@ void DeferredObject::Create() {
     }
     object_ = &Context::ZoneHandle(Context::New(num_variables));
 
+  } else if (cls.id() == kArrayCid) {
+    const intptr_t num_elements =
+        Smi::Cast(Object::Handle(GetLength())).Value();
+    if (FLAG_trace_deoptimization_verbose) {
+      OS::PrintErr("materializing array of length %" Pd " (%" Px ", %" Pd
+                   " elements)\n",
+                   num_elements, reinterpret_cast<uword>(args_), field_count_);
+    }
+    object_ = &Array::ZoneHandle(Array::New(num_elements));
+
   } else {
     if (FLAG_trace_deoptimization_verbose) {
       OS::PrintErr("materializing instance of %s (%" Px ", %" Pd " fields)\n",
@@ -283,6 +293,32 @@ void DeferredObject::Fill() {
         }
       }
     }
+  } else if (cls.id() == kArrayCid) {
+    const Array& array = Array::Cast(*object_);
+
+    Smi& offset = Smi::Handle();
+    Object& value = Object::Handle();
+
+    for (intptr_t i = 0; i < field_count_; i++) {
+      offset ^= GetFieldOffset(i);
+      if (offset.Value() == Array::type_arguments_offset()) {
+        TypeArguments& type_args = TypeArguments::Handle();
+        type_args ^= GetValue(i);
+        array.SetTypeArguments(type_args);
+        if (FLAG_trace_deoptimization_verbose) {
+          OS::PrintErr("    array@type_args (offset %" Pd ") <- %s\n",
+                       offset.Value(), type_args.ToCString());
+        }
+      } else {
+        const intptr_t index = Array::index_at_offset(offset.Value());
+        value = GetValue(i);
+        array.SetAt(index, value);
+        if (FLAG_trace_deoptimization_verbose) {
+          OS::PrintErr("    array@%" Pd " (offset %" Pd ") <- %s\n", index,
+                       offset.Value(), value.ToCString());
+        }
+      }
+    }
   } else {
     const Instance& obj = Instance::Cast(*object_);
 
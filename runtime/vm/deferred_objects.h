@@ -201,7 +201,8 @@ class DeferredObject {
  private:
   enum {
     kClassIndex = 0,
-    kLengthIndex,  // Number of context variables for contexts, -1 otherwise.
+    kLengthIndex,  // Number of context variables for contexts,
+                   // number of elements for arrays, -1 otherwise.
     kFieldsStartIndex
   };
 
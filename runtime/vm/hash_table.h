@@ -6,8 +6,13 @@
 #define RUNTIME_VM_HASH_TABLE_H_
 
 #include "platform/assert.h"
+#include "platform/thread_sanitizer.h"
 #include "vm/object.h"
 
+#if defined(HOST_ARCH_IA32) || defined(HOST_ARCH_X64)
+#include <emmintrin.h>
+#endif
+
 namespace dart {
 
 // OVERVIEW:
@@ -62,6 +67,13 @@ namespace dart {
 // Each entry contains a key, followed by zero or more payload components,
 // and has 3 possible states: unused, occupied, or deleted.
 // The header tracks the number of entries in each state.
+//
+// Tables with at least kMinEntriesForHashTags entries also keep a byte per
+// entry, its tag, in a separate Uint8 TypedData referenced from the header:
+// kUnusedTag for unused entries, kDeletedTag for deleted ones, and 7 bits of
+// the key's hash with the top bit set for occupied ones. The entries of such
+// tables are probed in groups of kGroupSize, comparing all tags of a group at
+// once, so that only keys whose tag matches are loaded and compared.
 // Any object except the backing storage array and Object::transition_sentinel()
 // may be stored as a key. Any object may be stored in a payload.
 //
@@ -128,6 +140,7 @@ class HashTable : public ValueObject {
     *smi_handle_ = Smi::New(0);
     data_->SetAt(kOccupiedEntriesIndex, *smi_handle_);
     data_->SetAt(kDeletedEntriesIndex, *smi_handle_);
+    InitializeHashTags();
 
 #if !defined(PRODUCT)
     data_->SetAt(kNumGrowsIndex, *smi_handle_);
@@ -149,7 +162,9 @@ class HashTable : public ValueObject {
   }
 
   // Returns the entry that matches 'key', or -1 if none exists.
-  template <typename Key>
+  // With [kAcquireKeys] the keys are loaded with acquire semantics, for
+  // lookups that run concurrently with insertions (see SymbolTable).
+  template <typename Key, bool kAcquireKeys = false>
   intptr_t FindKey(const Key& key) const {
     const intptr_t num_entries = NumEntries();
     ASSERT(NumOccupied() < num_entries);
@@ -157,14 +172,20 @@ class HashTable : public ValueObject {
     NOT_IN_PRODUCT(intptr_t collisions = 0;)
     uword hash = KeyTraits::Hash(key);
     ASSERT(Utils::IsPowerOfTwo(num_entries));
+    if (HashTags() != nullptr) {
+      intptr_t entry = -1;
+      return FindKeyInGroups<Key, kAcquireKeys>(key, hash, &entry) ? entry
+                                                                   : -1;
+    }
     intptr_t probe = hash & (num_entries - 1);
     int probe_distance = 1;
     while (true) {
-      if (IsUnused(probe)) {
+      const ObjectPtr probe_key = LoadKey<kAcquireKeys>(probe);
+      if (probe_key == UnusedMarker().raw()) {
         NOT_IN_PRODUCT(UpdateCollisions(collisions);)
         return -1;
-      } else if (!IsDeleted(probe)) {
-        *key_handle_ = GetKey(probe);
+      } else if (probe_key != DeletedMarker().raw()) {
+        *key_handle_ = probe_key;
         if (KeyTraits::IsMatch(key, *key_handle_)) {
           NOT_IN_PRODUCT(UpdateCollisions(collisions);)
           return probe;
@@ -192,6 +213,9 @@ class HashTable : public ValueObject {
     NOT_IN_PRODUCT(intptr_t collisions = 0;)
     uword hash = KeyTraits::Hash(key);
     ASSERT(Utils::IsPowerOfTwo(num_entries));
+    if (HashTags() != nullptr) {
+      return FindKeyInGroups(key, hash, entry);
+    }
     intptr_t probe = hash & (num_entries - 1);
     int probe_distance = 1;
     intptr_t deleted = -1;
@@ -234,6 +258,7 @@ class HashTable : public ValueObject {
     } else {
       ASSERT(IsUnused(entry));
     }
+    UpdateHashTag(entry, key);
     InternalSetKey(entry, key);
     ASSERT(IsOccupied(entry));
     ASSERT(NumOccupied() < NumEntries());
@@ -274,6 +299,7 @@ class HashTable : public ValueObject {
       UpdatePayload(entry, i, DeletedMarker());
     }
     InternalSetKey(entry, DeletedMarker());
+    SetHashTag(entry, kDeletedTag);
     AdjustSmiValueAt(kOccupiedEntriesIndex, -1);
     AdjustSmiValueAt(kDeletedEntriesIndex, 1);
   }
@@ -346,20 +372,153 @@ class HashTable : public ValueObject {
  protected:
   static const intptr_t kOccupiedEntriesIndex = 0;
   static const intptr_t kDeletedEntriesIndex = 1;
+  static const intptr_t kHashTagsIndex = 2;
 #if defined(PRODUCT)
-  static const intptr_t kHeaderSize = kDeletedEntriesIndex + 1;
+  static const intptr_t kHeaderSize = kHashTagsIndex + 1;
 #else
-  static const intptr_t kNumGrowsIndex = 2;
-  static const intptr_t kNumLT5LookupsIndex = 3;
-  static const intptr_t kNumLT25LookupsIndex = 4;
-  static const intptr_t kNumGT25LookupsIndex = 5;
-  static const intptr_t kNumProbesIndex = 6;
+  static const intptr_t kNumGrowsIndex = 3;
+  static const intptr_t kNumLT5LookupsIndex = 4;
+  static const intptr_t kNumLT25LookupsIndex = 5;
+  static const intptr_t kNumGT25LookupsIndex = 6;
+  static const intptr_t kNumProbesIndex = 7;
   static const intptr_t kHeaderSize = kNumProbesIndex + 1;
 #endif
   static const intptr_t kMetaDataIndex = kHeaderSize;
   static const intptr_t kFirstKeyIndex = kHeaderSize + kMetaDataSize;
   static const intptr_t kEntrySize = 1 + kPayloadSize;
 
+  static const intptr_t kGroupSize = 16;
+  static const intptr_t kMinEntriesForHashTags = 64;
+  static const uint8_t kUnusedTag = 0;
+  static const uint8_t kDeletedTag = 1;
+
+  // The tag mixes all bits of the hash, since the group is chosen by its low
+  // bits.
+  static uint8_t HashTag(uword hash) {
+    const uint32_t mixed = static_cast<uint32_t>(hash) * 0x9e3779b1u;
+    return 0x80 | (mixed >> 25);
+  }
+
+  // Returns the tags of the entries, or nullptr if the table has none.
+  // The pointer is into the heap: it must not be held across anything that
+  // may trigger a GC.
+  uint8_t* HashTags() const {
+    ObjectPtr tags = data_->At(kHashTagsIndex);
+    if (tags == Object::null()) {
+      return nullptr;
+    }
+    ASSERT(tags->IsTypedData());
+    return reinterpret_cast<uint8_t*>(ObjectLayout::ToAddr(tags) +
+                                      TypedData::data_offset());
+  }
+
+  void InitializeHashTags() const {
+    const intptr_t num_entries = NumEntries();
+    if (num_entries < kMinEntriesForHashTags) {
+      data_->SetAt(kHashTagsIndex, Object::null_object());
+      return;
+    }
+    ASSERT(Utils::IsPowerOfTwo(num_entries));
+    *key_handle_ = data_->At(kHashTagsIndex);
+    if (!key_handle_->IsTypedData() ||
+        TypedData::Cast(*key_handle_).Length() != num_entries) {
+      // Tags live in old space, so scavenges never move them.
+      *key_handle_ =
+          TypedData::New(kTypedDataUint8ArrayCid, num_entries, Heap::kOld);
+      data_->SetAt(kHashTagsIndex, *key_handle_);
+    }
+    memset(HashTags(), kUnusedTag, num_entries);
+  }
+
+  void SetHashTag(intptr_t entry, uint8_t tag) const {
+    uint8_t* tags = HashTags();
+    if (tags != nullptr) {
+      ASSERT(0 <= entry && entry < NumEntries());
+      tags[entry] = tag;
+    }
+  }
+
+  // Must be called before [key] is stored in [entry], so that concurrent
+  // lookups that see the key also see its tag.
+  void UpdateHashTag(intptr_t entry, const Object& key) const {
+    if (HashTags() != nullptr) {
+      SetHashTag(entry, HashTag(KeyTraits::Hash(key)));
+    }
+  }
+
+  // Returns a mask with bit i set if the tag of entry i of the group starting
+  // at [tags] is [tag], kUnusedTag or kDeletedTag. Tags are written without
+  // synchronization: a stale tag at most makes a lookup compare another key.
+  NO_SANITIZE_THREAD
+  static uint32_t MatchGroup(const uint8_t* tags, uint8_t tag) {
+#if defined(HOST_ARCH_IA32) || defined(HOST_ARCH_X64)
+    const __m128i group =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+    __m128i matches =
+        _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)));
+    matches = _mm_or_si128(matches,
+                           _mm_cmpeq_epi8(group, _mm_set1_epi8(kUnusedTag)));
+    matches = _mm_or_si128(matches,
+                           _mm_cmpeq_epi8(group, _mm_set1_epi8(kDeletedTag)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+#else
+    uint32_t matches = 0;
+    for (intptr_t i = 0; i < kGroupSize; i++) {
+      const uint8_t t = tags[i];
+      if (t == tag || t == kUnusedTag || t == kDeletedTag) {
+        matches |= 1u << i;
+      }
+    }
+    return matches;
+#endif
+  }
+
+  // Like FindKeyOrDeletedOrUnused, for tables with tags. The groups are
+  // probed in triangle number order, like the entries of tables without.
+  // An entry whose tag is kUnusedTag is only unused if its key is the unused
+  // marker: a concurrent lookup may see the key before the tag.
+  // The tags are reloaded for every group, since KeyTraits::IsMatch may
+  // allocate and move them.
+  template <typename Key, bool kAcquireKeys = false>
+  bool FindKeyInGroups(const Key& key, uword hash, intptr_t* entry) const {
+    const intptr_t num_groups = NumEntries() / kGroupSize;
+    const uint8_t tag = HashTag(hash);
+    NOT_IN_PRODUCT(intptr_t collisions = 0;)
+    intptr_t group = hash & (num_groups - 1);
+    intptr_t group_distance = 1;
+    intptr_t deleted = -1;
+    while (true) {
+      const intptr_t first = group * kGroupSize;
+      uint32_t matches = MatchGroup(HashTags() + first, tag);
+      while (matches != 0) {
+        const intptr_t probe = first + Utils::CountTrailingZeros32(matches);
+        matches &= matches - 1;
+        const ObjectPtr probe_key = LoadKey<kAcquireKeys>(probe);
+        if (probe_key == UnusedMarker().raw()) {
+          *entry = (deleted != -1) ? deleted : probe;
+          NOT_IN_PRODUCT(UpdateCollisions(collisions);)
+          return false;
+        } else if (probe_key == DeletedMarker().raw()) {
+          if (deleted == -1) {
+            deleted = probe;
+          }
+        } else {
+          *key_handle_ = probe_key;
+          if (KeyTraits::IsMatch(key, *key_handle_)) {
+            *entry = probe;
+            NOT_IN_PRODUCT(UpdateCollisions(collisions);)
+            return true;
+          }
+          NOT_IN_PRODUCT(collisions += 1;)
+        }
+      }
+      group = (group + group_distance) & (num_groups - 1);
+      group_distance++;
+    }
+    UNREACHABLE();
+    return false;
+  }
+
   intptr_t KeyIndex(intptr_t entry) const {
     ASSERT(0 <= entry && entry < NumEntries());
     return kFirstKeyIndex + (kEntrySize * entry);
@@ -374,6 +533,15 @@ class HashTable : public ValueObject {
     return data_->At(KeyIndex(entry));
   }
 
+  ObjectPtr InternalGetKeyAcquire(intptr_t entry) const {
+    return data_->AtAcquire(KeyIndex(entry));
+  }
+
+  template <bool kAcquireKeys>
+  ObjectPtr LoadKey(intptr_t entry) const {
+    return kAcquireKeys ? InternalGetKeyAcquire(entry) : InternalGetKey(entry);
+  }
+
   void InternalSetKey(intptr_t entry, const Object& key) const {
     data_->SetAt(KeyIndex(entry), key);
   }
@@ -402,11 +570,15 @@ class HashTable : public ValueObject {
   friend class HashTables;
 };
 
-// Table with unspecified iteration order. No payload overhead or metadata.
-template <typename KeyTraits, intptr_t kUserPayloadSize>
-class UnorderedHashTable : public HashTable<KeyTraits, kUserPayloadSize, 0> {
+// Table with unspecified iteration order. No payload overhead, and no
+// metadata unless requested.
+template <typename KeyTraits,
+          intptr_t kUserPayloadSize,
+          intptr_t kMetaDataSize = 0>
+class UnorderedHashTable
+    : public HashTable<KeyTraits, kUserPayloadSize, kMetaDataSize> {
  public:
-  typedef HashTable<KeyTraits, kUserPayloadSize, 0> BaseTable;
+  typedef HashTable<KeyTraits, kUserPayloadSize, kMetaDataSize> BaseTable;
   static const intptr_t kPayloadSize = kUserPayloadSize;
   explicit UnorderedHashTable(ArrayPtr data)
       : BaseTable(Thread::Current()->zone(), data) {}
@@ -709,10 +881,11 @@ class HashSet : public BaseIterTable {
   }
 };
 
-template <typename KeyTraits>
-class UnorderedHashSet : public HashSet<UnorderedHashTable<KeyTraits, 0> > {
+template <typename KeyTraits, intptr_t kMetaDataSize = 0>
+class UnorderedHashSet
+    : public HashSet<UnorderedHashTable<KeyTraits, 0, kMetaDataSize> > {
  public:
-  typedef HashSet<UnorderedHashTable<KeyTraits, 0> > BaseSet;
+  typedef HashSet<UnorderedHashTable<KeyTraits, 0, kMetaDataSize> > BaseSet;
   explicit UnorderedHashSet(ArrayPtr data)
       : BaseSet(Thread::Current()->zone(), data) {
     ASSERT(data != Array::null());
@@ -725,9 +898,10 @@ class UnorderedHashSet : public HashSet<UnorderedHashTable<KeyTraits, 0> > {
     Object& entry = Object::Handle();
     for (intptr_t i = 0; i < this->data_->Length(); i++) {
       entry = this->data_->At(i);
-      if (entry.raw() == BaseSet::UnusedMarker().raw() ||
-          entry.raw() == BaseSet::DeletedMarker().raw() || entry.IsSmi()) {
-        // empty, deleted, num_used/num_deleted
+      if (i < BaseSet::kFirstKeyIndex ||
+          entry.raw() == BaseSet::UnusedMarker().raw() ||
+          entry.raw() == BaseSet::DeletedMarker().raw()) {
+        // header, metadata, empty or deleted
         OS::PrintErr("%" Pd ": %s\n", i, entry.ToCString());
       } else {
         intptr_t hash = KeyTraits::Hash(entry);
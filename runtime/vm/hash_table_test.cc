@@ -113,6 +113,51 @@ ISOLATE_UNIT_TEST_CASE(HashTable) {
   table.Release();
 }
 
+// Tables with enough entries are probed by groups of hash tags.
+ISOLATE_UNIT_TEST_CASE(HashTable_HashTags) {
+  typedef HashTable<TestTraits, 1, 0> Table;
+  Table table(thread->zone(), HashTables::New<Table>(100));
+  EXPECT_LE(64, table.NumEntries());
+  const intptr_t kNumKeys = 90;
+  char buffer[16];
+  String& key = String::Handle();
+  // Most keys have one of only two lengths, so their hash codes collide.
+  for (intptr_t i = 0; i < kNumKeys; ++i) {
+    Utils::SNPrint(buffer, sizeof(buffer), "k%" Pd, i);
+    intptr_t entry = -1;
+    EXPECT(!table.FindKeyOrDeletedOrUnused(buffer, &entry));
+    key = String::New(buffer);
+    table.InsertKey(entry, key);
+  }
+  EXPECT_EQ(kNumKeys, table.NumOccupied());
+  Validate(table);
+  for (intptr_t i = 0; i < kNumKeys; i += 2) {
+    Utils::SNPrint(buffer, sizeof(buffer), "k%" Pd, i);
+    const intptr_t entry = table.FindKey(buffer);
+    EXPECT_NE(-1, entry);
+    table.DeleteEntry(entry);
+  }
+  EXPECT_EQ(kNumKeys / 2, table.NumOccupied());
+  Validate(table);
+  for (intptr_t i = 0; i < kNumKeys; ++i) {
+    Utils::SNPrint(buffer, sizeof(buffer), "k%" Pd, i);
+    if (i % 2 == 0) {
+      EXPECT_EQ(-1, table.FindKey(buffer));
+    } else {
+      EXPECT_NE(-1, table.FindKey(buffer));
+    }
+  }
+  // Deleted entries are reused.
+  intptr_t entry = -1;
+  EXPECT(!table.FindKeyOrDeletedOrUnused("k0", &entry));
+  EXPECT(table.IsDeleted(entry));
+  key = String::New("k0");
+  table.InsertKey(entry, key);
+  EXPECT_EQ(entry, table.FindKey("k0"));
+  EXPECT_EQ(-1, table.FindKey("k100"));
+  table.Release();
+}
+
 std::string ToStdString(const String& str) {
   EXPECT(str.IsOneByteString());
   std::string result;
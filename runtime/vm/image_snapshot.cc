@@ -225,6 +225,10 @@ intptr_t ImageWriter::SizeInSnapshot(ObjectPtr raw_object) {
       InstructionsPtr raw_insns = static_cast<InstructionsPtr>(raw_object);
       return InstructionsSizeInSnapshot(raw_insns);
     }
+    case kMintCid:
+      return compiler::target::Mint::InstanceSize();
+    case kDoubleCid:
+      return compiler::target::Double::InstanceSize();
     default: {
       const Class& clazz = Class::Handle(Object::Handle(raw_object).clazz());
       FATAL1("Unsupported class %s in rodata section.\n", clazz.ToCString());
@@ -518,6 +522,23 @@ void ImageWriter::WriteROData(WriteStream* stream) {
       stream->WriteTargetWord(desc.Length());
       stream->WriteBytes(desc.raw()->ptr()->data(), desc.Length());
       stream->Align(compiler::target::ObjectAlignment::kObjectAlignment);
+    } else if (obj.IsMint() || obj.IsDouble()) {
+      auto const object_start = stream->Position();
+      const intptr_t size_in_bytes = SizeInSnapshot(obj.raw());
+      marked_tags = UpdateObjectSizeForTarget(size_in_bytes, marked_tags);
+
+      stream->WriteTargetWord(marked_tags);
+      // Both values are 8-byte aligned after the header.
+      stream->Align(sizeof(int64_t));
+      ASSERT_EQUAL(stream->Position() - object_start,
+                   obj.IsMint() ? compiler::target::Mint::value_offset()
+                                : compiler::target::Double::value_offset());
+      if (obj.IsMint()) {
+        stream->WriteFixed<int64_t>(Mint::Cast(obj).value());
+      } else {
+        stream->WriteFixed<double>(Double::Cast(obj).value());
+      }
+      stream->Align(compiler::target::ObjectAlignment::kObjectAlignment);
     } else {
       const Class& clazz = Class::Handle(obj.clazz());
       FATAL1("Unsupported class %s in rodata section.\n", clazz.ToCString());
@@ -43,6 +43,16 @@ DEFINE_FLAG(uint64_t,
             interpreter_trace_file_max_bytes,
             100 * MB,
             "Maximum size in bytes of the interpreter trace file");
+DEFINE_FLAG(bool,
+            print_interpreter_bytecode_pairs,
+            false,
+            "Print the most frequently executed pairs of consecutive "
+            "bytecodes on exit (debug mode only).");
+DEFINE_FLAG(bool,
+            print_interpreter_call_site_stats,
+            false,
+            "Print statistics about the inline caches of interpreted instance "
+            "calls on exit.");
 
 // InterpreterSetjmpBuffer are linked together, and the last created one
 // is referenced by the Interpreter. When an exception is thrown, the exception
@@ -356,12 +366,109 @@ void LookupCache::Insert(intptr_t receiver_cid,
   entries_[probe1].target = target;
 }
 
+void CallSiteCache::Clear() {
+  for (intptr_t i = 0; i < kNumSites; i++) {
+    sites_[i].pc = nullptr;
+    sites_[i].num_entries = 0;
+  }
+}
+
+bool CallSiteCache::Lookup(const KBCInstr* pc,
+                           intptr_t receiver_cid,
+                           FunctionPtr* target) const {
+  ASSERT(receiver_cid != kIllegalCid);
+
+  const Site& site = sites_[IndexOf(pc)];
+  if (site.pc != pc) {
+    return false;
+  }
+  for (intptr_t i = 0; i < site.num_entries; i++) {
+    if (site.receiver_cids[i] == receiver_cid) {
+#ifndef PRODUCT
+      if (site.num_entries == 1) {
+        monomorphic_hits_++;
+      } else {
+        polymorphic_hits_++;
+      }
+#endif
+      *target = site.targets[i];
+      return true;
+    }
+  }
+  NOT_IN_PRODUCT(if (site.num_entries == kMegamorphic) megamorphic_calls_++);
+  return false;
+}
+
+void CallSiteCache::Insert(const KBCInstr* pc,
+                           intptr_t receiver_cid,
+                           FunctionPtr target) {
+  // Otherwise we have to clear the cache on scavenges too.
+  ASSERT(target->IsOldObject());
+
+  Site* site = &sites_[IndexOf(pc)];
+  if (site->pc != pc) {
+    // Another call site with the same index is evicted.
+    NOT_IN_PRODUCT(if (site->pc != nullptr) evictions_++);
+    site->pc = pc;
+    site->num_entries = 0;
+  }
+  if (site->num_entries == kMegamorphic) {
+    return;
+  }
+  NOT_IN_PRODUCT(misses_++);
+  if (site->num_entries == kMaxEntries) {
+    site->num_entries = kMegamorphic;
+    return;
+  }
+  site->receiver_cids[site->num_entries] = receiver_cid;
+  site->targets[site->num_entries] = target;
+  site->num_entries++;
+}
+
+#ifndef PRODUCT
+void CallSiteCache::PrintStats() const {
+  intptr_t monomorphic = 0;
+  intptr_t polymorphic = 0;
+  intptr_t megamorphic = 0;
+  for (intptr_t i = 0; i < kNumSites; i++) {
+    if (sites_[i].pc == nullptr) continue;
+    if (sites_[i].num_entries == kMegamorphic) {
+      megamorphic++;
+    } else if (sites_[i].num_entries > 1) {
+      polymorphic++;
+    } else {
+      monomorphic++;
+    }
+  }
+  const uint64_t calls =
+      monomorphic_hits_ + polymorphic_hits_ + megamorphic_calls_ + misses_;
+  OS::PrintErr("Interpreter call site caches:\n");
+  OS::PrintErr("  calls:              %12" Pu64 "\n", calls);
+  OS::PrintErr("  monomorphic hits:   %12" Pu64 " (%.2f%%)\n",
+               monomorphic_hits_,
+               calls == 0 ? 0.0 : 100.0 * monomorphic_hits_ / calls);
+  OS::PrintErr("  polymorphic hits:   %12" Pu64 " (%.2f%%)\n",
+               polymorphic_hits_,
+               calls == 0 ? 0.0 : 100.0 * polymorphic_hits_ / calls);
+  OS::PrintErr("  megamorphic calls:  %12" Pu64 " (%.2f%%)\n",
+               megamorphic_calls_,
+               calls == 0 ? 0.0 : 100.0 * megamorphic_calls_ / calls);
+  OS::PrintErr("  misses:             %12" Pu64 " (%.2f%%)\n", misses_,
+               calls == 0 ? 0.0 : 100.0 * misses_ / calls);
+  OS::PrintErr("  evictions:          %12" Pu64 "\n", evictions_);
+  OS::PrintErr("  live sites:         %" Pd " monomorphic, %" Pd
+               " polymorphic, %" Pd " megamorphic\n",
+               monomorphic, polymorphic, megamorphic);
+}
+#endif  // !PRODUCT
+
 Interpreter::Interpreter()
     : stack_(NULL),
       fp_(NULL),
       pp_(nullptr),
       argdesc_(nullptr),
-      lookup_cache_() {
+      lookup_cache_(),
+      call_site_cache_() {
   // Setup interpreter support first. Some of this information is needed to
   // setup the architecture state.
   // We allocate the stack here, the size is computed as the sum of
@@ -395,6 +502,8 @@ Interpreter::Interpreter()
       trace_buffer_idx_ = 0;
     }
   }
+  bytecode_pairs_ = nullptr;
+  last_opcode_ = KernelBytecode::kTrap;
 #endif
   // Make sure interpreter's unboxing view is consistent with compiler.
   supports_unboxed_doubles_ = FlowGraphCompiler::SupportsUnboxedDoubles();
@@ -402,6 +511,11 @@ Interpreter::Interpreter()
 }
 
 Interpreter::~Interpreter() {
+#ifndef PRODUCT
+  if (FLAG_print_interpreter_call_site_stats) {
+    call_site_cache_.PrintStats();
+  }
+#endif
   delete[] stack_;
   pp_ = NULL;
   argdesc_ = NULL;
@@ -417,6 +531,11 @@ Interpreter::~Interpreter() {
       trace_buffer_ = NULL;
     }
   }
+  if (bytecode_pairs_ != nullptr) {
+    PrintBytecodePairs();
+    free(bytecode_pairs_);
+    bytecode_pairs_ = nullptr;
+  }
 #endif
 }
 
@@ -490,6 +609,47 @@ DART_NOINLINE void Interpreter::WriteInstructionToTrace(const KBCInstr* pc) {
   }
 }
 
+static const intptr_t kNumOpcodes = kMaxUint8 + 1;
+
+DART_NOINLINE void Interpreter::CountBytecodePair(const KBCInstr* pc) {
+  if (bytecode_pairs_ == nullptr) {
+    bytecode_pairs_ = reinterpret_cast<uint64_t*>(
+        calloc(kNumOpcodes * kNumOpcodes, sizeof(uint64_t)));
+  }
+  const KernelBytecode::Opcode opcode = KernelBytecode::DecodeOpcode(pc);
+  bytecode_pairs_[last_opcode_ * kNumOpcodes + opcode]++;
+  last_opcode_ = opcode;
+}
+
+void Interpreter::PrintBytecodePairs() {
+  const intptr_t kNumPairsToPrint = 32;
+  uint64_t total = 0;
+  for (intptr_t i = 0; i < kNumOpcodes * kNumOpcodes; i++) {
+    total += bytecode_pairs_[i];
+  }
+  OS::PrintErr("Most frequent bytecode pairs (%" Pu64 " in total):\n", total);
+  // Repeatedly selects the most frequent remaining pair, clearing its count.
+  for (intptr_t n = 0; n < kNumPairsToPrint; n++) {
+    intptr_t best = 0;
+    for (intptr_t i = 1; i < kNumOpcodes * kNumOpcodes; i++) {
+      if (bytecode_pairs_[i] > bytecode_pairs_[best]) {
+        best = i;
+      }
+    }
+    const uint64_t count = bytecode_pairs_[best];
+    if (count == 0) {
+      break;
+    }
+    bytecode_pairs_[best] = 0;
+    OS::PrintErr("  %-24s %-24s %12" Pu64 " (%.2f%%)\n",
+                 KernelBytecode::NameOf(static_cast<KernelBytecode::Opcode>(
+                     best / kNumOpcodes)),
+                 KernelBytecode::NameOf(static_cast<KernelBytecode::Opcode>(
+                     best % kNumOpcodes)),
+                 count, 100.0 * count / total);
+  }
+}
+
 #endif  // defined(DEBUG)
 
 // Calls into the Dart runtime are based on this interface.
@@ -754,6 +914,11 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
       InterpreterHelpers::GetClassId(call_base[receiver_idx]);
 
   FunctionPtr target;
+  if (LIKELY(call_site_cache_.Lookup(*pc, receiver_cid, &target))) {
+    top[0] = target;
+    return Invoke(thread, call_base, top, pc, FP, SP);
+  }
+
   if (UNLIKELY(!lookup_cache_.Lookup(receiver_cid, target_name, argdesc_,
                                      &target))) {
     // Table lookup miss.
@@ -777,6 +942,7 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
     ASSERT(target->IsFunction());
     lookup_cache_.Insert(receiver_cid, target_name, argdesc_, target);
   }
+  call_site_cache_.Insert(*pc, receiver_cid, target);
 
   top[0] = target;
   return Invoke(thread, call_base, top, pc, FP, SP);
@@ -794,6 +960,9 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
   if (IsWritingTraceFile()) {                                                  \
     WriteInstructionToTrace(pc);                                               \
   }                                                                            \
+  if (FLAG_print_interpreter_bytecode_pairs) {                                 \
+    CountBytecodePair(pc);                                                     \
+  }                                                                            \
   icount_++;
 #else
 #define TRACE_INSTRUCTION
@@ -823,6 +992,47 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
 // Load target of a jump instruction into PC.
 #define LOAD_JUMP_TARGET() pc = rT
 
+// Superinstructions.
+//
+// The bytecode format is fixed by the front end, so frequent sequences are
+// fused at dispatch instead: a handler that is usually followed by a given
+// bytecode checks for it and continues directly in its handler. The check is
+// a well predicted branch, unlike the indirect jump it replaces. Candidate
+// pairs can be found with --print_interpreter_bytecode_pairs in debug mode.
+#define PREDICT(Name)                                                          \
+  do {                                                                         \
+    if (*pc == KernelBytecode::k##Name) {                                      \
+      op = *pc;                                                                \
+      TRACE_INSTRUCTION                                                        \
+      goto bc##Name;                                                           \
+    }                                                                          \
+  } while (0)
+
+// Stores the result of a comparison into SP[0] and dispatches. If the
+// comparison is followed by a short JumpIfTrue or JumpIfFalse, the branch is
+// taken directly on the condition kept in a register, without storing and
+// reloading a Bool on the stack.
+#define COMPARE_AND_DISPATCH(condition)                                        \
+  do {                                                                         \
+    const bool result = (condition);                                           \
+    if (*pc == KernelBytecode::kJumpIfTrue) {                                  \
+      op = *pc;                                                                \
+      TRACE_INSTRUCTION                                                        \
+      SP -= 1;                                                                 \
+      pc = result ? pc + static_cast<int8_t>(pc[1]) : pc + 2;                  \
+      DISPATCH();                                                              \
+    }                                                                          \
+    if (*pc == KernelBytecode::kJumpIfFalse) {                                 \
+      op = *pc;                                                                \
+      TRACE_INSTRUCTION                                                        \
+      SP -= 1;                                                                 \
+      pc = result ? pc + 2 : pc + static_cast<int8_t>(pc[1]);                  \
+      DISPATCH();                                                              \
+    }                                                                          \
+    SP[0] = result ? true_value : false_value;                                 \
+    DISPATCH();                                                                \
+  } while (0)
+
 #define BYTECODE_ENTRY_LABEL(Name) bc##Name:
 #define BYTECODE_WIDE_ENTRY_LABEL(Name) bc##Name##_Wide:
 #define BYTECODE_IMPL_LABEL(Name) bc##Name##Impl:
@@ -1879,6 +2089,8 @@ SwitchDispatch:
   {
     BYTECODE(Push, X);
     *++SP = FP[rX];
+    // Arguments of calls are pushed one after another.
+    PREDICT(Push);
     DISPATCH();
   }
 
@@ -2789,8 +3001,7 @@ SwitchDispatch:
   {
     BYTECODE(EqualsNull, 0);
     DEBUG_CHECK;
-    SP[0] = (SP[0] == null_value) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(SP[0] == null_value);
   }
 
   {
@@ -2960,17 +3171,18 @@ SwitchDispatch:
     BYTECODE(CompareIntEq, 0);
     DEBUG_CHECK;
     SP -= 1;
+    bool equal;
     if (SP[0] == SP[1]) {
-      SP[0] = true_value;
+      equal = true;
     } else if (!SP[0]->IsHeapObject() || !SP[1]->IsHeapObject() ||
                (SP[0] == null_value) || (SP[1] == null_value)) {
-      SP[0] = false_value;
+      equal = false;
     } else {
       int64_t a = Integer::GetInt64Value(RAW_CAST(Integer, SP[0]));
       int64_t b = Integer::GetInt64Value(RAW_CAST(Integer, SP[1]));
-      SP[0] = (a == b) ? true_value : false_value;
+      equal = (a == b);
     }
-    DISPATCH();
+    COMPARE_AND_DISPATCH(equal);
   }
 
   {
@@ -2979,8 +3191,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_INT64(a, SP[0], Symbols::RAngleBracket());
     UNBOX_INT64(b, SP[1], Symbols::RAngleBracket());
-    SP[0] = (a > b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a > b);
   }
 
   {
@@ -2989,8 +3200,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_INT64(a, SP[0], Symbols::LAngleBracket());
     UNBOX_INT64(b, SP[1], Symbols::LAngleBracket());
-    SP[0] = (a < b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a < b);
   }
 
   {
@@ -2999,8 +3209,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_INT64(a, SP[0], Symbols::GreaterEqualOperator());
     UNBOX_INT64(b, SP[1], Symbols::GreaterEqualOperator());
-    SP[0] = (a >= b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a >= b);
   }
 
   {
@@ -3009,8 +3218,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_INT64(a, SP[0], Symbols::LessEqualOperator());
     UNBOX_INT64(b, SP[1], Symbols::LessEqualOperator());
-    SP[0] = (a <= b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a <= b);
   }
 
   {
@@ -3070,14 +3278,15 @@ SwitchDispatch:
     BYTECODE(CompareDoubleEq, 0);
     DEBUG_CHECK;
     SP -= 1;
+    bool equal;
     if ((SP[0] == null_value) || (SP[1] == null_value)) {
-      SP[0] = (SP[0] == SP[1]) ? true_value : false_value;
+      equal = (SP[0] == SP[1]);
     } else {
       double a = Double::RawCast(SP[0])->ptr()->value_;
       double b = Double::RawCast(SP[1])->ptr()->value_;
-      SP[0] = (a == b) ? true_value : false_value;
+      equal = (a == b);
     }
-    DISPATCH();
+    COMPARE_AND_DISPATCH(equal);
   }
 
   {
@@ -3086,8 +3295,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_DOUBLE(a, SP[0], Symbols::RAngleBracket());
     UNBOX_DOUBLE(b, SP[1], Symbols::RAngleBracket());
-    SP[0] = (a > b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a > b);
   }
 
   {
@@ -3096,8 +3304,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_DOUBLE(a, SP[0], Symbols::LAngleBracket());
     UNBOX_DOUBLE(b, SP[1], Symbols::LAngleBracket());
-    SP[0] = (a < b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a < b);
   }
 
   {
@@ -3106,8 +3313,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_DOUBLE(a, SP[0], Symbols::GreaterEqualOperator());
     UNBOX_DOUBLE(b, SP[1], Symbols::GreaterEqualOperator());
-    SP[0] = (a >= b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a >= b);
   }
 
   {
@@ -3116,8 +3322,7 @@ SwitchDispatch:
     SP -= 1;
     UNBOX_DOUBLE(a, SP[0], Symbols::LessEqualOperator());
     UNBOX_DOUBLE(b, SP[1], Symbols::LessEqualOperator());
-    SP[0] = (a <= b) ? true_value : false_value;
-    DISPATCH();
+    COMPARE_AND_DISPATCH(a <= b);
   }
 
   {
@@ -53,6 +53,57 @@ class LookupCache : public ValueObject {
   Entry entries_[kNumEntries];
 };
 
+// Inline caches for the instance calls of interpreted code. The call sites
+// are identified by the address following their call instruction, and each
+// caches the targets of up to kMaxEntries receiver classes. Call sites with
+// more receiver classes are megamorphic and use the LookupCache instead.
+class CallSiteCache : public ValueObject {
+ public:
+  CallSiteCache() {
+    ASSERT(Utils::IsPowerOfTwo(kNumSites));
+    Clear();
+  }
+
+  void Clear();
+  bool Lookup(const KBCInstr* pc,
+              intptr_t receiver_cid,
+              FunctionPtr* target) const;
+  void Insert(const KBCInstr* pc, intptr_t receiver_cid, FunctionPtr target);
+
+#ifndef PRODUCT
+  void PrintStats() const;
+#endif
+
+ private:
+  static const intptr_t kMaxEntries = 4;
+  static const intptr_t kMegamorphic = -1;
+  static const intptr_t kNumSites = 512;
+  static const intptr_t kSiteMask = kNumSites - 1;
+
+  struct Site {
+    const KBCInstr* pc;
+    // Number of valid entries, or kMegamorphic.
+    intptr_t num_entries;
+    intptr_t receiver_cids[kMaxEntries];
+    FunctionPtr targets[kMaxEntries];
+  };
+
+  static intptr_t IndexOf(const KBCInstr* pc) {
+    const uword address = reinterpret_cast<uword>(pc);
+    return (address ^ (address >> 9)) & kSiteMask;
+  }
+
+  Site sites_[kNumSites];
+
+#ifndef PRODUCT
+  mutable uint64_t monomorphic_hits_ = 0;
+  mutable uint64_t polymorphic_hits_ = 0;
+  mutable uint64_t megamorphic_calls_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+#endif
+};
+
 // Interpreter intrinsic handler. It is invoked on entry to the intrinsified
 // function via Intrinsic bytecode before the frame is setup.
 // If the handler returns true then Intrinsic bytecode works as a return
@@ -114,7 +165,10 @@ class Interpreter {
   void Unexit(Thread* thread);
 
   void VisitObjectPointers(ObjectPointerVisitor* visitor);
-  void ClearLookupCache() { lookup_cache_.Clear(); }
+  void ClearLookupCache() {
+    lookup_cache_.Clear();
+    call_site_cache_.Clear();
+  }
 
 #ifndef PRODUCT
   void set_is_debugging(bool value) { is_debugging_ = value; }
@@ -139,6 +193,7 @@ class Interpreter {
   ObjectPtr special_[KernelBytecode::kSpecialIndexCount];
 
   LookupCache lookup_cache_;
+  CallSiteCache call_site_cache_;
 
   void Exit(Thread* thread,
             ObjectPtr* base,
@@ -254,6 +309,14 @@ class Interpreter {
       kTraceBufferSizeInBytes / sizeof(KBCInstr);
   KBCInstr* trace_buffer_;
   intptr_t trace_buffer_idx_;
+
+  // Counts how often each bytecode is directly followed by each other
+  // bytecode, to find candidates for superinstructions.
+  void CountBytecodePair(const KBCInstr* pc);
+  void PrintBytecodePairs();
+
+  uint64_t* bytecode_pairs_;
+  KernelBytecode::Opcode last_opcode_;
 #endif  // defined(DEBUG)
 
   // Longjmp support for exceptions.
@@ -32,6 +32,7 @@
 #include "vm/lockers.h"
 #include "vm/log.h"
 #include "vm/message_handler.h"
+#include "vm/message_snapshot.h"
 #include "vm/object.h"
 #include "vm/object_id_ring.h"
 #include "vm/object_store.h"
@@ -56,18 +57,23 @@
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/stub_code_compiler.h"
 #endif
 
 namespace dart {
 
 DECLARE_FLAG(bool, print_metrics);
+DECLARE_FLAG(bool, print_regexp_cache_stats);
 DECLARE_FLAG(bool, timing);
 DECLARE_FLAG(bool, trace_service);
 DECLARE_FLAG(bool, warn_on_pause_with_no_debugger);
 
 // Reload flags.
 DECLARE_FLAG(int, reload_every);
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DECLARE_FLAG(bool, profile_compiler_passes);
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 DECLARE_FLAG(bool, check_reloaded);
 DECLARE_FLAG(bool, reload_every_back_off);
@@ -141,8 +147,7 @@ static InstancePtr DeserializeMessage(Thread* thread, Message* message) {
   if (message->IsRaw()) {
     return Instance::RawCast(message->raw_obj());
   } else {
-    MessageSnapshotReader reader(message, thread);
-    const Object& obj = Object::Handle(zone, reader.ReadObject());
+    const Object& obj = Object::Handle(zone, ReadMessage(thread, message));
     ASSERT(!obj.IsError());
     return Instance::RawCast(obj.raw());
   }
@@ -305,11 +310,15 @@ IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
       store_buffer_(new StoreBuffer()),
       heap_(nullptr),
       saved_unlinked_calls_(Array::null()),
-      symbols_lock_(new SafepointRwLock()),
+      regexp_cache_(Array::null()),
+      symbols_mutex_(NOT_IN_PRODUCT("IsolateGroup::symbols_mutex_")),
       type_canonicalization_mutex_(
           NOT_IN_PRODUCT("IsolateGroup::type_canonicalization_mutex_")),
       type_arguments_canonicalization_mutex_(NOT_IN_PRODUCT(
           "IsolateGroup::type_arguments_canonicalization_mutex_")),
+#if !defined(DART_PRECOMPILED_RUNTIME)
+      compiler_pass_stats_(new CompilerPassStats()),
+#endif
       active_mutators_monitor_(new Monitor()),
       max_active_mutators_(Scavenger::MaxMutatorThreadCount()) {
   const bool is_vm_isolate = Dart::VmIsolateNameEquals(source_->name);
@@ -413,6 +422,17 @@ void IsolateGroup::Shutdown() {
     thread_pool_.reset();
   }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  if (FLAG_profile_compiler_passes) {
+    compiler_pass_stats_->Print(source()->name);
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+  if (FLAG_print_regexp_cache_stats) {
+    OS::PrintErr("%s: regexp cache: %" Pd " hits, %" Pd " misses\n",
+                 source()->name, regexp_cache_hits_, regexp_cache_misses_);
+  }
+
   // Wait for any pending GC tasks.
   if (heap_ != nullptr) {
     // Wait for any concurrent GC tasks to finish before shutting down.
@@ -461,6 +481,37 @@ void IsolateGroup::set_saved_unlinked_calls(const Array& saved_unlinked_calls) {
   saved_unlinked_calls_ = saved_unlinked_calls.raw();
 }
 
+void IsolateGroup::set_regexp_cache(const Array& regexp_cache) {
+  regexp_cache_ = regexp_cache.raw();
+}
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+intptr_t IsolateGroup::SaveFieldTableTemplate(Thread* thread) {
+  // Spawning isolates clone the saved table without entering a safepoint.
+  SafepointOperationScope safepoint_scope(thread);
+  FieldTable* saved_table = saved_initial_field_table();
+  FieldTable* field_table = thread->isolate()->field_table();
+  ASSERT(saved_table->NumFieldIds() == field_table->NumFieldIds());
+  Instance& value = Instance::Handle(thread->zone());
+  intptr_t num_saved = 0;
+  for (intptr_t i = 0; i < field_table->NumFieldIds(); i++) {
+    value = field_table->At(i);
+    if (value.raw() == saved_table->At(i) ||
+        value.raw() == Object::sentinel().raw() ||
+        value.raw() == Object::transition_sentinel().raw()) {
+      continue;
+    }
+    // Mutable state must not be shared between the isolates of a group.
+    if (!IsDeeplyImmutable(this, value)) {
+      continue;
+    }
+    saved_table->SetAt(i, value.raw());
+    num_saved++;
+  }
+  return num_saved;
+}
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
 Thread* IsolateGroup::ScheduleThreadLocked(MonitorLocker* ml,
                                            Thread* existing_mutator_thread,
                                            bool is_vm_isolate,
@@ -711,6 +762,16 @@ void IsolateGroup::PrintMemoryUsageJSON(JSONStream* stream) {
   jsobj.AddProperty64("heapCapacity", capacity * kWordSize);
   jsobj.AddProperty64("externalUsage", external_used * kWordSize);
 }
+
+void IsolateGroup::PrintCompilerPassStatsJSON(JSONStream* stream) {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  compiler_pass_stats_->PrintJSON(stream);
+#else
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_CompilerPassStats");
+  JSONArray passes(&jsobj, "passes");
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+}
 #endif
 
 void IsolateGroup::ForEach(std::function<void(IsolateGroup*)> action) {
@@ -1220,8 +1281,7 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
     const Object& obj = Object::Handle(zone, handle->raw());
     msg_obj = obj.raw();
   } else {
-    MessageSnapshotReader reader(message.get(), thread);
-    msg_obj = reader.ReadObject();
+    msg_obj = ReadMessage(thread, message.get());
   }
   if (msg_obj.IsError()) {
     // An error occurred while reading the message.
@@ -2831,6 +2891,7 @@ void IsolateGroup::VisitObjectPointers(ObjectPointerVisitor* visitor,
     object_store()->VisitObjectPointers(visitor);
   }
   visitor->VisitPointer(reinterpret_cast<ObjectPtr*>(&saved_unlinked_calls_));
+  visitor->VisitPointer(reinterpret_cast<ObjectPtr*>(&regexp_cache_));
   if (saved_initial_field_table() != nullptr) {
     saved_initial_field_table()->VisitObjectPointers(visitor);
   }
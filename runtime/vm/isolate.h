@@ -49,6 +49,7 @@ class ApiState;
 class BackgroundCompiler;
 class Capability;
 class CodeIndexTable;
+class CompilerPassStats;
 class Debugger;
 class DeoptContext;
 class ExternalTypedData;
@@ -275,7 +276,8 @@ class DisableIdleTimerScope : public ValueObject {
 class MutatorThreadPool : public ThreadPool {
  public:
   MutatorThreadPool(IsolateGroup* isolate_group, intptr_t max_pool_size)
-      : ThreadPool(max_pool_size), isolate_group_(isolate_group) {}
+      : ThreadPool(max_pool_size, /*use_worker_queues=*/true),
+        isolate_group_(isolate_group) {}
   virtual ~MutatorThreadPool() {}
 
  protected:
@@ -363,7 +365,7 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   StoreBuffer* store_buffer() const { return store_buffer_.get(); }
   ClassTable* class_table() const { return class_table_.get(); }
   ObjectStore* object_store() const { return object_store_.get(); }
-  SafepointRwLock* symbols_lock() { return symbols_lock_.get(); }
+  Mutex* symbols_mutex() { return &symbols_mutex_; }
   Mutex* type_canonicalization_mutex() { return &type_canonicalization_mutex_; }
   Mutex* type_arguments_canonicalization_mutex() {
     return &type_arguments_canonicalization_mutex_;
@@ -376,6 +378,10 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   Mutex* initializer_functions_mutex() { return &initializer_functions_mutex_; }
+
+  CompilerPassStats* compiler_pass_stats() const {
+    return compiler_pass_stats_.get();
+  }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
   static inline IsolateGroup* Current() {
@@ -460,6 +466,10 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   // Creates an object with the total heap memory usage statistics for this
   // isolate group.
   void PrintMemoryUsageJSON(JSONStream* stream);
+
+  // Creates an object with the cumulative cost of each compiler pass, see
+  // --profile_compiler_passes.
+  void PrintCompilerPassStatsJSON(JSONStream* stream);
 #endif
 
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
@@ -539,6 +549,15 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   ArrayPtr saved_unlinked_calls() const { return saved_unlinked_calls_; }
   void set_saved_unlinked_calls(const Array& saved_unlinked_calls);
 
+  // The CompiledRegExpCache of this group, guarded by regexp_cache_mutex().
+  Mutex* regexp_cache_mutex() { return &regexp_cache_mutex_; }
+  ArrayPtr regexp_cache() const { return regexp_cache_; }
+  void set_regexp_cache(const Array& regexp_cache);
+  intptr_t regexp_cache_hits() const { return regexp_cache_hits_; }
+  intptr_t regexp_cache_misses() const { return regexp_cache_misses_; }
+  void increment_regexp_cache_hits() { regexp_cache_hits_++; }
+  void increment_regexp_cache_misses() { regexp_cache_misses_++; }
+
   // Returns the pc -> code lookup cache object for this isolate.
   ReversePcLookupCache* reverse_pc_lookup_cache() const {
     return reverse_pc_lookup_cache_;
@@ -560,6 +579,14 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
     saved_initial_field_table_ = field_table;
   }
 
+#if defined(DART_PRECOMPILED_RUNTIME)
+  // Copies the deeply immutable static field values of the current isolate
+  // into the saved initial field table, so isolates spawned into this group
+  // afterwards start out with them instead of running their initializers.
+  // Returns the number of values copied.
+  intptr_t SaveFieldTableTemplate(Thread* thread);
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
   MutatorThreadPool* thread_pool() { return thread_pool_.get(); }
 
  private:
@@ -642,13 +669,17 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   std::unique_ptr<DispatchTable> dispatch_table_;
   ReversePcLookupCache* reverse_pc_lookup_cache_ = nullptr;
   ArrayPtr saved_unlinked_calls_;
+  ArrayPtr regexp_cache_;
+  intptr_t regexp_cache_hits_ = 0;
+  intptr_t regexp_cache_misses_ = 0;
   std::shared_ptr<FieldTable> saved_initial_field_table_;
   uint32_t isolate_group_flags_ = 0;
 
-  std::unique_ptr<SafepointRwLock> symbols_lock_;
+  Mutex symbols_mutex_;
   Mutex type_canonicalization_mutex_;
   Mutex type_arguments_canonicalization_mutex_;
   Mutex subtype_test_cache_mutex_;
+  Mutex regexp_cache_mutex_;
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   Mutex unlinked_call_map_mutex_;
@@ -656,6 +687,7 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   Mutex initializer_functions_mutex_;
+  std::unique_ptr<CompilerPassStats> compiler_pass_stats_;
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
   // Allow us to ensure the number of active mutators is limited by a maximum.
@@ -665,8 +697,9 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   intptr_t max_active_mutators_ = 0;
 };
 
-// When an isolate sends-and-exits this class represent things that it passed
-// to the beneficiary.
+// When an isolate sends-and-exits, or sends a deeply immutable message to an
+// isolate of its group, this class represent things that it passed to the
+// beneficiary by reference.
 class Bequest {
  public:
   Bequest(PersistentHandle* handle, Dart_Port beneficiary)
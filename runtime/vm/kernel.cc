@@ -21,7 +21,7 @@ namespace dart {
 namespace kernel {
 
 KernelLineStartsReader::KernelLineStartsReader(
-    const dart::TypedData& line_starts_data,
+    const dart::TypedDataBase& line_starts_data,
     dart::Zone* zone)
     : line_starts_data_(line_starts_data) {
   TypedDataElementType type = line_starts_data_.ElementType();
@@ -89,21 +89,21 @@ void KernelLineStartsReader::TokenRangeAtLine(
 }
 
 int32_t KernelLineStartsReader::KernelInt8LineStartsHelper::At(
-    const dart::TypedData& data,
+    const dart::TypedDataBase& data,
     intptr_t index) const {
-  return data.GetInt8(index);
+  return *static_cast<int8_t*>(data.DataAddr(index));
 }
 
 int32_t KernelLineStartsReader::KernelInt16LineStartsHelper::At(
-    const dart::TypedData& data,
+    const dart::TypedDataBase& data,
     intptr_t index) const {
-  return data.GetInt16(index << 1);
+  return LoadUnaligned(static_cast<int16_t*>(data.DataAddr(index << 1)));
 }
 
 int32_t KernelLineStartsReader::KernelInt32LineStartsHelper::At(
-    const dart::TypedData& data,
+    const dart::TypedDataBase& data,
     intptr_t index) const {
-  return data.GetInt32(index << 2);
+  return LoadUnaligned(static_cast<int32_t*>(data.DataAddr(index << 2)));
 }
 
 class KernelTokenPositionCollector : public KernelReaderHelper {
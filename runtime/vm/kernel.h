@@ -131,7 +131,7 @@ class Program {
 
 class KernelLineStartsReader {
  public:
-  KernelLineStartsReader(const dart::TypedData& line_starts_data,
+  KernelLineStartsReader(const dart::TypedDataBase& line_starts_data,
                          dart::Zone* zone);
 
   ~KernelLineStartsReader() { delete helper_; }
@@ -154,7 +154,8 @@ class KernelLineStartsReader {
    public:
     KernelLineStartsHelper() {}
     virtual ~KernelLineStartsHelper() {}
-    virtual int32_t At(const dart::TypedData& data, intptr_t index) const = 0;
+    virtual int32_t At(const dart::TypedDataBase& data,
+                       intptr_t index) const = 0;
 
    private:
     DISALLOW_COPY_AND_ASSIGN(KernelLineStartsHelper);
@@ -163,7 +164,7 @@ class KernelLineStartsReader {
   class KernelInt8LineStartsHelper : public KernelLineStartsHelper {
    public:
     KernelInt8LineStartsHelper() {}
-    virtual int32_t At(const dart::TypedData& data, intptr_t index) const;
+    virtual int32_t At(const dart::TypedDataBase& data, intptr_t index) const;
 
    private:
     DISALLOW_COPY_AND_ASSIGN(KernelInt8LineStartsHelper);
@@ -172,7 +173,7 @@ class KernelLineStartsReader {
   class KernelInt16LineStartsHelper : public KernelLineStartsHelper {
    public:
     KernelInt16LineStartsHelper() {}
-    virtual int32_t At(const dart::TypedData& data, intptr_t index) const;
+    virtual int32_t At(const dart::TypedDataBase& data, intptr_t index) const;
 
    private:
     DISALLOW_COPY_AND_ASSIGN(KernelInt16LineStartsHelper);
@@ -181,13 +182,13 @@ class KernelLineStartsReader {
   class KernelInt32LineStartsHelper : public KernelLineStartsHelper {
    public:
     KernelInt32LineStartsHelper() {}
-    virtual int32_t At(const dart::TypedData& data, intptr_t index) const;
+    virtual int32_t At(const dart::TypedDataBase& data, intptr_t index) const;
 
    private:
     DISALLOW_COPY_AND_ASSIGN(KernelInt32LineStartsHelper);
   };
 
-  const dart::TypedData& line_starts_data_;
+  const dart::TypedDataBase& line_starts_data_;
   KernelLineStartsHelper* helper_;
 
   DISALLOW_COPY_AND_ASSIGN(KernelLineStartsReader);
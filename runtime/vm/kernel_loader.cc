@@ -2113,7 +2113,7 @@ ScriptPtr KernelLoader::LoadScriptAt(intptr_t index,
       helper_.SourceTableImportUriFor(index, program_->binary_version());
 
   String& sources = String::Handle(Z);
-  TypedData& line_starts = TypedData::Handle(Z);
+  TypedDataBase& line_starts = TypedDataBase::Handle(Z);
 
   if (uri_to_source_table != nullptr) {
     UriToSourceTableEntry wrapper;
@@ -114,8 +114,16 @@ class Message {
   bool IsSnapshot() const { return !IsRaw() && !IsBequest(); }
   // A message whose object is an immortal object from the vm-isolate's heap.
   bool IsRaw() const { return snapshot_length_ == 0; }
-  // A message sent from sendAndExit.
+  // A message passed by reference within an isolate group: sent from
+  // sendAndExit, or deeply immutable.
   bool IsBequest() const { return snapshot_length_ == -1; }
+  // A snapshot message written in the clustered format (see
+  // message_snapshot.h) instead of by a MessageWriter.
+  bool IsClustered() const { return is_clustered_; }
+  void set_is_clustered(bool value) {
+    ASSERT(IsSnapshot());
+    is_clustered_ = value;
+  }
 
   bool RedirectToDeliveryFailurePort();
 
@@ -147,6 +155,7 @@ class Message {
   intptr_t snapshot_length_;
   MessageFinalizableData* finalizable_data_;
   Priority priority_;
+  bool is_clustered_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(Message);
 };
@@ -128,47 +128,82 @@ void MessageHandler::PostMessage(std::unique_ptr<Message> message,
 
   {
     MonitorLocker ml(&monitor_);
-    if (FLAG_trace_isolates) {
-      Isolate* source_isolate = Isolate::Current();
-      if (source_isolate != nullptr) {
-        OS::PrintErr(
-            "[>] Posting message:\n"
-            "\tlen:        %" Pd "\n\tsource:     (%" Pd64
-            ") %s\n\tdest:       %s\n"
-            "\tdest_port:  %" Pd64 "\n",
-            message->Size(), static_cast<int64_t>(source_isolate->main_port()),
-            source_isolate->name(), name(), message->dest_port());
-      } else {
-        OS::PrintErr(
-            "[>] Posting message:\n"
-            "\tlen:        %" Pd
-            "\n\tsource:     <native code>\n"
-            "\tdest:       %s\n"
-            "\tdest_port:  %" Pd64 "\n",
-            message->Size(), name(), message->dest_port());
-      }
+    saved_priority = message->priority();
+    EnqueueMessageLocked(std::move(message), before_events);
+    if (paused_for_messages_) {
+      ml.Notify();
     }
+    EnsureTaskRunningLocked();
+  }
 
-    saved_priority = message->priority();
-    if (message->IsOOB()) {
-      oob_queue_->Enqueue(std::move(message), before_events);
-    } else {
-      queue_->Enqueue(std::move(message), before_events);
+  // Invoke any custom message notification.
+  MessageNotify(saved_priority);
+}
+
+void MessageHandler::PostMessages(MessageQueue* messages) {
+  if (messages->IsEmpty()) {
+    return;
+  }
+  Message::Priority max_priority = Message::kNormalPriority;
+
+  {
+    MonitorLocker ml(&monitor_);
+    std::unique_ptr<Message> message;
+    while ((message = messages->Dequeue()) != nullptr) {
+      if (message->priority() > max_priority) {
+        max_priority = message->priority();
+      }
+      EnqueueMessageLocked(std::move(message), /*before_events=*/false);
     }
     if (paused_for_messages_) {
       ml.Notify();
     }
+    EnsureTaskRunningLocked();
+  }
+
+  // A single notification covers the whole batch.
+  MessageNotify(max_priority);
+}
 
-    if (pool_ != nullptr && !task_running_) {
-      ASSERT(!delete_me_);
-      task_running_ = true;
-      const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
-      ASSERT(launched_successfully);
+void MessageHandler::EnqueueMessageLocked(std::unique_ptr<Message> message,
+                                          bool before_events) {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  if (FLAG_trace_isolates) {
+    Isolate* source_isolate = Isolate::Current();
+    if (source_isolate != nullptr) {
+      OS::PrintErr(
+          "[>] Posting message:\n"
+          "\tlen:        %" Pd "\n\tsource:     (%" Pd64
+          ") %s\n\tdest:       %s\n"
+          "\tdest_port:  %" Pd64 "\n",
+          message->Size(), static_cast<int64_t>(source_isolate->main_port()),
+          source_isolate->name(), name(), message->dest_port());
+    } else {
+      OS::PrintErr(
+          "[>] Posting message:\n"
+          "\tlen:        %" Pd
+          "\n\tsource:     <native code>\n"
+          "\tdest:       %s\n"
+          "\tdest_port:  %" Pd64 "\n",
+          message->Size(), name(), message->dest_port());
     }
   }
 
-  // Invoke any custom message notification.
-  MessageNotify(saved_priority);
+  if (message->IsOOB()) {
+    oob_queue_->Enqueue(std::move(message), before_events);
+  } else {
+    queue_->Enqueue(std::move(message), before_events);
+  }
+}
+
+void MessageHandler::EnsureTaskRunningLocked() {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  if (pool_ != nullptr && !task_running_) {
+    ASSERT(!delete_me_);
+    task_running_ = true;
+    const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
+    ASSERT(launched_successfully);
+  }
 }
 
 std::unique_ptr<Message> MessageHandler::DequeueMessage(
@@ -174,6 +174,11 @@ class MessageHandler {
   void PostMessage(std::unique_ptr<Message> message,
                    bool before_events = false);
 
+  // Moves all messages in 'messages' onto this handler's message queues,
+  // preserving their order. The handler is locked, scheduled and notified
+  // once for the whole batch rather than once per message.
+  void PostMessages(MessageQueue* messages);
+
   // Notifies this handler that a port is being closed.
   void ClosePort(Dart_Port port);
 
@@ -217,6 +222,14 @@ class MessageHandler {
   // Called by MessageHandlerTask to process our task queue.
   void TaskCallback();
 
+  // Adds 'message' to the oob or normal queue. Requires monitor_ to be held.
+  void EnqueueMessageLocked(std::unique_ptr<Message> message,
+                            bool before_events);
+
+  // Starts a task for this handler if none is running. Requires monitor_ to
+  // be held.
+  void EnsureTaskRunningLocked();
+
   // Checks if we have a slot for idle task execution, if we have a slot
   // for idle task execution it is scheduled immediately or we wait for
   // idle expiration and then attempt to schedule the idle task.
@@ -0,0 +1,1074 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/message_snapshot.h"
+
+#include "platform/assert.h"
+#include "vm/class_id.h"
+#include "vm/dart_api_state.h"
+#include "vm/dart_entry.h"
+#include "vm/datastream.h"
+#include "vm/flags.h"
+#include "vm/growable_array.h"
+#include "vm/heap/weak_table.h"
+#include "vm/isolate.h"
+#include "vm/port.h"
+#include "vm/snapshot.h"
+#include "vm/symbols.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            clustered_messages,
+            true,
+            "Write messages between isolates in the clustered format when "
+            "their contents allow it.");
+
+DEFINE_FLAG(bool,
+            share_immutable_messages,
+            true,
+            "Pass deeply immutable messages by reference to isolates of the "
+            "same isolate group instead of copying them.");
+
+class MessageSerializer;
+class MessageDeserializer;
+
+// References are written as signed numbers: Smis are written inline as odd
+// numbers, and other objects as even numbers by their index in the reference
+// array.
+static const intptr_t kUnallocatedReference = -1;
+static const intptr_t kFirstReference = 1;
+
+// Objects shared by all isolates, which are not copied.
+static const intptr_t kNumBaseObjects = 4;
+
+static ObjectPtr BaseObject(intptr_t index) {
+  switch (index) {
+    case 0:
+      return Object::null();
+    case 1:
+      return Bool::True().raw();
+    case 2:
+      return Bool::False().raw();
+    case 3:
+      return Object::empty_array().raw();
+  }
+  UNREACHABLE();
+  return Object::null();
+}
+
+static uint8_t* malloc_allocator(uint8_t* ptr,
+                                 intptr_t old_size,
+                                 intptr_t new_size) {
+  void* new_ptr = realloc(reinterpret_cast<void*>(ptr), new_size);
+  return reinterpret_cast<uint8_t*>(new_ptr);
+}
+
+class MessageSerializationCluster : public ZoneAllocated {
+ public:
+  explicit MessageSerializationCluster(intptr_t cid) : cid_(cid) {}
+  virtual ~MessageSerializationCluster() {}
+
+  // Adds [object] to the cluster and pushes its outgoing references. Returns
+  // false if [object] cannot be written in the clustered format.
+  virtual bool Trace(MessageSerializer* s, ObjectPtr object) {
+    objects_.Add(object);
+    return true;
+  }
+
+  // Writes the information needed to allocate the cluster's objects, and the
+  // contents of objects without references. Returns false if an object
+  // cannot be written in the clustered format.
+  virtual bool WriteAlloc(MessageSerializer* s) = 0;
+
+  // Writes the references of the cluster's objects.
+  virtual void WriteFill(MessageSerializer* s) {}
+
+  intptr_t cid() const { return cid_; }
+  intptr_t num_objects() const { return objects_.length(); }
+
+ protected:
+  const intptr_t cid_;
+  GrowableArray<ObjectPtr> objects_;
+};
+
+class MessageDeserializationCluster : public ZoneAllocated {
+ public:
+  MessageDeserializationCluster() : start_index_(-1), stop_index_(-1) {}
+  virtual ~MessageDeserializationCluster() {}
+
+  // Allocates the cluster's objects and adds them to the reference array.
+  // Sets the error of the deserializer if an object cannot be allocated.
+  virtual void ReadAlloc(MessageDeserializer* d) = 0;
+
+  // Initializes the references of the cluster's objects.
+  virtual void ReadFill(MessageDeserializer* d) {}
+
+  // Completes any action that requires the whole message to be read, such as
+  // rehashing. Returns an error, or null.
+  virtual ObjectPtr PostLoad(MessageDeserializer* d) {
+    return Object::null();
+  }
+
+ protected:
+  // The range of the reference array that belongs to this cluster.
+  intptr_t start_index_;
+  intptr_t stop_index_;
+};
+
+class MessageSerializer : public ThreadStackResource {
+ public:
+  MessageSerializer(Thread* thread, bool can_send_any_object);
+  ~MessageSerializer();
+
+  // Returns nullptr if the object graph of [root] cannot be written in the
+  // clustered format.
+  std::unique_ptr<Message> Serialize(const Object& root,
+                                     Dart_Port dest_port,
+                                     Message::Priority priority);
+
+  void Push(ObjectPtr object) {
+    if (!object->IsHeapObject() || objects_.GetValueExclusive(object) != 0) {
+      return;
+    }
+    objects_.SetValueExclusive(object, kUnallocatedReference);
+    stack_.Add(object);
+  }
+
+  void AssignRef(ObjectPtr object) {
+    ASSERT(objects_.GetValueExclusive(object) == kUnallocatedReference ||
+           next_ref_index_ < kFirstReference + kNumBaseObjects);
+    objects_.SetValueExclusive(object, next_ref_index_++);
+  }
+
+  void WriteRef(ObjectPtr object) {
+    if (!object->IsHeapObject()) {
+      Write<int64_t>(Smi::Value(Smi::RawCast(object)) * 2 + 1);
+    } else {
+      const intptr_t ref = objects_.GetValueExclusive(object);
+      ASSERT(ref >= kFirstReference);
+      Write<int64_t>(ref * 2);
+    }
+  }
+
+  template <typename T>
+  void Write(T value) {
+    WriteStream::Raw<sizeof(T), T>::Write(&stream_, value);
+  }
+  void WriteUnsigned(intptr_t value) { stream_.WriteUnsigned(value); }
+  void WriteBytes(const void* addr, intptr_t len) {
+    stream_.WriteBytes(addr, len);
+  }
+
+  bool can_send_any_object() const { return can_send_any_object_; }
+
+ private:
+  MessageSerializationCluster* NewClusterForClass(intptr_t cid);
+  bool Trace(ObjectPtr object);
+
+  uint8_t* buffer_;
+  WriteStream stream_;
+  // Maps traced objects to their reference, or kUnallocatedReference.
+  WeakTable objects_;
+  GrowableArray<ObjectPtr> stack_;
+  MessageSerializationCluster** clusters_by_cid_;
+  GrowableArray<MessageSerializationCluster*> clusters_;
+  intptr_t next_ref_index_;
+  const bool can_send_any_object_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageSerializer);
+};
+
+class MessageDeserializer : public ThreadStackResource {
+ public:
+  MessageDeserializer(Thread* thread, Message* message);
+  ~MessageDeserializer() {}
+
+  // Returns the root object, or an Error.
+  ObjectPtr Deserialize();
+
+  Zone* zone() const { return thread()->zone(); }
+
+  ObjectPtr ReadRef() {
+    const int64_t value = Read<int64_t>();
+    if ((value & 1) != 0) {
+      return Smi::New(static_cast<intptr_t>(value >> 1));
+    }
+    return refs_.At(static_cast<intptr_t>(value >> 1));
+  }
+
+  template <typename T>
+  T Read() {
+    return ReadStream::Raw<sizeof(T), T>::Read(&stream_);
+  }
+  intptr_t ReadUnsigned() { return stream_.ReadUnsigned(); }
+  void ReadBytes(uint8_t* addr, intptr_t len) { stream_.ReadBytes(addr, len); }
+
+  void AssignRef(const Object& object) {
+    refs_.SetAt(next_ref_index_++, object);
+  }
+  ObjectPtr Ref(intptr_t index) const { return refs_.At(index); }
+  intptr_t next_index() const { return next_ref_index_; }
+
+  void set_error(const Object& error) { error_ = error.raw(); }
+
+ private:
+  MessageDeserializationCluster* ReadCluster(intptr_t cid);
+
+  ReadStream stream_;
+  Array& refs_;
+  Object& error_;
+  intptr_t next_ref_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageDeserializer);
+};
+
+class MintMessageSerializationCluster : public MessageSerializationCluster {
+ public:
+  MintMessageSerializationCluster() : MessageSerializationCluster(kMintCid) {}
+  ~MintMessageSerializationCluster() {}
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      MintPtr mint = Mint::RawCast(objects_[i]);
+      s->AssignRef(mint);
+      s->Write<bool>(mint->ptr()->IsCanonical());
+      s->Write<int64_t>(mint->ptr()->value_);
+    }
+    return true;
+  }
+};
+
+class MintMessageDeserializationCluster : public MessageDeserializationCluster {
+ public:
+  MintMessageDeserializationCluster() {}
+  ~MintMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    Integer& mint = Integer::Handle(d->zone());
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const bool is_canonical = d->Read<bool>();
+      const int64_t value = d->Read<int64_t>();
+      mint = is_canonical ? Integer::NewCanonical(value) : Integer::New(value);
+      d->AssignRef(mint);
+    }
+  }
+};
+
+class DoubleMessageSerializationCluster : public MessageSerializationCluster {
+ public:
+  DoubleMessageSerializationCluster()
+      : MessageSerializationCluster(kDoubleCid) {}
+  ~DoubleMessageSerializationCluster() {}
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      DoublePtr dbl = Double::RawCast(objects_[i]);
+      s->AssignRef(dbl);
+      s->Write<bool>(dbl->ptr()->IsCanonical());
+      s->Write<double>(dbl->ptr()->value_);
+    }
+    return true;
+  }
+};
+
+class DoubleMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  DoubleMessageDeserializationCluster() {}
+  ~DoubleMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    Double& dbl = Double::Handle(d->zone());
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const bool is_canonical = d->Read<bool>();
+      const double value = d->Read<double>();
+      dbl = is_canonical ? Double::NewCanonical(value) : Double::New(value);
+      d->AssignRef(dbl);
+    }
+  }
+};
+
+class OneByteStringMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  OneByteStringMessageSerializationCluster()
+      : MessageSerializationCluster(kOneByteStringCid) {}
+  ~OneByteStringMessageSerializationCluster() {}
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      OneByteStringPtr str = static_cast<OneByteStringPtr>(objects_[i]);
+      s->AssignRef(str);
+      const intptr_t length = Smi::Value(str->ptr()->length_);
+      s->WriteUnsigned(length);
+      s->Write<bool>(str->ptr()->IsCanonical());
+      s->WriteBytes(str->ptr()->data(), length);
+    }
+    return true;
+  }
+};
+
+class OneByteStringMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  OneByteStringMessageDeserializationCluster() {}
+  ~OneByteStringMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    String& str = String::Handle(d->zone());
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      const bool is_canonical = d->Read<bool>();
+      str = OneByteString::New(length, Heap::kNew);
+      {
+        NoSafepointScope no_safepoint;
+        d->ReadBytes(OneByteString::DataStart(str), length);
+      }
+      if (is_canonical) {
+        str = Symbols::New(d->thread(), str);
+      }
+      d->AssignRef(str);
+    }
+  }
+};
+
+class TwoByteStringMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  TwoByteStringMessageSerializationCluster()
+      : MessageSerializationCluster(kTwoByteStringCid) {}
+  ~TwoByteStringMessageSerializationCluster() {}
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      TwoByteStringPtr str = static_cast<TwoByteStringPtr>(objects_[i]);
+      s->AssignRef(str);
+      const intptr_t length = Smi::Value(str->ptr()->length_);
+      s->WriteUnsigned(length);
+      s->Write<bool>(str->ptr()->IsCanonical());
+      s->WriteBytes(str->ptr()->data(), length * sizeof(uint16_t));
+    }
+    return true;
+  }
+};
+
+class TwoByteStringMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  TwoByteStringMessageDeserializationCluster() {}
+  ~TwoByteStringMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    String& str = String::Handle(d->zone());
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      const bool is_canonical = d->Read<bool>();
+      str = TwoByteString::New(length, Heap::kNew);
+      {
+        NoSafepointScope no_safepoint;
+        d->ReadBytes(reinterpret_cast<uint8_t*>(TwoByteString::DataStart(str)),
+                     length * sizeof(uint16_t));
+      }
+      if (is_canonical) {
+        str = Symbols::New(d->thread(), str);
+      }
+      d->AssignRef(str);
+    }
+  }
+};
+
+class TypedDataMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  explicit TypedDataMessageSerializationCluster(intptr_t cid)
+      : MessageSerializationCluster(cid) {}
+  ~TypedDataMessageSerializationCluster() {}
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    const intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      TypedDataPtr data = static_cast<TypedDataPtr>(objects_[i]);
+      s->AssignRef(data);
+      const intptr_t length = Smi::Value(data->ptr()->length_);
+      s->WriteUnsigned(length);
+      s->WriteBytes(data->ptr()->data(), length * element_size);
+    }
+    return true;
+  }
+};
+
+class TypedDataMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  explicit TypedDataMessageDeserializationCluster(intptr_t cid) : cid_(cid) {}
+  ~TypedDataMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    TypedData& data = TypedData::Handle(d->zone());
+    const intptr_t count = d->ReadUnsigned();
+    const intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      data = TypedData::New(cid_, length);
+      {
+        NoSafepointScope no_safepoint;
+        d->ReadBytes(reinterpret_cast<uint8_t*>(data.DataAddr(0)),
+                     length * element_size);
+      }
+      d->AssignRef(data);
+    }
+  }
+
+ private:
+  const intptr_t cid_;
+};
+
+// Type arguments refer to classes by name, so each of them is written as an
+// embedded message of a MessageWriter.
+class TypeArgumentsMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  TypeArgumentsMessageSerializationCluster()
+      : MessageSerializationCluster(kTypeArgumentsCid) {}
+  ~TypeArgumentsMessageSerializationCluster() {}
+
+  bool WriteAlloc(MessageSerializer* s) {
+    TypeArguments& type_args = TypeArguments::Handle(s->thread()->zone());
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      type_args = TypeArguments::RawCast(objects_[i]);
+      s->AssignRef(type_args.raw());
+      MessageWriter writer(s->can_send_any_object());
+      std::unique_ptr<Message> message = writer.TryWriteMessage(
+          type_args, Message::kIllegalPort, Message::kNormalPriority);
+      if (message == nullptr) {
+        return false;
+      }
+      s->WriteUnsigned(message->snapshot_length());
+      s->WriteBytes(message->snapshot(), message->snapshot_length());
+    }
+    return true;
+  }
+};
+
+class TypeArgumentsMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  TypeArgumentsMessageDeserializationCluster() {}
+  ~TypeArgumentsMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    Object& type_args = Object::Handle(d->zone());
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      uint8_t* snapshot = reinterpret_cast<uint8_t*>(malloc(length));
+      d->ReadBytes(snapshot, length);
+      Message message(Message::kIllegalPort, snapshot, length, nullptr,
+                      Message::kNormalPriority);
+      MessageSnapshotReader reader(&message, d->thread());
+      type_args = reader.ReadObject();
+      if (type_args.IsError()) {
+        d->set_error(type_args);
+        return;
+      }
+      d->AssignRef(type_args);
+    }
+  }
+};
+
+class ArrayMessageSerializationCluster : public MessageSerializationCluster {
+ public:
+  explicit ArrayMessageSerializationCluster(intptr_t cid)
+      : MessageSerializationCluster(cid) {}
+  ~ArrayMessageSerializationCluster() {}
+
+  bool Trace(MessageSerializer* s, ObjectPtr object) {
+    ArrayPtr array = Array::RawCast(object);
+    // Constant lists would have to be canonicalized again.
+    if (array->ptr()->IsCanonical()) {
+      return false;
+    }
+    objects_.Add(array);
+
+    s->Push(array->ptr()->type_arguments_);
+    const intptr_t length = Smi::Value(array->ptr()->length_);
+    for (intptr_t i = 0; i < length; i++) {
+      s->Push(array->ptr()->data()[i]);
+    }
+    return true;
+  }
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ArrayPtr array = Array::RawCast(objects_[i]);
+      s->AssignRef(array);
+      s->WriteUnsigned(Smi::Value(array->ptr()->length_));
+    }
+    return true;
+  }
+
+  void WriteFill(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      ArrayPtr array = Array::RawCast(objects_[i]);
+      s->WriteRef(array->ptr()->type_arguments_);
+      const intptr_t length = Smi::Value(array->ptr()->length_);
+      for (intptr_t j = 0; j < length; j++) {
+        s->WriteRef(array->ptr()->data()[j]);
+      }
+    }
+  }
+};
+
+class ArrayMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  explicit ArrayMessageDeserializationCluster(intptr_t cid) : cid_(cid) {}
+  ~ArrayMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    Array& array = Array::Handle(d->zone());
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      if (cid_ == kImmutableArrayCid) {
+        array = ImmutableArray::New(length);
+      } else {
+        array = Array::New(length);
+      }
+      d->AssignRef(array);
+    }
+    stop_index_ = d->next_index();
+  }
+
+  void ReadFill(MessageDeserializer* d) {
+    Array& array = Array::Handle(d->zone());
+    TypeArguments& type_args = TypeArguments::Handle(d->zone());
+    Object& value = Object::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      array ^= d->Ref(id);
+      type_args ^= d->ReadRef();
+      array.SetTypeArguments(type_args);
+      const intptr_t length = array.Length();
+      for (intptr_t j = 0; j < length; j++) {
+        value = d->ReadRef();
+        array.SetAt(j, value);
+      }
+    }
+  }
+
+ private:
+  const intptr_t cid_;
+};
+
+// Only the elements are written, not the capacity of the backing array.
+class GrowableObjectArrayMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  GrowableObjectArrayMessageSerializationCluster()
+      : MessageSerializationCluster(kGrowableObjectArrayCid) {}
+  ~GrowableObjectArrayMessageSerializationCluster() {}
+
+  bool Trace(MessageSerializer* s, ObjectPtr object) {
+    GrowableObjectArrayPtr array = GrowableObjectArray::RawCast(object);
+    objects_.Add(array);
+
+    s->Push(array->ptr()->type_arguments_);
+    const intptr_t length = Smi::Value(array->ptr()->length_);
+    ObjectPtr* data = array->ptr()->data_->ptr()->data();
+    for (intptr_t i = 0; i < length; i++) {
+      s->Push(data[i]);
+    }
+    return true;
+  }
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      GrowableObjectArrayPtr array = GrowableObjectArray::RawCast(objects_[i]);
+      s->AssignRef(array);
+      s->WriteUnsigned(Smi::Value(array->ptr()->length_));
+    }
+    return true;
+  }
+
+  void WriteFill(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      GrowableObjectArrayPtr array = GrowableObjectArray::RawCast(objects_[i]);
+      s->WriteRef(array->ptr()->type_arguments_);
+      const intptr_t length = Smi::Value(array->ptr()->length_);
+      ObjectPtr* data = array->ptr()->data_->ptr()->data();
+      for (intptr_t j = 0; j < length; j++) {
+        s->WriteRef(data[j]);
+      }
+    }
+  }
+};
+
+class GrowableObjectArrayMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  GrowableObjectArrayMessageDeserializationCluster() {}
+  ~GrowableObjectArrayMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    GrowableObjectArray& array = GrowableObjectArray::Handle(d->zone());
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      array = GrowableObjectArray::New(length);
+      array.SetLength(length);
+      d->AssignRef(array);
+    }
+    stop_index_ = d->next_index();
+  }
+
+  void ReadFill(MessageDeserializer* d) {
+    GrowableObjectArray& array = GrowableObjectArray::Handle(d->zone());
+    TypeArguments& type_args = TypeArguments::Handle(d->zone());
+    Object& value = Object::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      array ^= d->Ref(id);
+      type_args ^= d->ReadRef();
+      array.SetTypeArguments(type_args);
+      const intptr_t length = array.Length();
+      for (intptr_t j = 0; j < length; j++) {
+        value = d->ReadRef();
+        array.SetAt(j, value);
+      }
+    }
+  }
+};
+
+// Only the live key/value pairs are written. The index is regenerated by
+// the maps after the message is read.
+class LinkedHashMapMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  LinkedHashMapMessageSerializationCluster()
+      : MessageSerializationCluster(kLinkedHashMapCid) {}
+  ~LinkedHashMapMessageSerializationCluster() {}
+
+  bool Trace(MessageSerializer* s, ObjectPtr object) {
+    LinkedHashMapPtr map = LinkedHashMap::RawCast(object);
+    if (map->ptr()->IsCanonical()) {
+      return false;
+    }
+    objects_.Add(map);
+
+    s->Push(map->ptr()->type_arguments_);
+    ArrayPtr data_array = map->ptr()->data_;
+    ObjectPtr* data = data_array->ptr()->data();
+    const intptr_t used_data = Smi::Value(map->ptr()->used_data_);
+    for (intptr_t i = 0; i < used_data; i += 2) {
+      if (data[i] != data_array) {
+        s->Push(data[i]);
+        s->Push(data[i + 1]);
+      }
+    }
+    return true;
+  }
+
+  bool WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      LinkedHashMapPtr map = LinkedHashMap::RawCast(objects_[i]);
+      s->AssignRef(map);
+      const intptr_t used_data = Smi::Value(map->ptr()->used_data_);
+      const intptr_t deleted_keys = Smi::Value(map->ptr()->deleted_keys_);
+      s->WriteUnsigned((used_data >> 1) - deleted_keys);
+    }
+    return true;
+  }
+
+  void WriteFill(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      LinkedHashMapPtr map = LinkedHashMap::RawCast(objects_[i]);
+      s->WriteRef(map->ptr()->type_arguments_);
+      ArrayPtr data_array = map->ptr()->data_;
+      ObjectPtr* data = data_array->ptr()->data();
+      const intptr_t used_data = Smi::Value(map->ptr()->used_data_);
+      for (intptr_t j = 0; j < used_data; j += 2) {
+        if (data[j] != data_array) {
+          s->WriteRef(data[j]);
+          s->WriteRef(data[j + 1]);
+        }
+      }
+    }
+  }
+};
+
+class LinkedHashMapMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  LinkedHashMapMessageDeserializationCluster() {}
+  ~LinkedHashMapMessageDeserializationCluster() {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    LinkedHashMap& map = LinkedHashMap::Handle(d->zone());
+    Array& data = Array::Handle(d->zone());
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t used_data = d->ReadUnsigned() << 1;
+      map = LinkedHashMap::NewUninitialized();
+      data = Array::New(Utils::Maximum(
+          Utils::RoundUpToPowerOfTwo(used_data),
+          static_cast<uintptr_t>(LinkedHashMap::kInitialIndexSize)));
+      map.SetData(data);
+      map.SetUsedData(used_data);
+      map.SetDeletedKeys(0);
+      // Prefer sentinel 0 over null for better type feedback.
+      map.SetHashMask(0);
+      d->AssignRef(map);
+    }
+    stop_index_ = d->next_index();
+  }
+
+  void ReadFill(MessageDeserializer* d) {
+    LinkedHashMap& map = LinkedHashMap::Handle(d->zone());
+    TypeArguments& type_args = TypeArguments::Handle(d->zone());
+    Array& data = Array::Handle(d->zone());
+    Object& value = Object::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      map ^= d->Ref(id);
+      type_args ^= d->ReadRef();
+      map.SetTypeArguments(type_args);
+      data = map.data();
+      const intptr_t used_data = Smi::Value(map.used_data());
+      for (intptr_t j = 0; j < used_data; j++) {
+        value = d->ReadRef();
+        data.SetAt(j, value);
+      }
+    }
+  }
+
+  ObjectPtr PostLoad(MessageDeserializer* d) {
+    const Array& maps =
+        Array::Handle(d->zone(), Array::New(stop_index_ - start_index_));
+    Object& map = Object::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      map = d->Ref(id);
+      maps.SetAt(id - start_index_, map);
+    }
+    const Library& collections_lib =
+        Library::Handle(d->zone(), Library::CollectionLibrary());
+    const Function& rehashing_function = Function::Handle(
+        d->zone(),
+        collections_lib.LookupFunctionAllowPrivate(Symbols::_rehashObjects()));
+    ASSERT(!rehashing_function.IsNull());
+    const Array& arguments = Array::Handle(d->zone(), Array::New(1));
+    arguments.SetAt(0, maps);
+    return DartEntry::InvokeFunction(rehashing_function, arguments);
+  }
+};
+
+MessageSerializer::MessageSerializer(Thread* thread, bool can_send_any_object)
+    : ThreadStackResource(thread),
+      buffer_(nullptr),
+      stream_(&buffer_, malloc_allocator, 4 * KB),
+      objects_(),
+      stack_(),
+      clusters_by_cid_(nullptr),
+      clusters_(),
+      next_ref_index_(kFirstReference),
+      can_send_any_object_(can_send_any_object) {
+  clusters_by_cid_ = new MessageSerializationCluster*[kNumPredefinedCids];
+  for (intptr_t i = 0; i < kNumPredefinedCids; i++) {
+    clusters_by_cid_[i] = nullptr;
+  }
+}
+
+MessageSerializer::~MessageSerializer() {
+  delete[] clusters_by_cid_;
+  free(buffer_);
+}
+
+MessageSerializationCluster* MessageSerializer::NewClusterForClass(
+    intptr_t cid) {
+  Zone* Z = thread()->zone();
+  if (IsTypedDataClassId(cid)) {
+    return new (Z) TypedDataMessageSerializationCluster(cid);
+  }
+  switch (cid) {
+    case kMintCid:
+      return new (Z) MintMessageSerializationCluster();
+    case kDoubleCid:
+      return new (Z) DoubleMessageSerializationCluster();
+    case kOneByteStringCid:
+      return new (Z) OneByteStringMessageSerializationCluster();
+    case kTwoByteStringCid:
+      return new (Z) TwoByteStringMessageSerializationCluster();
+    case kTypeArgumentsCid:
+      return new (Z) TypeArgumentsMessageSerializationCluster();
+    case kArrayCid:
+    case kImmutableArrayCid:
+      return new (Z) ArrayMessageSerializationCluster(cid);
+    case kGrowableObjectArrayCid:
+      return new (Z) GrowableObjectArrayMessageSerializationCluster();
+    case kLinkedHashMapCid:
+      return new (Z) LinkedHashMapMessageSerializationCluster();
+    default:
+      return nullptr;
+  }
+}
+
+bool MessageSerializer::Trace(ObjectPtr object) {
+  const intptr_t cid = object->GetClassId();
+  if (cid >= kNumPredefinedCids) {
+    return false;
+  }
+  MessageSerializationCluster* cluster = clusters_by_cid_[cid];
+  if (cluster == nullptr) {
+    cluster = NewClusterForClass(cid);
+    if (cluster == nullptr) {
+      return false;
+    }
+    clusters_by_cid_[cid] = cluster;
+    clusters_.Add(cluster);
+  }
+  return cluster->Trace(this, object);
+}
+
+std::unique_ptr<Message> MessageSerializer::Serialize(
+    const Object& root,
+    Dart_Port dest_port,
+    Message::Priority priority) {
+  NoSafepointScope no_safepoint;
+  for (intptr_t i = 0; i < kNumBaseObjects; i++) {
+    AssignRef(BaseObject(i));
+  }
+  Push(root.raw());
+  while (!stack_.is_empty()) {
+    if (!Trace(stack_.RemoveLast())) {
+      return nullptr;
+    }
+  }
+
+  intptr_t num_objects = 0;
+  for (intptr_t i = 0; i < clusters_.length(); i++) {
+    num_objects += clusters_[i]->num_objects();
+  }
+  WriteUnsigned(num_objects);
+  WriteUnsigned(clusters_.length());
+  for (intptr_t i = 0; i < clusters_.length(); i++) {
+    WriteUnsigned(clusters_[i]->cid());
+    if (!clusters_[i]->WriteAlloc(this)) {
+      return nullptr;
+    }
+  }
+  ASSERT(next_ref_index_ == kFirstReference + kNumBaseObjects + num_objects);
+  for (intptr_t i = 0; i < clusters_.length(); i++) {
+    clusters_[i]->WriteFill(this);
+  }
+  WriteRef(root.raw());
+
+  std::unique_ptr<Message> message = Message::New(
+      dest_port, buffer_, stream_.bytes_written(), nullptr, priority);
+  message->set_is_clustered(true);
+  buffer_ = nullptr;
+  return message;
+}
+
+MessageDeserializer::MessageDeserializer(Thread* thread, Message* message)
+    : ThreadStackResource(thread),
+      stream_(message->snapshot(), message->snapshot_length()),
+      refs_(Array::Handle(thread->zone())),
+      error_(Object::Handle(thread->zone())),
+      next_ref_index_(kFirstReference) {
+  ASSERT(message->IsClustered());
+}
+
+MessageDeserializationCluster* MessageDeserializer::ReadCluster(
+    intptr_t cid) {
+  Zone* Z = zone();
+  if (IsTypedDataClassId(cid)) {
+    return new (Z) TypedDataMessageDeserializationCluster(cid);
+  }
+  switch (cid) {
+    case kMintCid:
+      return new (Z) MintMessageDeserializationCluster();
+    case kDoubleCid:
+      return new (Z) DoubleMessageDeserializationCluster();
+    case kOneByteStringCid:
+      return new (Z) OneByteStringMessageDeserializationCluster();
+    case kTwoByteStringCid:
+      return new (Z) TwoByteStringMessageDeserializationCluster();
+    case kTypeArgumentsCid:
+      return new (Z) TypeArgumentsMessageDeserializationCluster();
+    case kArrayCid:
+    case kImmutableArrayCid:
+      return new (Z) ArrayMessageDeserializationCluster(cid);
+    case kGrowableObjectArrayCid:
+      return new (Z) GrowableObjectArrayMessageDeserializationCluster();
+    case kLinkedHashMapCid:
+      return new (Z) LinkedHashMapMessageDeserializationCluster();
+  }
+  FATAL1("No cluster defined for cid %" Pd, cid);
+  return nullptr;
+}
+
+ObjectPtr MessageDeserializer::Deserialize() {
+  const intptr_t num_objects = ReadUnsigned();
+  refs_ = Array::New(kFirstReference + kNumBaseObjects + num_objects);
+  Object& object = Object::Handle(zone());
+  for (intptr_t i = 0; i < kNumBaseObjects; i++) {
+    object = BaseObject(i);
+    AssignRef(object);
+  }
+
+  const intptr_t num_clusters = ReadUnsigned();
+  MessageDeserializationCluster** clusters =
+      zone()->Alloc<MessageDeserializationCluster*>(num_clusters);
+  for (intptr_t i = 0; i < num_clusters; i++) {
+    clusters[i] = ReadCluster(ReadUnsigned());
+    clusters[i]->ReadAlloc(this);
+    if (!error_.IsNull()) {
+      return error_.raw();
+    }
+  }
+  ASSERT(next_ref_index_ == refs_.Length());
+  for (intptr_t i = 0; i < num_clusters; i++) {
+    clusters[i]->ReadFill(this);
+  }
+  const Object& root = Object::Handle(zone(), ReadRef());
+
+  for (intptr_t i = 0; i < num_clusters; i++) {
+    object = clusters[i]->PostLoad(this);
+    if (object.IsError()) {
+      return object.raw();
+    }
+  }
+  return root.raw();
+}
+
+// Canonical objects and objects in the vm-isolate's heap are shared as they
+// are, like in sendAndExit.
+static bool IsSharedObject(ObjectPtr object) {
+  return !object->IsHeapObject() || object->ptr()->IsCanonical() ||
+         object->ptr()->InVMIsolateHeap();
+}
+
+bool IsDeeplyImmutable(IsolateGroup* isolate_group, const Object& obj) {
+  class ImmutableGraphVisitor : public ObjectPointerVisitor {
+   public:
+    ImmutableGraphVisitor(IsolateGroup* isolate_group,
+                          WeakTable* visited,
+                          MallocGrowableArray<ObjectPtr>* working_set)
+        : ObjectPointerVisitor(isolate_group),
+          visited_(visited),
+          working_set_(working_set) {}
+
+    void VisitPointers(ObjectPtr* from, ObjectPtr* to) {
+      for (ObjectPtr* raw = from; raw <= to; raw++) {
+        if (IsSharedObject(*raw) || visited_->GetValueExclusive(*raw) != 0) {
+          continue;
+        }
+        visited_->SetValueExclusive(*raw, 1);
+        working_set_->Add(*raw);
+      }
+    }
+
+   private:
+    WeakTable* visited_;
+    MallocGrowableArray<ObjectPtr>* working_set_;
+  };
+
+  if (IsSharedObject(obj.raw())) {
+    return true;
+  }
+  MallocGrowableArray<ObjectPtr> working_set;
+  WeakTable visited;
+  NoSafepointScope no_safepoint;
+  ImmutableGraphVisitor visitor(isolate_group, &visited, &working_set);
+  visited.SetValueExclusive(obj.raw(), 1);
+  working_set.Add(obj.raw());
+  while (!working_set.is_empty()) {
+    ObjectPtr raw = working_set.RemoveLast();
+    const intptr_t cid = raw->GetClassId();
+    if (IsStringClassId(cid) || cid == kMintCid || cid == kDoubleCid) {
+      continue;
+    }
+    // Lists made unmodifiable, for example by List.unmodifiable, are
+    // immutable if their elements are.
+    if (cid != kImmutableArrayCid) {
+      return false;
+    }
+    raw->ptr()->VisitPointers(&visitor);
+  }
+  return true;
+}
+
+std::unique_ptr<Message> WriteClusteredMessage(bool can_send_any_object,
+                                               const Object& obj,
+                                               Dart_Port dest_port,
+                                               Message::Priority priority) {
+  MessageSerializer serializer(Thread::Current(), can_send_any_object);
+  return serializer.Serialize(obj, dest_port, priority);
+}
+
+std::unique_ptr<Message> WriteMessage(bool can_send_any_object,
+                                      const Object& obj,
+                                      Dart_Port dest_port,
+                                      Message::Priority priority) {
+  Thread* thread = Thread::Current();
+  IsolateGroup* isolate_group = thread->isolate_group();
+  if (FLAG_share_immutable_messages &&
+      PortMap::IsReceiverInThisIsolateGroup(dest_port, isolate_group) &&
+      IsDeeplyImmutable(isolate_group, obj)) {
+    PersistentHandle* handle =
+        isolate_group->api_state()->AllocatePersistentHandle();
+    handle->set_raw(obj);
+    return Message::New(dest_port, new Bequest(handle, dest_port), priority);
+  }
+  if (FLAG_clustered_messages && PortMap::GetIsolate(dest_port) != nullptr) {
+    std::unique_ptr<Message> message =
+        WriteClusteredMessage(can_send_any_object, obj, dest_port, priority);
+    if (message != nullptr) {
+      return message;
+    }
+  }
+  MessageWriter writer(can_send_any_object);
+  return writer.WriteMessage(obj, dest_port, priority);
+}
+
+ObjectPtr ReadMessage(Thread* thread, Message* message) {
+  if (message->IsBequest()) {
+    return message->bequest()->handle()->raw();
+  }
+  ASSERT(message->IsSnapshot());
+  if (message->IsClustered()) {
+    MessageDeserializer deserializer(thread, message);
+    return deserializer.Deserialize();
+  }
+  MessageSnapshotReader reader(message, thread);
+  return reader.ReadObject();
+}
+
+}  // namespace dart
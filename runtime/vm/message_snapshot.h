@@ -0,0 +1,59 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_MESSAGE_SNAPSHOT_H_
+#define RUNTIME_VM_MESSAGE_SNAPSHOT_H_
+
+#include <memory>
+
+#include "vm/message.h"
+#include "vm/object.h"
+
+namespace dart {
+
+// Messages between isolates that only contain numbers, strings, lists, maps
+// and typed data are written with a clustered format like the one of full
+// snapshots (see clustered_snapshot.h): objects are grouped by class, all
+// objects are allocated before any of them is filled, and the contents of
+// strings and typed data are copied in bulk. Type arguments refer to classes
+// by name and are written by a MessageWriter.
+//
+// Other messages, and messages to native ports, which are read by an
+// ApiMessageReader, are written by a MessageWriter.
+//
+// Isolates of the same isolate group share a heap, so deeply immutable
+// messages between them are not written at all: like the result of
+// sendAndExit, they are passed by reference as a Bequest.
+
+class IsolateGroup;
+
+// Returns true if neither [obj] nor any object reachable from it can be
+// mutated: numbers, strings, canonical objects, and unmodifiable lists of
+// such objects.
+bool IsDeeplyImmutable(IsolateGroup* isolate_group, const Object& obj);
+
+// Writes [obj] in the clustered format, or returns nullptr if its object
+// graph contains objects the format does not support.
+std::unique_ptr<Message> WriteClusteredMessage(bool can_send_any_object,
+                                               const Object& obj,
+                                               Dart_Port dest_port,
+                                               Message::Priority priority);
+
+// Passes [obj] by reference if [dest_port] belongs to an isolate of the
+// current isolate group and [obj] is deeply immutable. Otherwise writes [obj]
+// in the clustered format if [dest_port] belongs to an isolate and the format
+// supports [obj], and with a MessageWriter if not.
+std::unique_ptr<Message> WriteMessage(bool can_send_any_object,
+                                      const Object& obj,
+                                      Dart_Port dest_port,
+                                      Message::Priority priority);
+
+// Returns the object of a message passed by reference, or reads the object
+// of a snapshot message written in either format. Returns an Error if the
+// message cannot be read.
+ObjectPtr ReadMessage(Thread* thread, Message* message);
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_MESSAGE_SNAPSHOT_H_
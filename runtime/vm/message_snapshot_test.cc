@@ -0,0 +1,197 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/message_snapshot.h"
+#include "platform/assert.h"
+#include "vm/dart_api_impl.h"
+#include "vm/dart_api_message.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+TEST_CASE(MessageSnapshot_ClusteredRoundTrip) {
+  const char* kScriptChars =
+      "import 'dart:typed_data';\n"
+      "build() {\n"
+      "  var map = <String, Object>{'a': 1, 'b': 'two'};\n"
+      "  map.remove('a');\n"
+      "  map['c'] = 3.5;\n"
+      "  var list = <dynamic>[null, true, false, 42, 1 << 62, 3.25,\n"
+      "      'one byte', 'two \\u{1F600}', Uint8List.fromList([1, 2, 3]),\n"
+      "      map, map, List<int>.filled(3, 7)];\n"
+      "  list.add(list);\n"
+      "  return list;\n"
+      "}\n"
+      "check(List list) {\n"
+      "  void expect(bool condition) {\n"
+      "    if (!condition) throw 'Unexpected message contents';\n"
+      "  }\n"
+      "  expect(list.length == 13);\n"
+      "  expect(list[0] == null && list[1] == true && list[2] == false);\n"
+      "  expect(list[3] == 42 && list[4] == 1 << 62 && list[5] == 3.25);\n"
+      "  expect(list[6] == 'one byte' && list[7] == 'two \\u{1F600}');\n"
+      "  var bytes = list[8] as Uint8List;\n"
+      "  expect(bytes.length == 3 && bytes[0] == 1 && bytes[2] == 3);\n"
+      "  expect(list[9] is Map<String, Object>);\n"
+      "  expect(identical(list[9], list[10]));\n"
+      "  var map = list[9];\n"
+      "  expect(map.length == 2 && !map.containsKey('a'));\n"
+      "  expect(map['b'] == 'two' && map['c'] == 3.5);\n"
+      "  expect(map.keys.first == 'b');\n"
+      "  expect(list[11] is List<int> && list[11][2] == 7);\n"
+      "  expect(identical(list[12], list));\n"
+      "  list.add(1);\n"
+      "  return true;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle original = Dart_Invoke(lib, NewString("build"), 0, NULL);
+  EXPECT_VALID(original);
+
+  Dart_Handle copy;
+  {
+    TransitionNativeToVM transition(thread);
+    const Object& obj = Object::Handle(Api::UnwrapHandle(original));
+    std::unique_ptr<Message> message = WriteClusteredMessage(
+        /* can_send_any_object = */ true, obj, ILLEGAL_PORT,
+        Message::kNormalPriority);
+    EXPECT(message != nullptr);
+    EXPECT(message->IsClustered());
+    const Object& result =
+        Object::Handle(ReadMessage(thread, message.get()));
+    EXPECT(!result.IsError());
+    EXPECT(result.raw() != obj.raw());
+    copy = Api::NewHandle(thread, result.raw());
+  }
+  Dart_Handle args[] = {copy};
+  Dart_Handle result = Dart_Invoke(lib, NewString("check"), 1, args);
+  EXPECT_TRUE(result);
+}
+
+TEST_CASE(MessageSnapshot_UnsupportedObject) {
+  const char* kScriptChars =
+      "class Point {\n"
+      "  final int x, y;\n"
+      "  Point(this.x, this.y);\n"
+      "}\n"
+      "build() => <Object>['point', Point(1, 2)];\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle original = Dart_Invoke(lib, NewString("build"), 0, NULL);
+  EXPECT_VALID(original);
+
+  TransitionNativeToVM transition(thread);
+  const Object& obj = Object::Handle(Api::UnwrapHandle(original));
+  // Instances of user classes are left to the MessageWriter.
+  std::unique_ptr<Message> message =
+      WriteClusteredMessage(/* can_send_any_object = */ true, obj,
+                            ILLEGAL_PORT, Message::kNormalPriority);
+  EXPECT(message == nullptr);
+  message = WriteMessage(/* can_send_any_object = */ true, obj, ILLEGAL_PORT,
+                         Message::kNormalPriority);
+  EXPECT(message != nullptr);
+  EXPECT(!message->IsClustered());
+  const Object& result = Object::Handle(ReadMessage(thread, message.get()));
+  EXPECT(result.IsGrowableObjectArray());
+  EXPECT_EQ(2, GrowableObjectArray::Cast(result).Length());
+}
+
+TEST_CASE(MessageSnapshot_IsDeeplyImmutable) {
+  const char* kScriptChars =
+      "import 'dart:typed_data';\n"
+      "immutable() => List.unmodifiable(<Object>['a' * 10, 1 << 62, 2.5,\n"
+      "    const [1], List.unmodifiable(['nested'])]);\n"
+      "mutableElement() => List.unmodifiable([<int>[1]]);\n"
+      "typedData() => List.unmodifiable([Uint8List(8)]);\n"
+      "string() => 'string' * 1000;\n"
+      "growable() => <String>['a'];\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  const char* kImmutable[] = {"immutable", "string"};
+  const char* kMutable[] = {"mutableElement", "typedData", "growable"};
+  Dart_Handle immutable[ARRAY_SIZE(kImmutable)];
+  Dart_Handle mutable_objects[ARRAY_SIZE(kMutable)];
+  for (size_t i = 0; i < ARRAY_SIZE(kImmutable); i++) {
+    immutable[i] = Dart_Invoke(lib, NewString(kImmutable[i]), 0, NULL);
+    EXPECT_VALID(immutable[i]);
+  }
+  for (size_t i = 0; i < ARRAY_SIZE(kMutable); i++) {
+    mutable_objects[i] = Dart_Invoke(lib, NewString(kMutable[i]), 0, NULL);
+    EXPECT_VALID(mutable_objects[i]);
+  }
+
+  TransitionNativeToVM transition(thread);
+  Object& obj = Object::Handle();
+  for (size_t i = 0; i < ARRAY_SIZE(kImmutable); i++) {
+    obj = Api::UnwrapHandle(immutable[i]);
+    EXPECT(IsDeeplyImmutable(thread->isolate_group(), obj));
+  }
+  for (size_t i = 0; i < ARRAY_SIZE(kMutable); i++) {
+    obj = Api::UnwrapHandle(mutable_objects[i]);
+    EXPECT(!IsDeeplyImmutable(thread->isolate_group(), obj));
+  }
+}
+
+static void MessageSnapshot_IgnoreMessage(Dart_Port dest_port_id,
+                                          Dart_CObject* message) {}
+
+TEST_CASE(MessageSnapshot_ImmutableToNativePort) {
+  const char* kScriptChars =
+      "string() => 'string' * 10;\n"
+      "list() => List.unmodifiable(<Object>['a' * 10, 1 << 62]);\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle string = Dart_Invoke(lib, NewString("string"), 0, NULL);
+  EXPECT_VALID(string);
+  Dart_Handle list = Dart_Invoke(lib, NewString("list"), 0, NULL);
+  EXPECT_VALID(list);
+  Dart_Port native_port = Dart_NewNativePort(
+      "MessageSnapshot", MessageSnapshot_IgnoreMessage, false);
+  EXPECT(native_port != ILLEGAL_PORT);
+  Dart_Port main_port = Dart_GetMainPortId();
+
+  {
+    TransitionNativeToVM transition(thread);
+    Object& obj = Object::Handle(Api::UnwrapHandle(string));
+    EXPECT(IsDeeplyImmutable(thread->isolate_group(), obj));
+
+    // Receivers in this isolate group get the object itself.
+    std::unique_ptr<Message> message =
+        WriteMessage(/* can_send_any_object = */ false, obj, main_port,
+                     Message::kNormalPriority);
+    EXPECT(message->IsBequest());
+
+    // Native ports have no isolate, so they get a snapshot.
+    message = WriteMessage(/* can_send_any_object = */ false, obj, native_port,
+                           Message::kNormalPriority);
+    EXPECT(message->IsSnapshot());
+    {
+      ApiNativeScope scope;
+      ApiMessageReader reader(message.get());
+      Dart_CObject* root = reader.ReadMessage();
+      EXPECT_NOTNULL(root);
+      EXPECT_EQ(Dart_CObject_kString, root->type);
+      EXPECT_STREQ("stringstringstringstringstringstringstringstringstring"
+                   "string",
+                   root->value.as_string);
+    }
+
+    obj = Api::UnwrapHandle(list);
+    message = WriteMessage(/* can_send_any_object = */ false, obj, native_port,
+                           Message::kNormalPriority);
+    EXPECT(message->IsSnapshot());
+    {
+      ApiNativeScope scope;
+      ApiMessageReader reader(message.get());
+      Dart_CObject* root = reader.ReadMessage();
+      EXPECT_NOTNULL(root);
+      EXPECT_EQ(Dart_CObject_kArray, root->type);
+      EXPECT_EQ(2, root->value.as_array.length);
+    }
+  }
+
+  EXPECT(Dart_CloseNativePort(native_port));
+}
+
+}  // namespace dart
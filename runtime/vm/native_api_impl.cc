@@ -59,6 +59,32 @@ DART_EXPORT bool Dart_PostCObject(Dart_Port port_id, Dart_CObject* message) {
   return PostCObjectHelper(port_id, message);
 }
 
+DART_EXPORT bool Dart_PostCObjects(Dart_Port port_id,
+                                   intptr_t num_messages,
+                                   Dart_CObject** messages) {
+  if (num_messages < 0 || (num_messages > 0 && messages == NULL)) {
+    return false;
+  }
+  MessageQueue batch;
+  for (intptr_t i = 0; i < num_messages; i++) {
+    ApiMessageWriter writer;
+    std::unique_ptr<Message> msg =
+        writer.WriteCMessage(messages[i], port_id, Message::kNormalPriority);
+    if (msg == nullptr) {
+      // Nothing is posted, so external data stays owned by the caller.
+      std::unique_ptr<Message> written;
+      while ((written = batch.Dequeue()) != nullptr) {
+        written->DropFinalizers();
+      }
+      return false;
+    }
+    batch.Enqueue(std::move(msg), /*before_events=*/false);
+  }
+
+  // Post all messages at the given port.
+  return PortMap::PostMessages(port_id, &batch);
+}
+
 DART_EXPORT bool Dart_PostInteger(Dart_Port port_id, int64_t message) {
   if (Smi::IsValid(message)) {
     return PortMap::PostMessage(
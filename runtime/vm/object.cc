@@ -1477,6 +1477,13 @@ void Object::FinalizeReadOnlyObject(ObjectPtr object) {
     ASSERT(size <= desc->ptr()->HeapSize());
     memset(reinterpret_cast<void*>(ObjectLayout::ToAddr(desc) + size), 0,
            desc->ptr()->HeapSize() - size);
+  } else if (cid == kMintCid || cid == kDoubleCid) {
+    // Clear the alignment padding between the header and the value.
+    const intptr_t value_offset =
+        (cid == kMintCid) ? Mint::value_offset() : Double::value_offset();
+    memset(reinterpret_cast<void*>(ObjectLayout::ToAddr(object) +
+                                   sizeof(ObjectLayout)),
+           0, value_offset - sizeof(ObjectLayout));
   }
 }
 
@@ -10642,7 +10649,8 @@ void Script::LookupSourceAndLineStarts(Zone* zone) const {
       script = lib.LookupScript(uri, /* useResolvedUri = */ true);
       if (!script.IsNull()) {
         const auto& source = String::Handle(zone, script.Source());
-        const auto& line_starts = TypedData::Handle(zone, script.line_starts());
+        const auto& line_starts =
+            TypedDataBase::Handle(zone, script.line_starts());
         if (!source.IsNull() || !line_starts.IsNull()) {
           set_source(source);
           set_line_starts(line_starts);
@@ -10661,7 +10669,7 @@ GrowableObjectArrayPtr Script::GenerateLineNumberArray() const {
       GrowableObjectArray::Handle(zone, GrowableObjectArray::New());
   const Object& line_separator = Object::Handle(zone);
   LookupSourceAndLineStarts(zone);
-  if (line_starts() == TypedData::null()) {
+  if (line_starts() == TypedDataBase::null()) {
     // Scripts in the AOT snapshot do not have a line starts array.
     // Neither do some scripts coming from bytecode.
     // A well-formed line number array has a leading null.
@@ -10670,7 +10678,8 @@ GrowableObjectArrayPtr Script::GenerateLineNumberArray() const {
   }
 #if !defined(DART_PRECOMPILED_RUNTIME)
   Smi& value = Smi::Handle(zone);
-  const TypedData& line_starts_data = TypedData::Handle(zone, line_starts());
+  const TypedDataBase& line_starts_data =
+      TypedDataBase::Handle(zone, line_starts());
   intptr_t line_count = line_starts_data.Length();
   const Array& debug_positions_array = Array::Handle(debug_positions());
   intptr_t token_count = debug_positions_array.Length();
@@ -10722,7 +10731,7 @@ void Script::set_source(const String& value) const {
   StorePointer(&raw_ptr()->source_, value.raw());
 }
 
-void Script::set_line_starts(const TypedData& value) const {
+void Script::set_line_starts(const TypedDataBase& value) const {
   StorePointer(&raw_ptr()->line_starts_, value.raw());
 }
 
@@ -10730,7 +10739,7 @@ void Script::set_debug_positions(const Array& value) const {
   StorePointer(&raw_ptr()->debug_positions_, value.raw());
 }
 
-TypedDataPtr Script::line_starts() const {
+TypedDataBasePtr Script::line_starts() const {
   return raw_ptr()->line_starts_;
 }
 
@@ -10783,7 +10792,8 @@ bool Script::GetTokenLocationUsingLineStarts(TokenPosition target_token_pos,
   if (target_token_pos.value() < 0) return false;
 
   Zone* zone = Thread::Current()->zone();
-  TypedData& line_starts_data = TypedData::Handle(zone, line_starts());
+  TypedDataBase& line_starts_data =
+      TypedDataBase::Handle(zone, line_starts());
   // Scripts loaded from bytecode may have null line_starts().
   if (line_starts_data.IsNull()) return false;
 
@@ -10823,7 +10833,7 @@ void Script::GetTokenLocation(TokenPosition token_pos,
   Zone* zone = Thread::Current()->zone();
 
   LookupSourceAndLineStarts(zone);
-  if (line_starts() == TypedData::null()) {
+  if (line_starts() == TypedDataBase::null()) {
     // Scripts in the AOT snapshot do not have a line starts array.
     // Neither do some scripts coming from bytecode.
     *line = -1;
@@ -10836,7 +10846,8 @@ void Script::GetTokenLocation(TokenPosition token_pos,
     return;
   }
 #if !defined(DART_PRECOMPILED_RUNTIME)
-  const TypedData& line_starts_data = TypedData::Handle(zone, line_starts());
+  const TypedDataBase& line_starts_data =
+      TypedDataBase::Handle(zone, line_starts());
   kernel::KernelLineStartsReader line_starts_reader(line_starts_data, zone);
   line_starts_reader.LocationForPosition(token_pos.value(), line, column);
   if (token_len != NULL) {
@@ -10866,7 +10877,7 @@ void Script::TokenRangeAtLine(intptr_t line_number,
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
   LookupSourceAndLineStarts(zone);
-  if (line_starts() == TypedData::null()) {
+  if (line_starts() == TypedDataBase::null()) {
     // Scripts in the AOT snapshot do not have a line starts array.
     // Neither do some scripts coming from bytecode.
     *first_token_index = TokenPosition::kNoSource;
@@ -10884,7 +10895,8 @@ void Script::TokenRangeAtLine(intptr_t line_number,
   } else {
     source_length = source.Length();
   }
-  const TypedData& line_starts_data = TypedData::Handle(zone, line_starts());
+  const TypedDataBase& line_starts_data =
+      TypedDataBase::Handle(zone, line_starts());
   kernel::KernelLineStartsReader line_starts_reader(line_starts_data,
                                                     Thread::Current()->zone());
   line_starts_reader.TokenRangeAtLine(source_length, line_number,
@@ -21313,6 +21325,11 @@ bool String::Equals(const String& str,
     return false;  // Lengths don't match.
   }
 
+  if (IsOneByteString() && str.IsOneByteString()) {
+    NoSafepointScope no_safepoint;
+    return memcmp(OneByteString::DataStart(*this),
+                  OneByteString::CharAddr(str, begin_index), len) == 0;
+  }
   for (intptr_t i = 0; i < len; i++) {
     if (CharAt(i) != str.CharAt(begin_index + i)) {
       return false;
@@ -21399,14 +21416,22 @@ intptr_t String::CompareTo(const String& other) const {
   const intptr_t this_len = this->Length();
   const intptr_t other_len = other.IsNull() ? 0 : other.Length();
   const intptr_t len = (this_len < other_len) ? this_len : other_len;
-  for (intptr_t i = 0; i < len; i++) {
-    uint16_t this_code_unit = this->CharAt(i);
-    uint16_t other_code_unit = other.CharAt(i);
-    if (this_code_unit < other_code_unit) {
-      return -1;
-    }
-    if (this_code_unit > other_code_unit) {
-      return 1;
+  if (IsOneByteString() && !other.IsNull() && other.IsOneByteString()) {
+    // Unsigned byte order is code unit order.
+    NoSafepointScope no_safepoint;
+    const int result = memcmp(OneByteString::DataStart(*this),
+                              OneByteString::DataStart(other), len);
+    if (result != 0) return (result < 0) ? -1 : 1;
+  } else {
+    for (intptr_t i = 0; i < len; i++) {
+      uint16_t this_code_unit = this->CharAt(i);
+      uint16_t other_code_unit = other.CharAt(i);
+      if (this_code_unit < other_code_unit) {
+        return -1;
+      }
+      if (this_code_unit > other_code_unit) {
+        return 1;
+      }
     }
   }
   if (this_len < other_len) return -1;
@@ -21446,6 +21471,104 @@ bool String::EndsWith(const String& other) const {
   return true;
 }
 
+// Returns the index of [code_unit] in [chars] between [start] and [end], or -1.
+template <typename CharType>
+static intptr_t FindCodeUnit(const CharType* chars,
+                             intptr_t start,
+                             intptr_t end,
+                             uint16_t code_unit) {
+  for (intptr_t i = start; i < end; i++) {
+    if (chars[i] == code_unit) return i;
+  }
+  return -1;
+}
+
+template <>
+intptr_t FindCodeUnit(const uint8_t* chars,
+                      intptr_t start,
+                      intptr_t end,
+                      uint16_t code_unit) {
+  if (code_unit > 0xFF) return -1;
+  // memchr is vectorized by the C library.
+  const void* found = memchr(chars + start, code_unit, end - start);
+  return (found == nullptr) ? -1 : static_cast<const uint8_t*>(found) - chars;
+}
+
+template <typename CharType, typename PatternType>
+static bool CodeUnitsEqual(const CharType* chars,
+                           const PatternType* pattern,
+                           intptr_t length) {
+  if (sizeof(CharType) == sizeof(PatternType)) {
+    return memcmp(chars, pattern, length * sizeof(CharType)) == 0;
+  }
+  for (intptr_t i = 0; i < length; i++) {
+    if (chars[i] != pattern[i]) return false;
+  }
+  return true;
+}
+
+template <typename CharType, typename PatternType>
+static intptr_t IndexOfCodeUnits(const CharType* chars,
+                                 intptr_t length,
+                                 const PatternType* pattern,
+                                 intptr_t pattern_length,
+                                 intptr_t start) {
+  ASSERT(pattern_length > 0);
+  // Find candidates by their first code unit, then compare the rest.
+  const intptr_t end = length - pattern_length + 1;
+  for (intptr_t i = start; i < end; i++) {
+    i = FindCodeUnit(chars, i, end, pattern[0]);
+    if (i < 0) return -1;
+    if (CodeUnitsEqual(chars + i + 1, pattern + 1, pattern_length - 1)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+intptr_t String::IndexOf(const String& pattern, intptr_t start) const {
+  const intptr_t len = Length();
+  const intptr_t pattern_len = pattern.Length();
+  ASSERT((start >= 0) && (start <= len));
+  if (pattern_len == 0) {
+    return start;
+  }
+  if (pattern_len > len - start) {
+    return -1;
+  }
+  NoSafepointScope no_safepoint;
+  const uint8_t* one_byte_pattern = nullptr;
+  const uint16_t* two_byte_pattern = nullptr;
+  if (pattern.IsOneByteString()) {
+    one_byte_pattern = OneByteString::DataStart(pattern);
+  } else if (pattern.IsExternalOneByteString()) {
+    one_byte_pattern = ExternalOneByteString::DataStart(pattern);
+  } else if (pattern.IsTwoByteString()) {
+    two_byte_pattern = TwoByteString::DataStart(pattern);
+  } else {
+    ASSERT(pattern.IsExternalTwoByteString());
+    two_byte_pattern = ExternalTwoByteString::DataStart(pattern);
+  }
+  if (CharSize() == kOneByteChar) {
+    const uint8_t* chars = IsOneByteString()
+                               ? OneByteString::DataStart(*this)
+                               : ExternalOneByteString::DataStart(*this);
+    return (one_byte_pattern != nullptr)
+               ? IndexOfCodeUnits(chars, len, one_byte_pattern, pattern_len,
+                                  start)
+               : IndexOfCodeUnits(chars, len, two_byte_pattern, pattern_len,
+                                  start);
+  }
+  const uint16_t* chars = IsTwoByteString()
+                              ? TwoByteString::DataStart(*this)
+                              : ExternalTwoByteString::DataStart(*this);
+  return (one_byte_pattern != nullptr)
+             ? IndexOfCodeUnits(chars, len, one_byte_pattern, pattern_len,
+                                start)
+             : IndexOfCodeUnits(chars, len, two_byte_pattern, pattern_len,
+                                start);
+}
+
 InstancePtr String::CheckAndCanonicalize(Thread* thread,
                                          const char** error_str) const {
   if (IsCanonical()) {
@@ -24140,6 +24263,15 @@ void RegExp::set_capture_name_map(const Array& array) const {
   StorePointer(&raw_ptr()->capture_name_map_, array.raw());
 }
 
+void RegExp::set_dfa(const Object& value) const {
+  StorePointer(&raw_ptr()->dfa_, value.raw());
+}
+
+void RegExp::set_literal(const Object& literal, intptr_t offset) const {
+  StorePointer(&raw_ptr()->literal_, literal.raw());
+  StoreSmi(&raw_ptr()->literal_offset_, Smi::New(offset));
+}
+
 RegExpPtr RegExp::New(Heap::Space space) {
   RegExp& result = RegExp::Handle();
   {
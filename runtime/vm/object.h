@@ -4477,9 +4477,9 @@ class Script : public Object {
 
   TypedDataPtr kernel_string_offsets() const;
 
-  TypedDataPtr line_starts() const;
+  TypedDataBasePtr line_starts() const;
 
-  void set_line_starts(const TypedData& value) const;
+  void set_line_starts(const TypedDataBase& value) const;
 
   void set_debug_positions(const Array& value) const;
 
@@ -8647,6 +8647,10 @@ class String : public Instance {
   bool StartsWith(const String& other) const;
   bool EndsWith(const String& other) const;
 
+  // Returns the index of the first occurrence of [pattern] at or after
+  // [start], or -1 if there is none.
+  intptr_t IndexOf(const String& pattern, intptr_t start) const;
+
   // Strings are canonicalized using the symbol table.
   virtual InstancePtr CheckAndCanonicalize(Thread* thread,
                                            const char** error_str) const;
@@ -8994,6 +8998,7 @@ class OneByteString : public AllStatic {
   friend class SnapshotReader;
   friend class StringHasher;
   friend class Utf8;
+  friend class OneByteStringMessageDeserializationCluster;
 };
 
 class TwoByteString : public AllStatic {
@@ -9116,6 +9121,8 @@ class TwoByteString : public AllStatic {
   friend class String;
   friend class SnapshotReader;
   friend class Symbols;
+  friend class Utf8;
+  friend class TwoByteStringMessageDeserializationCluster;
 };
 
 class ExternalOneByteString : public AllStatic {
@@ -9293,6 +9300,7 @@ class ExternalTwoByteString : public AllStatic {
   friend class String;
   friend class SnapshotReader;
   friend class Symbols;
+  friend class Utf8;
 };
 
 // Class Bool implements Dart core class bool.
@@ -9353,6 +9361,11 @@ class Array : public Instance {
   static intptr_t element_offset(intptr_t index) {
     return OFFSET_OF_RETURNED_VALUE(ArrayLayout, data) + kWordSize * index;
   }
+  static intptr_t index_at_offset(intptr_t offset_in_bytes) {
+    const intptr_t index = (offset_in_bytes - data_offset()) / kWordSize;
+    ASSERT(index >= 0);
+    return index;
+  }
 
   struct ArrayTraits {
     static intptr_t elements_start_offset() { return Array::data_offset(); }
@@ -10366,6 +10379,9 @@ class LinkedHashMap : public Instance {
 
   friend class Class;
   friend class LinkedHashMapDeserializationCluster;
+  friend class LinkedHashMapMessageDeserializationCluster;
+  template <typename CharType>
+  friend class JsonDecoder;
 };
 
 class Closure : public Instance {
@@ -10744,6 +10760,16 @@ class RegExp : public Instance {
 
   void set_num_bracket_expressions(intptr_t value) const;
   void set_capture_name_map(const Array& array) const;
+
+  ObjectPtr dfa() const { return raw_ptr()->dfa_; }
+  void set_dfa(const Object& value) const;
+
+  ObjectPtr literal() const { return raw_ptr()->literal_; }
+  intptr_t literal_offset() const {
+    return Smi::Value(raw_ptr()->literal_offset_);
+  }
+  void set_literal(const Object& literal, intptr_t offset) const;
+
   void set_is_global() const {
     RegExpFlags f = flags();
     f.SetGlobal();
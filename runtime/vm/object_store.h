@@ -173,6 +173,7 @@ class ObjectPointerVisitor;
   RW(CompressedStackMaps, canonicalized_stack_map_entries)                     \
   RW(ObjectPool, global_object_pool)                                           \
   RW(Array, unique_dynamic_targets)                                            \
+  RW(Array, type_feedback)                                                     \
   RW(GrowableObjectArray, megamorphic_cache_table)                             \
   RW(Code, build_method_extractor_code)                                        \
   RW(Code, dispatch_table_null_error_stub)                                     \
@@ -357,6 +358,17 @@ class ObjectStore {
 #undef DECLARE_GETTER
 #undef DECLARE_GETTER_AND_SETTER
 
+  // The symbol table is searched without holding a lock while other threads
+  // insert symbols (see Symbols::NewSymbol).
+  ArrayPtr symbol_table_acquire() const {
+    return reinterpret_cast<const std::atomic<ArrayPtr>*>(&symbol_table_)
+        ->load(std::memory_order_acquire);
+  }
+  void set_symbol_table_release(const Array& value) {
+    reinterpret_cast<std::atomic<ArrayPtr>*>(&symbol_table_)
+        ->store(value.raw(), std::memory_order_release);
+  }
+
   LibraryPtr bootstrap_library(BootstrapLibraryId index) {
     switch (index) {
 #define MAKE_CASE(CamelName, name)                                             \
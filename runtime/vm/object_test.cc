@@ -341,6 +341,17 @@ ISOLATE_UNIT_TEST_CASE(StringCompareTo) {
   EXPECT(domino.CompareTo(abcd) > 0);
   EXPECT(monkey_face.CompareTo(abce) > 0);
   EXPECT(monkey_face.CompareTo(abce) > 0);
+
+  // Latin-1 characters order after ASCII ones.
+  const uint8_t latin1[] = {'a', 0xFF};
+  const String& a_y_umlaut = String::Handle(
+      OneByteString::New(latin1, ARRAY_SIZE(latin1), Heap::kNew));
+  const String& ab = String::Handle(String::New("ab"));
+  const String& abc = String::Handle(String::New("abc"));
+  EXPECT(a_y_umlaut.CompareTo(ab) > 0);
+  EXPECT(ab.CompareTo(a_y_umlaut) < 0);
+  EXPECT(ab.CompareTo(abc) < 0);
+  EXPECT(abc.CompareTo(ab) > 0);
 }
 
 ISOLATE_UNIT_TEST_CASE(StringEncodeIRI) {
@@ -1561,6 +1572,47 @@ ISOLATE_UNIT_TEST_CASE(ExternalOneByteString) {
   EXPECT(substr.Equals("\xC3\xB1"));
 }
 
+ISOLATE_UNIT_TEST_CASE(StringIndexOf) {
+  const String& str = String::Handle(
+      String::New("the quick brown fox jumps over the lazy dog"));
+  const String& the = String::Handle(String::New("the"));
+  const String& dog = String::Handle(String::New("dog"));
+  const String& cat = String::Handle(String::New("cat"));
+  const String& empty = String::Handle(String::New(""));
+  EXPECT_EQ(0, str.IndexOf(the, 0));
+  EXPECT_EQ(31, str.IndexOf(the, 1));
+  EXPECT_EQ(31, str.IndexOf(the, 31));
+  EXPECT_EQ(-1, str.IndexOf(the, 32));
+  EXPECT_EQ(40, str.IndexOf(dog, 0));
+  EXPECT_EQ(-1, str.IndexOf(dog, 41));
+  EXPECT_EQ(-1, str.IndexOf(cat, 0));
+  EXPECT_EQ(5, str.IndexOf(empty, 5));
+  EXPECT_EQ(str.Length(), str.IndexOf(empty, str.Length()));
+  EXPECT_EQ(-1, the.IndexOf(str, 0));
+
+  // Mixed widths.
+  const uint16_t two_byte_chars[] = {'x', 0x1234, 'd', 'o', 'g', 0x1234};
+  const String& two_byte = String::Handle(
+      String::FromUTF16(two_byte_chars, ARRAY_SIZE(two_byte_chars)));
+  EXPECT(two_byte.IsTwoByteString());
+  const String& wide_suffix = String::Handle(String::SubString(two_byte, 4));
+  EXPECT(wide_suffix.IsTwoByteString());
+  EXPECT_EQ(2, two_byte.IndexOf(dog, 0));
+  EXPECT_EQ(4, two_byte.IndexOf(wide_suffix, 0));
+  EXPECT_EQ(-1, str.IndexOf(wide_suffix, 0));
+  const String& wide_char = String::Handle(String::SubString(two_byte, 1, 1));
+  EXPECT_EQ(1, two_byte.IndexOf(wide_char, 0));
+  EXPECT_EQ(5, two_byte.IndexOf(wide_char, 2));
+
+  // External strings.
+  const uint8_t external_chars[] = {'h', 'o', 't', 'd', 'o', 'g'};
+  const String& external = String::Handle(ExternalOneByteString::New(
+      external_chars, ARRAY_SIZE(external_chars), NULL, 0, NoopFinalizer,
+      Heap::kNew));
+  EXPECT_EQ(3, external.IndexOf(dog, 0));
+  EXPECT_EQ(40, str.IndexOf(String::Handle(String::SubString(external, 3)), 0));
+}
+
 ISOLATE_UNIT_TEST_CASE(EscapeSpecialCharactersOneByteString) {
   uint8_t characters[] = {'a',  '\n', '\f', '\b', '\t',
                           '\v', '\r', '\\', '$',  'z'};
@@ -4555,6 +4607,41 @@ ISOLATE_UNIT_TEST_CASE(Symbols_FromConcatAll) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Symbols_IncrementalGrowth) {
+  // Enough symbols to grow the symbol table several times.
+  const intptr_t kNumSymbols = 20000;
+  Isolate* isolate = thread->isolate();
+  intptr_t size_before = 0;
+  intptr_t capacity_before = 0;
+  Symbols::GetStats(isolate, &size_before, &capacity_before);
+
+  const Array& symbols = Array::Handle(Array::New(kNumSymbols, Heap::kOld));
+  String& symbol = String::Handle();
+  char name[64];
+  for (intptr_t i = 0; i < kNumSymbols; i++) {
+    Utils::SNPrint(name, sizeof(name), "IncrementalGrowth%" Pd, i);
+    symbol = Symbols::New(thread, name);
+    EXPECT(symbol.IsSymbol());
+    symbols.SetAt(i, symbol);
+    // Symbols inserted before the table grew are still found, whether or not
+    // they have been moved to the grown table yet.
+    Utils::SNPrint(name, sizeof(name), "IncrementalGrowth%" Pd, i / 2);
+    symbol = Symbols::New(thread, name);
+    EXPECT(symbol.raw() == symbols.At(i / 2));
+  }
+  for (intptr_t i = 0; i < kNumSymbols; i++) {
+    Utils::SNPrint(name, sizeof(name), "IncrementalGrowth%" Pd, i);
+    symbol = Symbols::New(thread, name);
+    EXPECT(symbol.raw() == symbols.At(i));
+  }
+
+  intptr_t size_after = 0;
+  intptr_t capacity_after = 0;
+  Symbols::GetStats(isolate, &size_after, &capacity_after);
+  EXPECT_EQ(size_before + kNumSymbols, size_after);
+  EXPECT_GT(capacity_after, capacity_before);
+}
+
 struct TestResult {
   const char* in;
   const char* out;
@@ -198,6 +198,23 @@ bool PortMap::PostMessage(std::unique_ptr<Message> message,
   return true;
 }
 
+bool PortMap::PostMessages(Dart_Port id, MessageQueue* messages) {
+  MutexLocker ml(mutex_);
+  auto it = ports_->TryLookup(id);
+  if (it == ports_->end()) {
+    // Ownership of external data remains with the poster.
+    std::unique_ptr<Message> message;
+    while ((message = messages->Dequeue()) != nullptr) {
+      message->DropFinalizers();
+    }
+    return false;
+  }
+  MessageHandler* handler = (*it).handler;
+  ASSERT(handler != nullptr);
+  handler->PostMessages(messages);
+  return true;
+}
+
 bool PortMap::IsLocalPort(Dart_Port id) {
   MutexLocker ml(mutex_);
   auto it = ports_->TryLookup(id);
@@ -228,7 +245,9 @@ bool PortMap::IsReceiverInThisIsolateGroup(Dart_Port receiver,
   MutexLocker ml(mutex_);
   auto it = ports_->TryLookup(receiver);
   if (it == ports_->end()) return false;
-  return (*it).handler->isolate()->group() == group;
+  // Native ports have no isolate.
+  Isolate* isolate = (*it).handler->isolate();
+  return isolate != nullptr && isolate->group() == group;
 }
 
 void PortMap::Init() {
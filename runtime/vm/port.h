@@ -19,6 +19,7 @@ namespace dart {
 class Isolate;
 class Message;
 class MessageHandler;
+class MessageQueue;
 class Mutex;
 class PortMapTestPeer;
 
@@ -52,6 +53,13 @@ class PortMap : public AllStatic {
   static bool PostMessage(std::unique_ptr<Message> message,
                           bool before_events = false);
 
+  // Enqueues all messages in 'messages', in order, in the port with id,
+  // looking the port up only once. Returns false if the port is not active
+  // any longer, in which case the messages are dropped.
+  //
+  // Empties 'messages'.
+  static bool PostMessages(Dart_Port id, MessageQueue* messages);
+
   // Returns whether a port is local to the current isolate.
   static bool IsLocalPort(Dart_Port id);
 
@@ -142,6 +142,29 @@ TEST_CASE(PortMap_PostMessage) {
   PortMap::ClosePorts(&handler);
 }
 
+TEST_CASE(PortMap_PostMessages) {
+  PortTestMessageHandler handler;
+  Dart_Port port = PortMap::CreatePort(&handler);
+  EXPECT_EQ(0, handler.notify_count);
+
+  const char* message = "msg";
+  intptr_t message_len = strlen(message) + 1;
+
+  MessageQueue batch;
+  for (intptr_t i = 0; i < 3; i++) {
+    batch.Enqueue(
+        Message::New(port, reinterpret_cast<uint8_t*>(Utils::StrDup(message)),
+                     message_len, nullptr, Message::kNormalPriority),
+        /*before_events=*/false);
+  }
+  EXPECT(PortMap::PostMessages(port, &batch));
+  EXPECT(batch.IsEmpty());
+
+  // Check that the message notify callback was called once for the batch.
+  EXPECT_EQ(1, handler.notify_count);
+  PortMap::ClosePorts(&handler);
+}
+
 TEST_CASE(PortMap_PostIntegerMessage) {
   PortTestMessageHandler handler;
   Dart_Port port = PortMap::CreatePort(&handler);
@@ -182,4 +205,23 @@ TEST_CASE(PortMap_PostMessageClosedPort) {
                    message_len, nullptr, Message::kNormalPriority)));
 }
 
+TEST_CASE(PortMap_PostMessagesClosedPort) {
+  // Create a port id and make it invalid.
+  PortTestMessageHandler handler;
+  Dart_Port port = PortMap::CreatePort(&handler);
+  PortMap::ClosePort(port);
+
+  const char* message = "msg";
+  intptr_t message_len = strlen(message) + 1;
+
+  MessageQueue batch;
+  batch.Enqueue(
+      Message::New(port, reinterpret_cast<uint8_t*>(Utils::StrDup(message)),
+                   message_len, nullptr, Message::kNormalPriority),
+      /*before_events=*/false);
+  EXPECT(!PortMap::PostMessages(port, &batch));
+  EXPECT(batch.IsEmpty());
+  EXPECT_EQ(0, handler.notify_count);
+}
+
 }  // namespace dart
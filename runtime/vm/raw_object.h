@@ -96,6 +96,8 @@ enum TypedDataElementType {
   HEAP_PROFILER_SUPPORT()                                                      \
   friend class object##SerializationCluster;                                   \
   friend class object##DeserializationCluster;                                 \
+  friend class object##MessageSerializationCluster;                            \
+  friend class object##MessageDeserializationCluster;                          \
   friend class Serializer;                                                     \
   friend class Deserializer;                                                   \
   friend class Pass2Visitor;
@@ -1230,7 +1232,9 @@ class ScriptLayout : public ObjectLayout {
   StringPtr url_;
   StringPtr resolved_url_;
   ArrayPtr compile_time_constants_;
-  TypedDataPtr line_starts_;
+  // Internal typed data, or external typed data pointing into the snapshot
+  // the script was read from.
+  TypedDataBasePtr line_starts_;
   ArrayPtr debug_positions_;
   KernelProgramInfoPtr kernel_program_info_;
   StringPtr source_;
@@ -2345,6 +2349,8 @@ class StringLayout : public InstanceLayout {
   friend class TwoByteStringSerializationCluster;
   friend class OneByteStringDeserializationCluster;
   friend class TwoByteStringDeserializationCluster;
+  friend class OneByteStringMessageSerializationCluster;
+  friend class TwoByteStringMessageSerializationCluster;
   friend class RODataSerializationCluster;
   friend class ImageWriter;
 };
@@ -2449,6 +2455,7 @@ class TypedDataLayout : public TypedDataBaseLayout {
   friend class ObjectPoolDeserializationCluster;
   friend class ObjectPoolSerializationCluster;
   friend class ObjectPoolLayout;
+  friend class ScriptSerializationCluster;
   friend class SnapshotReader;
 };
 
@@ -2551,6 +2558,8 @@ class ArrayLayout : public InstanceLayout {
 
   friend class LinkedHashMapSerializationCluster;
   friend class LinkedHashMapDeserializationCluster;
+  friend class GrowableObjectArrayMessageSerializationCluster;
+  friend class LinkedHashMapMessageSerializationCluster;
   friend class CodeSerializationCluster;
   friend class CodeDeserializationCluster;
   friend class Deserializer;
@@ -2668,6 +2677,7 @@ class ExternalTypedDataLayout : public TypedDataBaseLayout {
   VISIT_TO(RawCompressed, length_)
 
   friend class BytecodeLayout;
+  friend class ScriptDeserializationCluster;
 };
 
 class PointerLayout : public PointerBaseLayout {
@@ -2768,8 +2778,18 @@ class RegExpLayout : public InstanceLayout {
   } two_byte_sticky_;
   FunctionPtr external_one_byte_sticky_function_;
   FunctionPtr external_two_byte_sticky_function_;
-  VISIT_TO(ObjectPtr, external_two_byte_sticky_function_)
-  ObjectPtr* to_snapshot(Snapshot::Kind kind) { return to(); }
+  // The RegExpDFA wrapped in an ExternalTypedData, or false if the pattern
+  // cannot be matched by a DFA. Created lazily and not serialized.
+  ObjectPtr dfa_;
+  // A literal every match contains, or false if there is none. Created lazily
+  // and not serialized.
+  ObjectPtr literal_;
+  // The offset of literal_ from the start of every match, or -1 if it varies.
+  SmiPtr literal_offset_;
+  VISIT_TO(ObjectPtr, literal_offset_)
+  ObjectPtr* to_snapshot(Snapshot::Kind kind) {
+    return reinterpret_cast<ObjectPtr*>(&external_two_byte_sticky_function_);
+  }
 
   // The same pattern may use different amount of registers if compiled
   // for a one-byte target than a two-byte target. For example, we do not
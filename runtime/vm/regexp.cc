@@ -12,6 +12,9 @@
 #include "unicode/uniset.h"
 
 #include "vm/dart_entry.h"
+#include "vm/flags.h"
+#include "vm/hash_table.h"
+#include "vm/isolate.h"
 #include "vm/regexp_assembler.h"
 #include "vm/regexp_assembler_bytecode.h"
 #include "vm/regexp_ast.h"
@@ -27,6 +30,16 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            share_regexp_bytecode,
+            true,
+            "Share compiled regexp bytecode between the isolates of a group.");
+DEFINE_FLAG(bool,
+            print_regexp_cache_stats,
+            false,
+            "Print the hits and misses of the compiled regexp cache of each "
+            "isolate group on shutdown.");
+
 // Default to generating optimized regexp code.
 static const bool kRegexpOptimization = true;
 
@@ -5583,4 +5596,139 @@ RegExpPtr RegExpEngine::CreateRegExp(Thread* thread,
   return regexp.raw();
 }
 
+class CompiledRegExpKey {
+ public:
+  CompiledRegExpKey(const String& pattern, RegExpFlags flags)
+      : pattern_(pattern), flags_(flags) {}
+
+  bool Matches(const RegExp& other) const {
+    return (other.flags().value() == flags_.value()) &&
+           pattern_.Equals(String::Handle(other.pattern()));
+  }
+  uword Hash() const { return Hash(pattern_, flags_); }
+
+  static uword Hash(const String& pattern, RegExpFlags flags) {
+    return FinalizeHash(CombineHashes(pattern.Hash(), flags.value()),
+                        kBitsPerInt32 - 1);
+  }
+
+  const String& pattern_;
+  const RegExpFlags flags_;
+
+ private:
+  DISALLOW_ALLOCATION();
+};
+
+// Traits for looking up the template of a compiled regexp by pattern and
+// flags.
+class CompiledRegExpTraits {
+ public:
+  static const char* Name() { return "CompiledRegExpTraits"; }
+  static bool ReportStats() { return false; }
+
+  static bool IsMatch(const Object& a, const Object& b) {
+    const RegExp& regexp = RegExp::Cast(a);
+    return CompiledRegExpKey(String::Handle(regexp.pattern()), regexp.flags())
+        .Matches(RegExp::Cast(b));
+  }
+  static bool IsMatch(const CompiledRegExpKey& a, const Object& b) {
+    return a.Matches(RegExp::Cast(b));
+  }
+  static uword Hash(const Object& key) {
+    const RegExp& regexp = RegExp::Cast(key);
+    return CompiledRegExpKey::Hash(String::Handle(regexp.pattern()),
+                                   regexp.flags());
+  }
+  static uword Hash(const CompiledRegExpKey& key) { return key.Hash(); }
+};
+typedef UnorderedHashSet<CompiledRegExpTraits> CompiledRegExpSet;
+
+// Copies the bytecode for one specialization and the state computed with it.
+static void CopyCompiledState(const RegExp& from,
+                              const RegExp& to,
+                              bool is_one_byte,
+                              bool sticky) {
+  to.set_num_bracket_expressions(Smi::Value(from.num_bracket_expressions()));
+  to.set_capture_name_map(Array::Handle(from.capture_name_map()));
+  if (from.is_simple()) {
+    to.set_is_simple();
+  } else {
+    to.set_is_complex();
+  }
+  to.set_num_registers(is_one_byte, from.num_registers(is_one_byte));
+  to.set_bytecode(is_one_byte, sticky,
+                  TypedData::Handle(from.bytecode(is_one_byte, sticky)));
+}
+
+bool CompiledRegExpCache::Lookup(Thread* thread,
+                                 const RegExp& regexp,
+                                 bool is_one_byte,
+                                 bool sticky) {
+  if (!FLAG_share_regexp_bytecode) {
+    return false;
+  }
+  Zone* zone = thread->zone();
+  IsolateGroup* group = thread->isolate_group();
+  const String& pattern = String::Handle(zone, regexp.pattern());
+  RegExp& entry = RegExp::Handle(zone);
+  {
+    SafepointMutexLocker ml(group->regexp_cache_mutex());
+    if (group->regexp_cache() != Array::null()) {
+      CompiledRegExpSet table(zone, group->regexp_cache());
+      entry ^= table.GetOrNull(CompiledRegExpKey(pattern, regexp.flags()));
+      table.Release();
+    }
+    if (entry.IsNull() ||
+        entry.bytecode(is_one_byte, sticky) == TypedData::null()) {
+      group->increment_regexp_cache_misses();
+      return false;
+    }
+    group->increment_regexp_cache_hits();
+    // Entries are only modified while holding the lock.
+    CopyCompiledState(entry, regexp, is_one_byte, sticky);
+  }
+  return true;
+}
+
+void CompiledRegExpCache::Add(Thread* thread,
+                              const RegExp& regexp,
+                              bool is_one_byte,
+                              bool sticky) {
+  if (!FLAG_share_regexp_bytecode) {
+    return;
+  }
+  Zone* zone = thread->zone();
+  IsolateGroup* group = thread->isolate_group();
+  const String& pattern = String::Handle(zone, regexp.pattern());
+  SafepointMutexLocker ml(group->regexp_cache_mutex());
+  const CompiledRegExpKey key(pattern, regexp.flags());
+  Array& data = Array::Handle(zone, group->regexp_cache());
+  RegExp& entry = RegExp::Handle(zone);
+  if (!data.IsNull()) {
+    CompiledRegExpSet table(zone, data.raw());
+    entry ^= table.GetOrNull(key);
+    if (entry.IsNull() && (table.NumOccupied() >= kMaxEntries)) {
+      // Start over rather than growing without bound.
+      data = Array::null();
+    }
+    table.Release();
+  }
+  if (entry.IsNull()) {
+    if (data.IsNull()) {
+      data = HashTables::New<CompiledRegExpSet>(16, Heap::kOld);
+    }
+    // Entries are separate from the regexps of the isolates, which update
+    // their own state without holding the lock.
+    entry = RegExp::New(Heap::kOld);
+    entry.set_pattern(pattern);
+    entry.set_flags(regexp.flags());
+    CompiledRegExpSet table(zone, data.raw());
+    table.Insert(entry);
+    group->set_regexp_cache(table.Release());
+  }
+  if (entry.bytecode(is_one_byte, sticky) == TypedData::null()) {
+    CopyCompiledState(regexp, entry, is_one_byte, sticky);
+  }
+}
+
 }  // namespace dart
@@ -1517,6 +1517,31 @@ class RegExpEngine : public AllStatic {
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
 };
 
+// Shares the bytecode of regexps between all regexps with the same pattern
+// and flags in an isolate group, so that each pattern is compiled once per
+// group rather than once per isolate.
+//
+// IR-compiled regexps are not shared: their code embeds the register array
+// of the regexp it was compiled for.
+class CompiledRegExpCache : public AllStatic {
+ public:
+  // If the cache has bytecode for [regexp]'s pattern and flags, installs it
+  // and the state computed along with it in [regexp] and returns true.
+  static bool Lookup(Thread* thread,
+                     const RegExp& regexp,
+                     bool is_one_byte,
+                     bool sticky);
+
+  // Adds the bytecode just compiled for [regexp] to the cache.
+  static void Add(Thread* thread,
+                  const RegExp& regexp,
+                  bool is_one_byte,
+                  bool sticky);
+
+  // The cache is cleared when it grows beyond this many patterns.
+  static const intptr_t kMaxEntries = 1024;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_REGEXP_H_
@@ -426,7 +426,9 @@ static intptr_t Prepare(const RegExp& regexp,
   bool is_one_byte =
       subject.IsOneByteString() || subject.IsExternalOneByteString();
 
-  if (regexp.bytecode(is_one_byte, sticky) == TypedData::null()) {
+  if (regexp.bytecode(is_one_byte, sticky) == TypedData::null() &&
+      !CompiledRegExpCache::Lookup(Thread::Current(), regexp, is_one_byte,
+                                   sticky)) {
     const String& pattern = String::Handle(zone, regexp.pattern());
 #if defined(SUPPORT_TIMELINE)
     TimelineBeginEndScope tbes(Thread::Current(), Timeline::GetCompilerStream(),
@@ -457,6 +459,7 @@ static intptr_t Prepare(const RegExp& regexp,
            regexp.num_registers(is_one_byte) == result.num_registers);
     regexp.set_num_registers(is_one_byte, result.num_registers);
     regexp.set_bytecode(is_one_byte, sticky, *(result.bytecode));
+    CompiledRegExpCache::Add(Thread::Current(), regexp, is_one_byte, sticky);
   }
 
   ASSERT(regexp.num_registers(is_one_byte) != -1);
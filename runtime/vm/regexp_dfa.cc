@@ -0,0 +1,605 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/regexp_dfa.h"
+
+#include "platform/unicode.h"
+#include "vm/flags.h"
+#include "vm/hash.h"
+#include "vm/regexp.h"
+#include "vm/regexp_ast.h"
+#include "vm/regexp_parser.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            regexp_dfa,
+            true,
+            "Find regexp matches using a lazily built DFA before running, or "
+            "instead of, the backtracking regexp matcher. Has no effect on "
+            "IR-compiled regexps, which JIT mode calls through an intrinsic.");
+
+// Translates a RegExpTree into NFA nodes. Each tree is compiled backwards
+// from the node to continue with once it has matched. For the reversed
+// pattern, sequences are compiled in the opposite order and start and end of
+// input assertions swap places.
+class RegExpDFA::Builder : public ValueObject {
+ public:
+  Builder(RegExpDFA* dfa, bool reversed) : dfa_(dfa), reversed_(reversed) {}
+
+  bool failed() const { return failed_; }
+
+  intptr_t Compile(RegExpTree* tree, intptr_t on_success) {
+    if (failed_) return on_success;
+    if (tree->IsDisjunction()) {
+      ZoneGrowableArray<RegExpTree*>* alternatives =
+          tree->AsDisjunction()->alternatives();
+      intptr_t entry = Compile(alternatives->Last(), on_success);
+      for (intptr_t i = alternatives->length() - 2; i >= 0; i--) {
+        const intptr_t split = AddNode(Node::kSplit, kIllegalNode);
+        SetOut(split, Compile(alternatives->At(i), on_success), entry);
+        entry = split;
+      }
+      return entry;
+    }
+    if (tree->IsAlternative()) {
+      ZoneGrowableArray<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+      intptr_t entry = on_success;
+      for (intptr_t i = 0; i < nodes->length(); i++) {
+        entry = Compile(nodes->At(SequenceIndex(i, nodes->length())), entry);
+      }
+      return entry;
+    }
+    if (tree->IsAtom()) {
+      return CompileAtom(tree->AsAtom(), on_success);
+    }
+    if (tree->IsText()) {
+      GrowableArray<TextElement>* elements = tree->AsText()->elements();
+      intptr_t entry = on_success;
+      for (intptr_t i = 0; i < elements->length(); i++) {
+        const TextElement& element =
+            elements->At(SequenceIndex(i, elements->length()));
+        if (element.text_type() == TextElement::ATOM) {
+          entry = CompileAtom(element.atom(), entry);
+        } else {
+          entry = CompileCharacterClass(element.char_class(), entry);
+        }
+      }
+      return entry;
+    }
+    if (tree->IsCharacterClass()) {
+      return CompileCharacterClass(tree->AsCharacterClass(), on_success);
+    }
+    if (tree->IsQuantifier()) {
+      return CompileQuantifier(tree->AsQuantifier(), on_success);
+    }
+    if (tree->IsCapture()) {
+      // Captures only matter to the backtracking matcher.
+      dfa_->has_captures_ = true;
+      return Compile(tree->AsCapture()->body(), on_success);
+    }
+    if (tree->IsEmpty()) {
+      return on_success;
+    }
+    if (tree->IsAssertion()) {
+      switch (tree->AsAssertion()->assertion_type()) {
+        case RegExpAssertion::START_OF_INPUT:
+          return AddNode(reversed_ ? Node::kEndOfInput : Node::kStartOfInput,
+                         on_success);
+        case RegExpAssertion::END_OF_INPUT:
+          return AddNode(reversed_ ? Node::kStartOfInput : Node::kEndOfInput,
+                         on_success);
+        default:
+          // Line and word boundaries depend on the neighbouring characters.
+          break;
+      }
+    }
+    // Back references and lookarounds cannot be matched by a DFA.
+    failed_ = true;
+    return on_success;
+  }
+
+ private:
+  static const intptr_t kIllegalNode = -1;
+
+  // Returns the index of the [i]th term compiled of a sequence of [length]
+  // terms. Sequences are compiled from the term matched last.
+  intptr_t SequenceIndex(intptr_t i, intptr_t length) const {
+    return reversed_ ? i : length - 1 - i;
+  }
+
+  intptr_t AddNode(Node::Kind kind, intptr_t out) {
+    if (dfa_->nodes_.length() >= kMaxNodes) {
+      failed_ = true;
+      return out;
+    }
+    return dfa_->AddNode(kind, out);
+  }
+
+  void SetOut(intptr_t split, intptr_t out, intptr_t out1) {
+    if (failed_) return;
+    dfa_->nodes_[split].out = out;
+    dfa_->nodes_[split].out1 = out1;
+  }
+
+  intptr_t AddChar(int32_t from, int32_t to, intptr_t out) {
+    const intptr_t node = AddNode(Node::kChar, out);
+    if (failed_) return out;
+    Range range = {from, to};
+    dfa_->ranges_.Add(range);
+    dfa_->nodes_[node].first_range = dfa_->ranges_.length() - 1;
+    dfa_->nodes_[node].last_range = dfa_->ranges_.length();
+    return node;
+  }
+
+  intptr_t CompileAtom(RegExpAtom* atom, intptr_t on_success) {
+    ZoneGrowableArray<uint16_t>* data = atom->data();
+    intptr_t entry = on_success;
+    for (intptr_t i = 0; i < data->length(); i++) {
+      const uint16_t code_unit = data->At(SequenceIndex(i, data->length()));
+      entry = AddChar(code_unit, code_unit, entry);
+    }
+    return entry;
+  }
+
+  intptr_t CompileCharacterClass(RegExpCharacterClass* char_class,
+                                 intptr_t on_success) {
+    ZoneGrowableArray<CharacterRange>* ranges = char_class->ranges();
+    if (char_class->is_negated()) {
+      // Canonicalize a copy, the ranges are shared with the parsed tree.
+      ZoneGrowableArray<CharacterRange>* copy =
+          new ZoneGrowableArray<CharacterRange>(ranges->length());
+      for (intptr_t i = 0; i < ranges->length(); i++) {
+        copy->Add(ranges->At(i));
+      }
+      CharacterRange::Canonicalize(copy);
+      ranges = new ZoneGrowableArray<CharacterRange>(copy->length() + 1);
+      CharacterRange::Negate(copy, ranges);
+    }
+    const intptr_t node = AddNode(Node::kChar, on_success);
+    if (failed_) return on_success;
+    dfa_->nodes_[node].first_range = dfa_->ranges_.length();
+    for (intptr_t i = 0; i < ranges->length(); i++) {
+      const CharacterRange& range = ranges->At(i);
+      // Without the unicode flag the subject is matched by code units.
+      if (range.from() > Utf16::kMaxCodeUnit) continue;
+      const int32_t to =
+          Utils::Minimum<int32_t>(range.to(), Utf16::kMaxCodeUnit);
+      Range clipped = {range.from(), to};
+      dfa_->ranges_.Add(clipped);
+    }
+    dfa_->nodes_[node].last_range = dfa_->ranges_.length();
+    return node;
+  }
+
+  intptr_t CompileQuantifier(RegExpQuantifier* quantifier,
+                             intptr_t on_success) {
+    if (quantifier->is_possessive()) {
+      failed_ = true;
+      return on_success;
+    }
+    RegExpTree* body = quantifier->body();
+    if ((body->min_match() == 0) && (quantifier->max() > quantifier->min())) {
+      // The backtracking matcher rejects iterations matching the empty
+      // string and backtracks into them, which changes where a match ends.
+      dfa_->has_exact_end_ = false;
+    }
+    const bool greedy = quantifier->is_greedy();
+    intptr_t entry = on_success;
+    if (quantifier->max() == RegExpTree::kInfinity) {
+      const intptr_t loop = AddNode(Node::kSplit, kIllegalNode);
+      const intptr_t iteration = Compile(body, loop);
+      SetOut(loop, greedy ? iteration : on_success,
+             greedy ? on_success : iteration);
+      entry = loop;
+    } else {
+      // x{0,n} is (x(x(...)?)?)?.
+      for (intptr_t i = quantifier->min(); i < quantifier->max(); i++) {
+        if (failed_) return on_success;
+        const intptr_t split = AddNode(Node::kSplit, kIllegalNode);
+        const intptr_t iteration = Compile(body, entry);
+        SetOut(split, greedy ? iteration : on_success,
+               greedy ? on_success : iteration);
+        entry = split;
+      }
+    }
+    for (intptr_t i = 0; i < quantifier->min(); i++) {
+      if (failed_) return on_success;
+      entry = Compile(body, entry);
+    }
+    return entry;
+  }
+
+  RegExpDFA* dfa_;
+  const bool reversed_;
+  bool failed_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(Builder);
+};
+
+bool RegExpDFA::State::Equals(const State* other) const {
+  if (length != other->length) return false;
+  for (intptr_t i = 0; i < length; i++) {
+    if (nodes[i] != other->nodes[i]) return false;
+  }
+  return true;
+}
+
+RegExpDFA::RegExpDFA(bool reversed) : leftmost_first_(!reversed) {
+  for (size_t i = 0; i < ARRAY_SIZE(start_states_); i++) {
+    start_states_[i] = kUnknownState;
+  }
+}
+
+RegExpDFA::~RegExpDFA() {
+  Flush();
+  free(marks_);
+  delete reversed_;
+}
+
+intptr_t RegExpDFA::AddNode(Node::Kind kind, intptr_t out) {
+  Node node = {kind, out, -1, 0, 0};
+  nodes_.Add(node);
+  return nodes_.length() - 1;
+}
+
+RegExpDFA* RegExpDFA::New(RegExpTree* tree, RegExpFlags flags) {
+  // Case-insensitive and unicode patterns match through case equivalence
+  // tables and surrogate pairs, which are left to the backtracking matcher.
+  if (flags.IgnoreCase() || flags.IsUnicode()) {
+    return nullptr;
+  }
+  RegExpDFA* dfa = NewAutomaton(tree, /*reversed=*/false);
+  if (dfa == nullptr) {
+    return nullptr;
+  }
+  dfa->reversed_ = NewAutomaton(tree, /*reversed=*/true);
+  if (dfa->reversed_ == nullptr) {
+    delete dfa;
+    return nullptr;
+  }
+  return dfa;
+}
+
+RegExpDFA* RegExpDFA::NewAutomaton(RegExpTree* tree, bool reversed) {
+  RegExpDFA* dfa = new RegExpDFA(reversed);
+  Builder builder(dfa, reversed);
+  const intptr_t accept = dfa->AddNode(Node::kAccept, -1);
+  dfa->entry_ = builder.Compile(tree, accept);
+  if (builder.failed()) {
+    delete dfa;
+    return nullptr;
+  }
+  // Searches which are not sticky may skip any code unit before the match.
+  // Trying the match first gives later starts the lowest priority.
+  dfa->unanchored_entry_ = dfa->AddNode(Node::kSplit, dfa->entry_);
+  const intptr_t any = dfa->AddNode(Node::kChar, dfa->unanchored_entry_);
+  Range everything = {0, Utf16::kMaxCodeUnit};
+  dfa->ranges_.Add(everything);
+  dfa->nodes_[any].first_range = dfa->ranges_.length() - 1;
+  dfa->nodes_[any].last_range = dfa->ranges_.length();
+  dfa->nodes_[dfa->unanchored_entry_].out1 = any;
+
+  dfa->ComputeClasses();
+  if (dfa->class_bounds_.length() > kMaxClasses) {
+    delete dfa;
+    return nullptr;
+  }
+  dfa->marks_ = reinterpret_cast<intptr_t*>(
+      calloc(dfa->nodes_.length(), sizeof(intptr_t)));
+  const intptr_t state_size =
+      sizeof(State) + dfa->class_bounds_.length() * sizeof(int32_t) +
+      dfa->nodes_.length() * sizeof(intptr_t) / 4;
+  dfa->max_states_ = Utils::Maximum<intptr_t>(16, kMemoryBudget / state_size);
+  return dfa;
+}
+
+static int CompareBounds(const int32_t* a, const int32_t* b) {
+  return *a - *b;
+}
+
+void RegExpDFA::ComputeClasses() {
+  // Code units are partitioned into classes which no range splits, so that
+  // transitions only need to be computed once per class.
+  MallocGrowableArray<int32_t> bounds;
+  bounds.Add(0);
+  for (intptr_t i = 0; i < ranges_.length(); i++) {
+    bounds.Add(ranges_[i].from);
+    if (ranges_[i].to < Utf16::kMaxCodeUnit) {
+      bounds.Add(ranges_[i].to + 1);
+    }
+  }
+  bounds.Sort(CompareBounds);
+  for (intptr_t i = 0; i < bounds.length(); i++) {
+    if (i == 0 || bounds[i] != bounds[i - 1]) {
+      class_bounds_.Add(bounds[i]);
+    }
+  }
+  if (class_bounds_.length() > kMaxClasses) return;
+  intptr_t klass = 0;
+  for (intptr_t c = 0; c <= kMaxUint8; c++) {
+    while (klass + 1 < class_bounds_.length() &&
+           class_bounds_[klass + 1] <= c) {
+      klass++;
+    }
+    latin1_classes_[c] = klass;
+  }
+}
+
+void RegExpDFA::Closure(bool at_start, bool at_end) {
+  mark_++;
+  set_.Clear();
+  // Nodes are taken from the end, so that everything reachable from a node
+  // comes before the nodes after it.
+  work_.Reverse();
+  while (!work_.is_empty()) {
+    const intptr_t index = work_.RemoveLast();
+    if (marks_[index] == mark_) continue;
+    marks_[index] = mark_;
+    const Node& node = nodes_[index];
+    switch (node.kind) {
+      case Node::kSplit:
+        work_.Add(node.out1);
+        work_.Add(node.out);
+        break;
+      case Node::kStartOfInput:
+        if (at_start) work_.Add(node.out);
+        break;
+      case Node::kEndOfInput:
+        if (at_end) {
+          work_.Add(node.out);
+        } else {
+          // Kept, the assertion may still hold once the subject has ended.
+          set_.Add(index);
+        }
+        break;
+      case Node::kChar:
+        set_.Add(index);
+        break;
+      case Node::kAccept:
+        set_.Add(index);
+        if (leftmost_first_) {
+          // The backtracking matcher never tries the remaining nodes.
+          work_.Clear();
+        }
+        break;
+    }
+  }
+}
+
+static int CompareNodes(const intptr_t* a, const intptr_t* b) {
+  return (*a > *b) - (*a < *b);
+}
+
+intptr_t RegExpDFA::StateFor() {
+  if (!leftmost_first_) {
+    // Only the forward DFA depends on the order of the nodes.
+    set_.Sort(CompareNodes);
+  }
+  uint32_t hash = set_.length();
+  bool is_match = false;
+  for (intptr_t i = 0; i < set_.length(); i++) {
+    hash = CombineHashes(hash, set_[i]);
+    if (nodes_[set_[i]].kind == Node::kAccept) is_match = true;
+  }
+  const bool is_final = set_.length() == (is_match ? 1 : 0);
+  State key = {set_.data(), set_.length(), FinalizeHash(hash, kBitsPerInt32),
+               -1, nullptr, is_match, is_final};
+  State* state = state_map_.LookupValue(&key);
+  if (state != nullptr) {
+    return state->index;
+  }
+  if (states_.length() >= max_states_) {
+    return kUnknownState;
+  }
+  const intptr_t num_classes = class_bounds_.length();
+  int32_t* next =
+      reinterpret_cast<int32_t*>(malloc(num_classes * sizeof(int32_t)));
+  for (intptr_t i = 0; i < num_classes; i++) {
+    next[i] = kUnknownState;
+  }
+  intptr_t* nodes =
+      reinterpret_cast<intptr_t*>(malloc(set_.length() * sizeof(intptr_t)));
+  memmove(nodes, set_.data(), set_.length() * sizeof(intptr_t));
+  state = new State(key);
+  state->nodes = nodes;
+  state->index = states_.length();
+  state->next = next;
+  states_.Add(state);
+  state_map_.Insert(state);
+  return state->index;
+}
+
+intptr_t RegExpDFA::StartState(bool sticky, bool at_start) {
+  const intptr_t index = 2 * (sticky ? 1 : 0) + (at_start ? 1 : 0);
+  if (start_states_[index] == kUnknownState) {
+    work_.Add(sticky ? entry_ : unanchored_entry_);
+    Closure(at_start, /*at_end=*/false);
+    intptr_t state = StateFor();
+    if (state == kUnknownState) {
+      Flush();
+      state = StateFor();
+    }
+    start_states_[index] = state;
+  }
+  return start_states_[index];
+}
+
+intptr_t RegExpDFA::Step(intptr_t state, intptr_t klass) {
+  State* current = states_[state];
+  const int32_t code_unit = class_bounds_[klass];
+  for (intptr_t i = 0; i < current->length; i++) {
+    const Node& node = nodes_[current->nodes[i]];
+    if (node.kind != Node::kChar) continue;
+    for (intptr_t r = node.first_range; r < node.last_range; r++) {
+      if (ranges_[r].from <= code_unit && code_unit <= ranges_[r].to) {
+        work_.Add(node.out);
+        break;
+      }
+    }
+  }
+  Closure(/*at_start=*/false, /*at_end=*/false);
+  const intptr_t next = StateFor();
+  if (next == kUnknownState) {
+    // The cache is full: start over from the state being entered.
+    Flush();
+    return StateFor();
+  }
+  current->next[klass] = next;
+  return next;
+}
+
+bool RegExpDFA::MatchesAtEnd(intptr_t state, bool at_start) {
+  State* current = states_[state];
+  for (intptr_t i = 0; i < current->length; i++) {
+    work_.Add(current->nodes[i]);
+  }
+  Closure(at_start, /*at_end=*/true);
+  for (intptr_t i = 0; i < set_.length(); i++) {
+    if (nodes_[set_[i]].kind == Node::kAccept) return true;
+  }
+  return false;
+}
+
+void RegExpDFA::Flush() {
+  if (!states_.is_empty()) num_flushes_++;
+  for (intptr_t i = 0; i < states_.length(); i++) {
+    State* state = states_[i];
+    free(state->nodes);
+    free(state->next);
+    delete state;
+  }
+  states_.Clear();
+  state_map_.Clear();
+  for (size_t i = 0; i < ARRAY_SIZE(start_states_); i++) {
+    start_states_[i] = kUnknownState;
+  }
+}
+
+template <typename StringType>
+intptr_t RegExpDFA::ScanForward(const String& subject,
+                                intptr_t start,
+                                bool sticky) {
+  const intptr_t length = subject.Length();
+  intptr_t match_end = -1;
+  intptr_t state = StartState(sticky, start == 0);
+  for (intptr_t i = start;; i++) {
+    const State* current = states_[state];
+    if (current->is_match) match_end = i;
+    if (i == length) {
+      return MatchesAtEnd(state, i == 0) ? i : match_end;
+    }
+    if (current->is_final) return match_end;
+    const intptr_t klass = ClassOf(StringType::CharAt(subject, i));
+    const int32_t next = current->next[klass];
+    state = (next != kUnknownState) ? next : Step(state, klass);
+  }
+}
+
+template <typename StringType>
+intptr_t RegExpDFA::ScanBackward(const String& subject,
+                                 intptr_t start,
+                                 intptr_t end) {
+  ASSERT(!leftmost_first_);
+  // The reversed pattern starts where the match ends, so its start of input
+  // assertions hold if that is the end of the subject.
+  const bool at_end_of_subject = end == subject.Length();
+  intptr_t match_start = -1;
+  intptr_t state = StartState(/*sticky=*/true, at_end_of_subject);
+  for (intptr_t i = end;; i--) {
+    const State* current = states_[state];
+    if (current->is_match) match_start = i;
+    if (i == start) {
+      if ((i == 0) && MatchesAtEnd(state, (i == end) && at_end_of_subject)) {
+        return i;
+      }
+      return match_start;
+    }
+    if (current->is_final) return match_start;
+    const intptr_t klass = ClassOf(StringType::CharAt(subject, i - 1));
+    const int32_t next = current->next[klass];
+    state = (next != kUnknownState) ? next : Step(state, klass);
+  }
+}
+
+template <typename StringType>
+RegExpDFA::Result RegExpDFA::SearchString(const String& subject,
+                                          intptr_t start,
+                                          bool sticky,
+                                          intptr_t* match_start,
+                                          intptr_t* match_end) {
+  const intptr_t end = ScanForward<StringType>(subject, start, sticky);
+  if (end < 0) {
+    return kNoMatch;
+  }
+  *match_start =
+      sticky ? start
+             : reversed_->ScanBackward<StringType>(subject, start, end);
+  *match_end = end;
+  ASSERT((start <= *match_start) && (*match_start <= end));
+  return kMatch;
+}
+
+RegExpDFA::Result RegExpDFA::Search(const String& subject,
+                                    intptr_t start,
+                                    bool sticky,
+                                    intptr_t* match_start,
+                                    intptr_t* match_end) {
+  ASSERT((start >= 0) && (start <= subject.Length()));
+  switch (subject.GetClassId()) {
+    case kOneByteStringCid:
+      return SearchString<OneByteString>(subject, start, sticky, match_start,
+                                         match_end);
+    case kTwoByteStringCid:
+      return SearchString<TwoByteString>(subject, start, sticky, match_start,
+                                         match_end);
+    case kExternalOneByteStringCid:
+      return SearchString<ExternalOneByteString>(subject, start, sticky,
+                                                 match_start, match_end);
+    case kExternalTwoByteStringCid:
+      return SearchString<ExternalTwoByteString>(subject, start, sticky,
+                                                 match_start, match_end);
+    default:
+      UNREACHABLE();
+      return kMatch;
+  }
+}
+
+void RegExpDFA::Finalize(void* isolate_callback_data,
+                         Dart_WeakPersistentHandle handle,
+                         void* peer) {
+  delete reinterpret_cast<RegExpDFA*>(peer);
+}
+
+RegExpDFA* RegExpDFA::For(Zone* zone, const RegExp& regexp) {
+  const Object& dfa = Object::Handle(zone, regexp.dfa());
+  if (dfa.IsExternalTypedData()) {
+    return reinterpret_cast<RegExpDFA*>(
+        ExternalTypedData::Cast(dfa).DataAddr(0));
+  }
+  if (!dfa.IsNull()) {
+    return nullptr;
+  }
+  RegExpCompileData compile_data;
+  const String& pattern = String::Handle(zone, regexp.pattern());
+  RegExpParser::ParseRegExp(pattern, regexp.flags(), &compile_data);
+  RegExpDFA* result = New(compile_data.tree, regexp.flags());
+  if (result == nullptr) {
+    regexp.set_dfa(Bool::False());
+    return nullptr;
+  }
+  // The DFA is owned by an empty external typed data which deletes it once
+  // the regexp is collected.
+  const ExternalTypedData& owner = ExternalTypedData::Handle(
+      zone,
+      ExternalTypedData::New(kExternalTypedDataUint8ArrayCid,
+                             reinterpret_cast<uint8_t*>(result), 0,
+                             Heap::kOld));
+  // Accounts for the state caches of both the forward and reversed DFA.
+  owner.AddFinalizer(result, &Finalize, 2 * kMemoryBudget);
+  regexp.set_dfa(owner);
+  return result;
+}
+
+}  // namespace dart
@@ -0,0 +1,212 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_REGEXP_DFA_H_
+#define RUNTIME_VM_REGEXP_DFA_H_
+
+#include "platform/growable_array.h"
+#include "vm/allocation.h"
+#include "vm/hash_map.h"
+#include "vm/object.h"
+
+namespace dart {
+
+class RegExpTree;
+
+// Finds the match of a regular expression in a string in time linear in the
+// length of the subject.
+//
+// Supports patterns built from characters, character classes, alternatives,
+// quantifiers, captures and start or end of input assertions. The DFA is
+// built lazily from the states of a Thompson NFA while searching, and its
+// states are cached up to a fixed memory budget, after which the cache is
+// flushed and rebuilt on demand.
+//
+// The states of the forward DFA keep the NFA nodes in the order the
+// backtracking matcher would try them, and drop the nodes after a match,
+// so the scan stops where the backtracking matcher's match ends. A second
+// DFA for the reversed pattern then scans back from there to the leftmost
+// start of that match.
+//
+// The end is only exact when no quantified term can match the empty
+// string: the backtracking matcher rejects empty iterations and backtracks
+// into them, which a DFA cannot follow. The start is always exact, as it
+// only depends on whether there is a match. Captures are not computed.
+//
+// RegExp_ExecuteMatch uses the DFA when regexps are interpreted, as in AOT.
+// In JIT mode it is intrinsified to call IR-compiled regexps directly, so
+// the DFA is not used there unless --interpret_irregexp is given.
+class RegExpDFA {
+ public:
+  enum Result { kNoMatch, kMatch };
+
+  ~RegExpDFA();
+
+  // Returns whether [subject] contains a match starting at or after [start],
+  // or exactly at [start] if [sticky] is true. On a match, [match_start] is
+  // the start of the match found by the backtracking matcher and
+  // [match_end] is its end if has_exact_end(), otherwise the end of some
+  // match starting at [match_start].
+  Result Search(const String& subject,
+                intptr_t start,
+                bool sticky,
+                intptr_t* match_start,
+                intptr_t* match_end);
+
+  bool has_exact_end() const { return has_exact_end_; }
+  bool has_captures() const { return has_captures_; }
+
+  intptr_t num_states() const { return states_.length(); }
+  intptr_t num_flushes() const { return num_flushes_; }
+
+  // Returns the DFA of [regexp], creating it on first use, or nullptr if the
+  // pattern of [regexp] is not supported.
+  static RegExpDFA* For(Zone* zone, const RegExp& regexp);
+
+  // Returns a new DFA matching [tree], or nullptr if [tree] is not supported.
+  static RegExpDFA* New(RegExpTree* tree, RegExpFlags flags);
+
+ private:
+  struct Node {
+    enum Kind {
+      kChar,
+      kSplit,
+      kStartOfInput,
+      kEndOfInput,
+      kAccept,
+    };
+    Kind kind;
+    // The successor of the node. Split nodes have two.
+    intptr_t out;
+    intptr_t out1;
+    // Char nodes match the code units in ranges_[first_range, last_range).
+    intptr_t first_range;
+    intptr_t last_range;
+  };
+
+  struct Range {
+    int32_t from;
+    int32_t to;
+  };
+
+  // A DFA state: the set of NFA nodes the NFA can be in, after following
+  // split and satisfied assertion nodes.
+  struct State {
+    intptr_t* nodes;
+    intptr_t length;
+    uint32_t hash;
+    intptr_t index;
+    // Successor state per character class, or kUnknownState.
+    int32_t* next;
+    bool is_match;
+    // Whether the state has no nodes besides kAccept, so that no further
+    // input changes the result.
+    bool is_final;
+
+    intptr_t Hashcode() const { return hash; }
+    bool Equals(const State* other) const;
+  };
+
+  typedef MallocDirectChainedHashMap<PointerKeyValueTrait<State>> StateMap;
+
+  static const int32_t kUnknownState = -1;
+  static const intptr_t kMaxNodes = 4 * KB;
+  static const intptr_t kMaxClasses = 256;
+  static const intptr_t kMemoryBudget = 256 * KB;
+
+  explicit RegExpDFA(bool reversed);
+
+  class Builder;
+
+  // Returns a new DFA for [tree], reading the subject backwards if
+  // [reversed], or nullptr if [tree] is not supported.
+  static RegExpDFA* NewAutomaton(RegExpTree* tree, bool reversed);
+
+  intptr_t AddNode(Node::Kind kind, intptr_t out);
+  void ComputeClasses();
+
+  template <typename StringType>
+  Result SearchString(const String& subject,
+                      intptr_t start,
+                      bool sticky,
+                      intptr_t* match_start,
+                      intptr_t* match_end);
+  // Returns the end of the match starting at or after [start], or -1.
+  template <typename StringType>
+  intptr_t ScanForward(const String& subject, intptr_t start, bool sticky);
+  // Returns the leftmost start at or after [start] of a match ending at
+  // [end], or -1. Only used on the reversed DFA.
+  template <typename StringType>
+  intptr_t ScanBackward(const String& subject, intptr_t start, intptr_t end);
+
+  intptr_t ClassOf(uint16_t code_unit) const {
+    if (code_unit <= kMaxUint8) {
+      return latin1_classes_[code_unit];
+    }
+    // Binary search for the last boundary at or below [code_unit].
+    intptr_t lo = 0;
+    intptr_t hi = class_bounds_.length() - 1;
+    while (lo < hi) {
+      const intptr_t mid = (lo + hi + 1) >> 1;
+      if (class_bounds_[mid] <= code_unit) {
+        lo = mid;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    return lo;
+  }
+
+  // Computes the closure of the nodes in [work_], given in the order they
+  // are tried, into [set_], following split nodes and start or end of input
+  // assertions whose condition holds.
+  void Closure(bool at_start, bool at_end);
+  // Returns the state for the closure in [set_], or kUnknownState if the
+  // cache is full.
+  intptr_t StateFor();
+  intptr_t StartState(bool sticky, bool at_start);
+  intptr_t Step(intptr_t state, intptr_t klass);
+  bool MatchesAtEnd(intptr_t state, bool at_start);
+  void Flush();
+
+  static void Finalize(void* isolate_callback_data,
+                       Dart_WeakPersistentHandle handle,
+                       void* peer);
+
+  // Whether the forward DFA keeps only the nodes tried before a match. The
+  // reversed DFA keeps all nodes to find the leftmost start.
+  const bool leftmost_first_;
+  // For the forward DFA, the DFA of the reversed pattern.
+  RegExpDFA* reversed_ = nullptr;
+  bool has_exact_end_ = true;
+  bool has_captures_ = false;
+
+  MallocGrowableArray<Node> nodes_;
+  MallocGrowableArray<Range> ranges_;
+  intptr_t entry_ = -1;
+  intptr_t unanchored_entry_ = -1;
+
+  // The lowest code unit of each character class, in ascending order.
+  MallocGrowableArray<int32_t> class_bounds_;
+  uint8_t latin1_classes_[kMaxUint8 + 1];
+
+  MallocGrowableArray<State*> states_;
+  StateMap state_map_;
+  intptr_t max_states_ = 0;
+  intptr_t num_flushes_ = 0;
+  // Start states indexed by 2 * sticky + at_start.
+  intptr_t start_states_[4];
+
+  // Scratch space for computing closures.
+  MallocGrowableArray<intptr_t> work_;
+  MallocGrowableArray<intptr_t> set_;
+  intptr_t* marks_ = nullptr;
+  intptr_t mark_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(RegExpDFA);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_REGEXP_DFA_H_
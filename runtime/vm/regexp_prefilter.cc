@@ -0,0 +1,229 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/regexp_prefilter.h"
+
+#include "vm/flags.h"
+#include "vm/regexp.h"
+#include "vm/regexp_ast.h"
+#include "vm/regexp_parser.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            regexp_prefilter,
+            true,
+            "Skip to occurrences of a literal every match contains before "
+            "running the regexp matcher.");
+
+typedef ZoneGrowableArray<uint16_t> CodeUnits;
+
+// What is known about the strings matched by a RegExpTree.
+struct LiteralInfo {
+  // The only string the tree matches, or nullptr.
+  CodeUnits* exact = nullptr;
+  // The longest known literal every match contains, or nullptr.
+  CodeUnits* required = nullptr;
+  // The offset of [required] from the start of every match, or -1.
+  intptr_t required_offset = -1;
+
+  // Keeps [literal] if it is better than the current required literal.
+  void Consider(CodeUnits* literal, intptr_t offset) {
+    if (literal == nullptr || literal->is_empty()) return;
+    if (required == nullptr || literal->length() > required->length() ||
+        (literal->length() == required->length() && required_offset < 0 &&
+         offset >= 0)) {
+      required = literal;
+      required_offset = offset;
+    }
+  }
+};
+
+// Repetitions of an exact body are only unrolled up to this length.
+static const intptr_t kMaxExactLength = 64;
+
+static CodeUnits* EmptyCodeUnits() {
+  return new CodeUnits(0);
+}
+
+static void Append(CodeUnits* to, CodeUnits* from) {
+  for (intptr_t i = 0; i < from->length(); i++) {
+    to->Add(from->At(i));
+  }
+}
+
+static bool HasFixedLength(RegExpTree* tree) {
+  return tree->min_match() == tree->max_match();
+}
+
+static LiteralInfo Analyze(RegExpTree* tree);
+
+// Analyzes a sequence of trees matched one after the other.
+static LiteralInfo AnalyzeSequence(ZoneGrowableArray<RegExpTree*>* trees) {
+  LiteralInfo result;
+  CodeUnits* run = nullptr;
+  intptr_t run_offset = 0;
+  intptr_t offset = 0;
+  bool all_exact = true;
+  for (intptr_t i = 0; i < trees->length(); i++) {
+    RegExpTree* tree = trees->At(i);
+    LiteralInfo info = Analyze(tree);
+    if (info.exact != nullptr) {
+      if (run == nullptr) {
+        run = EmptyCodeUnits();
+        run_offset = offset;
+      }
+      Append(run, info.exact);
+    } else {
+      all_exact = false;
+      result.Consider(run, run_offset);
+      run = nullptr;
+      result.Consider(info.required,
+                      (offset >= 0 && info.required_offset >= 0)
+                          ? offset + info.required_offset
+                          : -1);
+    }
+    offset = (offset >= 0 && HasFixedLength(tree)) ? offset + tree->min_match()
+                                                   : -1;
+  }
+  if (all_exact) {
+    result.exact = (run != nullptr) ? run : EmptyCodeUnits();
+  }
+  result.Consider(run, run_offset);
+  return result;
+}
+
+static LiteralInfo Analyze(RegExpTree* tree) {
+  LiteralInfo result;
+  if (tree->IsAtom()) {
+    result.exact = EmptyCodeUnits();
+    Append(result.exact, tree->AsAtom()->data());
+    result.Consider(result.exact, 0);
+  } else if (tree->IsText()) {
+    GrowableArray<TextElement>* elements = tree->AsText()->elements();
+    ZoneGrowableArray<RegExpTree*>* trees =
+        new ZoneGrowableArray<RegExpTree*>(elements->length());
+    for (intptr_t i = 0; i < elements->length(); i++) {
+      trees->Add(elements->At(i).tree());
+    }
+    result = AnalyzeSequence(trees);
+  } else if (tree->IsAlternative()) {
+    result = AnalyzeSequence(tree->AsAlternative()->nodes());
+  } else if (tree->IsCharacterClass()) {
+    RegExpCharacterClass* char_class = tree->AsCharacterClass();
+    ZoneGrowableArray<CharacterRange>* ranges = char_class->ranges();
+    if (!char_class->is_negated() && ranges->length() == 1 &&
+        ranges->At(0).IsSingleton() &&
+        ranges->At(0).from() <= Utf16::kMaxCodeUnit) {
+      result.exact = EmptyCodeUnits();
+      result.exact->Add(ranges->At(0).from());
+      result.Consider(result.exact, 0);
+    }
+  } else if (tree->IsQuantifier()) {
+    RegExpQuantifier* quantifier = tree->AsQuantifier();
+    if (quantifier->max() == 0) {
+      result.exact = EmptyCodeUnits();
+    } else if (quantifier->min() > 0) {
+      LiteralInfo body = Analyze(quantifier->body());
+      // The first repetition starts where the quantifier's match starts.
+      result.Consider(body.required, body.required_offset);
+      if (body.exact != nullptr &&
+          body.exact->length() * quantifier->min() <= kMaxExactLength) {
+        CodeUnits* repeated = EmptyCodeUnits();
+        for (intptr_t i = 0; i < quantifier->min(); i++) {
+          Append(repeated, body.exact);
+        }
+        if (quantifier->min() == quantifier->max()) {
+          result.exact = repeated;
+        }
+        result.Consider(repeated, 0);
+      }
+    }
+  } else if (tree->IsCapture()) {
+    result = Analyze(tree->AsCapture()->body());
+  } else if (tree->IsEmpty() || tree->IsAssertion()) {
+    // Matches the empty string, possibly depending on the context.
+    result.exact = EmptyCodeUnits();
+  }
+  // Disjunctions, lookarounds and back references contribute nothing.
+  return result;
+}
+
+StringPtr RegExpPrefilter::RequiredLiteral(RegExpTree* tree,
+                                           RegExpFlags flags,
+                                           intptr_t* offset) {
+  *offset = -1;
+  // Case-insensitive matches do not contain the literal as written.
+  if (flags.IgnoreCase()) {
+    return String::null();
+  }
+  LiteralInfo info = Analyze(tree);
+  if (info.required == nullptr ||
+      info.required->length() < kMinLiteralLength) {
+    return String::null();
+  }
+  *offset = info.required_offset;
+  return String::FromUTF16(info.required->data(), info.required->length(),
+                           Heap::kOld);
+}
+
+void RegExpPrefilter::EnsureLiteral(Zone* zone, const RegExp& regexp) {
+  if (regexp.literal() != Object::null()) {
+    return;
+  }
+  RegExpCompileData compile_data;
+  const String& pattern = String::Handle(zone, regexp.pattern());
+  RegExpParser::ParseRegExp(pattern, regexp.flags(), &compile_data);
+  intptr_t offset = -1;
+  const String& literal = String::Handle(
+      zone, RequiredLiteral(compile_data.tree, regexp.flags(), &offset));
+  if (literal.IsNull()) {
+    regexp.set_literal(Bool::False(), -1);
+  } else {
+    regexp.set_literal(literal, offset);
+  }
+}
+
+bool RegExpPrefilter::Apply(Zone* zone,
+                            const RegExp& regexp,
+                            const String& subject,
+                            bool sticky,
+                            intptr_t* start) {
+  EnsureLiteral(zone, regexp);
+  const Object& literal = Object::Handle(zone, regexp.literal());
+  if (!literal.IsString()) {
+    return true;
+  }
+  const String& str = String::Cast(literal);
+  const intptr_t offset = regexp.literal_offset();
+  const intptr_t length = subject.Length();
+  if (sticky && offset >= 0) {
+    // The literal must occur at a known position.
+    const intptr_t position = *start + offset;
+    if (position + str.Length() > length) {
+      return false;
+    }
+    for (intptr_t i = 0; i < str.Length(); i++) {
+      if (subject.CharAt(position + i) != str.CharAt(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  const intptr_t from = *start + Utils::Maximum<intptr_t>(offset, 0);
+  if (from > length) {
+    return false;
+  }
+  const intptr_t found = subject.IndexOf(str, from);
+  if (found < 0) {
+    return false;
+  }
+  if (!sticky && offset >= 0) {
+    // No match can start before the first occurrence of the literal.
+    *start = found - offset;
+  }
+  return true;
+}
+
+}  // namespace dart
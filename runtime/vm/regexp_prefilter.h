@@ -0,0 +1,50 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_REGEXP_PREFILTER_H_
+#define RUNTIME_VM_REGEXP_PREFILTER_H_
+
+#include "vm/allocation.h"
+#include "vm/object.h"
+
+namespace dart {
+
+class RegExpTree;
+
+// Finds a literal substring that every match of a regular expression
+// contains, and uses a substring search for it to skip input that cannot
+// contain a match before running the matcher.
+//
+// For example every match of /ERROR: (\d+)/ starts with "ERROR: ", so a
+// search may start at the next occurrence of "ERROR: " instead of trying the
+// matcher at every position in between.
+class RegExpPrefilter : public AllStatic {
+ public:
+  // Literals shorter than this are left to the matcher's own lookahead.
+  static const intptr_t kMinLiteralLength = 2;
+
+  // Returns false if [subject] cannot contain a match of [regexp] starting at
+  // or after [*start] (or exactly at [*start] if [sticky] is true).
+  // Otherwise returns true, and may advance [*start] to the first position
+  // at which a match can start.
+  static bool Apply(Zone* zone,
+                    const RegExp& regexp,
+                    const String& subject,
+                    bool sticky,
+                    intptr_t* start);
+
+  // Computes the literal of [regexp] if it has not been computed yet.
+  static void EnsureLiteral(Zone* zone, const RegExp& regexp);
+
+  // Returns the longest literal every match of [tree] contains, or null if
+  // there is none, and sets [offset] to its offset from the start of every
+  // match, or -1 if the offset varies.
+  static StringPtr RequiredLiteral(RegExpTree* tree,
+                                   RegExpFlags flags,
+                                   intptr_t* offset);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_REGEXP_PREFILTER_H_
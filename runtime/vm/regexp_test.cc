@@ -7,7 +7,11 @@
 #include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/regexp.h"
+#include "vm/regexp_assembler_bytecode.h"
 #include "vm/regexp_assembler_ir.h"
+#include "vm/regexp_dfa.h"
+#include "vm/regexp_parser.h"
+#include "vm/regexp_prefilter.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -110,4 +114,227 @@ ISOLATE_UNIT_TEST_CASE(RegExp_ExternalTwoByteString) {
   EXPECT_EQ(3, smi_2.Value());
 }
 
+static void ExpectSameAsBacktracking(const char* pattern,
+                                     const char* subject,
+                                     intptr_t start = 0) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  const String& pat = String::Handle(String::New(pattern));
+  const String& str = String::Handle(String::New(subject));
+  const RegExp& regexp =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  RegExpDFA* dfa = RegExpDFA::For(zone, regexp);
+  EXPECT(dfa != nullptr);
+  if (dfa == nullptr) return;
+  const Smi& idx = Smi::Handle(Smi::New(start));
+  for (intptr_t i = 0; i < 2; i++) {
+    const bool sticky = i == 1;
+    const Object& result = Object::Handle(IRRegExpMacroAssembler::Execute(
+        regexp, str, idx, sticky, zone));
+    intptr_t match_start = -1;
+    intptr_t match_end = -1;
+    const RegExpDFA::Result found =
+        dfa->Search(str, start, sticky, &match_start, &match_end);
+    bool same;
+    if (result.IsNull()) {
+      same = found == RegExpDFA::kNoMatch;
+    } else {
+      const TypedData& match = TypedData::Cast(result);
+      same = (found == RegExpDFA::kMatch) &&
+             (match_start == match.GetInt32(0)) &&
+             (!dfa->has_exact_end() ||
+              (match_end == match.GetInt32(sizeof(int32_t))));
+    }
+    if (!same) {
+      dart::Expect(__FILE__, __LINE__)
+          .Fail("/%s/ on \"%s\" from %" Pd " (sticky: %d)", pattern, subject,
+                start, sticky);
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_DFA) {
+  ExpectSameAsBacktracking("bc", "abcba");
+  ExpectSameAsBacktracking("bc", "abcba", 2);
+  ExpectSameAsBacktracking("bd", "abcba");
+  ExpectSameAsBacktracking("", "");
+  ExpectSameAsBacktracking("^$", "");
+  ExpectSameAsBacktracking("^$", "a");
+  ExpectSameAsBacktracking("^a", "ba");
+  ExpectSameAsBacktracking("^a", "ab");
+  ExpectSameAsBacktracking("^b", "ab", 1);
+  ExpectSameAsBacktracking("a$", "ab");
+  ExpectSameAsBacktracking("b$", "ab");
+  ExpectSameAsBacktracking("a|bc|d", "xxbxcx");
+  ExpectSameAsBacktracking("a|bc|d", "xxbcx");
+  ExpectSameAsBacktracking("x(a|b)*y", "xababababy");
+  ExpectSameAsBacktracking("x(a|b)*y", "xababababz");
+  ExpectSameAsBacktracking("x(a|b)+y", "xy");
+  ExpectSameAsBacktracking("a{2,3}b", "aab");
+  ExpectSameAsBacktracking("a{2,3}b", "ab");
+  ExpectSameAsBacktracking("^a{2,3}b", "aaaab");
+  ExpectSameAsBacktracking("(a*)*b", "aaaaaaaaaaaaaaaaaaaaaaaa");
+  ExpectSameAsBacktracking("[0-9]+-[^0-9]", "123-a");
+  ExpectSameAsBacktracking("[0-9]+-[^0-9]", "123-4");
+  ExpectSameAsBacktracking("\\d\\s\\w.", "1 a\n");
+  ExpectSameAsBacktracking("\\d\\s\\w.", "1 a!");
+  // Match positions follow the order in which alternatives and quantifiers
+  // are tried.
+  ExpectSameAsBacktracking("a|ab", "xab");
+  ExpectSameAsBacktracking("ab|a", "xab");
+  ExpectSameAsBacktracking("a+", "baaab");
+  ExpectSameAsBacktracking("a+?", "baaab");
+  ExpectSameAsBacktracking("a*?b", "baaab", 1);
+  ExpectSameAsBacktracking("a{2,4}?", "aaaaa");
+  ExpectSameAsBacktracking("(a|b)*c", "ababababc");
+  ExpectSameAsBacktracking("b*$", "abba");
+  ExpectSameAsBacktracking("abcd|c", "xabcd");
+  ExpectSameAsBacktracking("c|abcd", "xabcd");
+  ExpectSameAsBacktracking("b*", "abb", 1);
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_DFA_ExactEnd) {
+  struct {
+    const char* pattern;
+    bool has_exact_end;
+    bool has_captures;
+  } cases[] = {
+      {"a+b", true, false},
+      {"(a+)b", true, true},
+      {"a{0,2}", true, false},
+      {"(?:a|)*b", false, false},
+      {"(?:b{0,2}?)?", false, false},
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+    const String& pat = String::Handle(String::New(cases[i].pattern));
+    const RegExp& regexp =
+        RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+    RegExpDFA* dfa = RegExpDFA::For(thread->zone(), regexp);
+    EXPECT(dfa != nullptr);
+    if (dfa == nullptr) continue;
+    EXPECT_EQ(cases[i].has_exact_end, dfa->has_exact_end());
+    EXPECT_EQ(cases[i].has_captures, dfa->has_captures());
+  }
+  // The start is exact even where the end is not: the backtracking matcher
+  // matches "b" here, as it rejects the empty second iteration of b{0,2}?.
+  ExpectSameAsBacktracking("(?:b{0,2}?)?", "bc");
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_DFA_Unsupported) {
+  const char* patterns[] = {"(a)\\1", "a(?=b)", "\\bword", "^a"};
+  for (size_t i = 0; i < ARRAY_SIZE(patterns); i++) {
+    const String& pat = String::Handle(String::New(patterns[i]));
+    const RegExp& regexp =
+        RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+    const bool supported = i == 3;
+    EXPECT_EQ(supported, RegExpDFA::For(thread->zone(), regexp) != nullptr);
+  }
+  RegExpFlags ignore_case;
+  ignore_case.SetIgnoreCase();
+  const String& pat = String::Handle(String::New("a"));
+  const RegExp& regexp =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, ignore_case));
+  EXPECT(RegExpDFA::For(thread->zone(), regexp) == nullptr);
+}
+
+static void ExpectRequiredLiteral(const char* pattern,
+                                  const char* expected,
+                                  intptr_t expected_offset) {
+  RegExpCompileData compile_data;
+  const String& pat = String::Handle(String::New(pattern));
+  RegExpParser::ParseRegExp(pat, RegExpFlags(), &compile_data);
+  intptr_t offset = -2;
+  const String& literal = String::Handle(RegExpPrefilter::RequiredLiteral(
+      compile_data.tree, RegExpFlags(), &offset));
+  if (expected == nullptr) {
+    EXPECT(literal.IsNull());
+    EXPECT_EQ(-1, offset);
+  } else {
+    EXPECT_STREQ(expected, literal.IsNull() ? "<null>" : literal.ToCString());
+    EXPECT_EQ(expected_offset, offset);
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_RequiredLiteral) {
+  ExpectRequiredLiteral("ERROR: (\\d+)", "ERROR: ", 0);
+  ExpectRequiredLiteral("^GET (/\\S*) HTTP", " HTTP", -1);
+  ExpectRequiredLiteral("\\d{4}-error", "-error", 4);
+  ExpectRequiredLiteral("x+hello", "hello", -1);
+  ExpectRequiredLiteral("(ab){3}c", "abababc", 0);
+  ExpectRequiredLiteral("a(bc)+d", "bc", 1);
+  ExpectRequiredLiteral("[x]yz?", "xy", 0);
+  ExpectRequiredLiteral("a|bc", nullptr, -1);
+  ExpectRequiredLiteral("a.b", nullptr, -1);
+  ExpectRequiredLiteral("(?:ab)?", nullptr, -1);
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_Prefilter) {
+  const String& pat = String::Handle(String::New("ERROR: (\\d+)"));
+  const RegExp& regexp =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  const String& subject =
+      String::Handle(String::New("INFO: 1\nERROR: x\nERROR: 42\n"));
+  intptr_t start = 0;
+  EXPECT(RegExpPrefilter::Apply(thread->zone(), regexp, subject,
+                                /*sticky=*/false, &start));
+  EXPECT_EQ(8, start);
+  start = 9;
+  EXPECT(RegExpPrefilter::Apply(thread->zone(), regexp, subject,
+                                /*sticky=*/false, &start));
+  EXPECT_EQ(17, start);
+  start = 18;
+  EXPECT(!RegExpPrefilter::Apply(thread->zone(), regexp, subject,
+                                 /*sticky=*/false, &start));
+  start = 8;
+  EXPECT(RegExpPrefilter::Apply(thread->zone(), regexp, subject,
+                                /*sticky=*/true, &start));
+  EXPECT_EQ(8, start);
+  start = 9;
+  EXPECT(!RegExpPrefilter::Apply(thread->zone(), regexp, subject,
+                                 /*sticky=*/true, &start));
+}
+
+ISOLATE_UNIT_TEST_CASE(RegExp_CompiledRegExpCache) {
+  const String& pat = String::Handle(String::New("(a|b)+c\\d"));
+  const String& str = String::Handle(String::New("xxababc1"));
+  IsolateGroup* group = thread->isolate_group();
+  const intptr_t hits = group->regexp_cache_hits();
+  const intptr_t misses = group->regexp_cache_misses();
+
+  const RegExp& first =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  Object& result = Object::Handle(BytecodeRegExpMacroAssembler::Interpret(
+      first, str, Object::smi_zero(), /*is_sticky=*/false, thread->zone()));
+  EXPECT(result.IsTypedData());
+  EXPECT_EQ(hits, group->regexp_cache_hits());
+  EXPECT_EQ(misses + 1, group->regexp_cache_misses());
+
+  // A regexp with the same pattern and flags reuses the bytecode.
+  const RegExp& second =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  result = BytecodeRegExpMacroAssembler::Interpret(
+      second, str, Object::smi_zero(), /*is_sticky=*/false, thread->zone());
+  EXPECT(result.IsTypedData());
+  EXPECT_EQ(hits + 1, group->regexp_cache_hits());
+  EXPECT_EQ(misses + 1, group->regexp_cache_misses());
+  EXPECT(first.bytecode(/*is_one_byte=*/true, /*sticky=*/false) ==
+         second.bytecode(/*is_one_byte=*/true, /*sticky=*/false));
+  EXPECT(second.num_bracket_expressions() == Smi::New(1));
+
+  // Other specializations and flags are compiled separately.
+  result = BytecodeRegExpMacroAssembler::Interpret(
+      second, str, Object::smi_zero(), /*is_sticky=*/true, thread->zone());
+  EXPECT(result.IsNull());
+  EXPECT_EQ(misses + 2, group->regexp_cache_misses());
+  RegExpFlags multi_line;
+  multi_line.SetMultiLine();
+  const RegExp& third =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, multi_line));
+  result = BytecodeRegExpMacroAssembler::Interpret(
+      third, str, Object::smi_zero(), /*is_sticky=*/false, thread->zone());
+  EXPECT(result.IsTypedData());
+  EXPECT_EQ(hits + 1, group->regexp_cache_hits());
+  EXPECT_EQ(misses + 3, group->regexp_cache_misses());
+}
+
 }  // namespace dart
@@ -27,6 +27,7 @@
 #include "vm/malloc_hooks.h"
 #include "vm/message.h"
 #include "vm/message_handler.h"
+#include "vm/message_snapshot.h"
 #include "vm/native_arguments.h"
 #include "vm/native_entry.h"
 #include "vm/native_symbol.h"
@@ -1487,6 +1488,18 @@ static bool GetIsolateGroupMemoryUsage(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_compiler_pass_stats_params[] = {
+    ISOLATE_GROUP_PARAMETER,
+    NULL,
+};
+
+static bool GetCompilerPassStats(Thread* thread, JSONStream* js) {
+  ActOnIsolateGroup(js, [&](IsolateGroup* isolate_group) {
+    isolate_group->PrintCompilerPassStatsJSON(js);
+  });
+  return true;
+}
+
 static const MethodParameter* get_scripts_params[] = {
     RUNNABLE_ISOLATE_PARAMETER,
     NULL,
@@ -1976,8 +1989,7 @@ static ObjectPtr LookupHeapObjectMessage(Thread* thread,
   if (message->IsRaw()) {
     return message->raw_obj();
   } else {
-    MessageSnapshotReader reader(message, thread);
-    return reader.ReadObject();
+    return ReadMessage(thread, message);
   }
 }
 
@@ -4894,6 +4906,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
       get_native_allocation_samples_params },
   { "getClassList", GetClassList,
     get_class_list_params },
+  { "_getCompilerPassStats", GetCompilerPassStats,
+    get_compiler_pass_stats_params },
   { "getCpuSamples", GetCpuSamples,
     get_cpu_samples_params },
   { "getFlagList", GetFlagList,
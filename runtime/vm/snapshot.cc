@@ -1585,10 +1585,7 @@ MessageWriter::~MessageWriter() {
   delete finalizable_data_;
 }
 
-std::unique_ptr<Message> MessageWriter::WriteMessage(
-    const Object& obj,
-    Dart_Port dest_port,
-    Message::Priority priority) {
+bool MessageWriter::TryWriteObject(const Object& obj) {
   ASSERT(kind() == Snapshot::kMessage);
   ASSERT(isolate() != NULL);
 
@@ -1605,11 +1602,36 @@ std::unique_ptr<Message> MessageWriter::WriteMessage(
       has_exception = true;
     }
   }
-  if (has_exception) {
-    ThrowException(exception_type(), exception_msg());
-  } else {
+  if (!has_exception) {
     finalizable_data_->SerializationSucceeded();
   }
+  return !has_exception;
+}
+
+std::unique_ptr<Message> MessageWriter::WriteMessage(
+    const Object& obj,
+    Dart_Port dest_port,
+    Message::Priority priority) {
+  if (!TryWriteObject(obj)) {
+    ThrowException(exception_type(), exception_msg());
+  }
+
+  MessageFinalizableData* finalizable_data = finalizable_data_;
+  finalizable_data_ = NULL;
+  return Message::New(dest_port, buffer(), BytesWritten(), finalizable_data,
+                      priority);
+}
+
+std::unique_ptr<Message> MessageWriter::TryWriteMessage(
+    const Object& obj,
+    Dart_Port dest_port,
+    Message::Priority priority) {
+  if (!TryWriteObject(obj)) {
+    NoSafepointScope no_safepoint;
+    ErrorPtr error = thread()->StealStickyError();
+    ASSERT(error == Object::snapshot_writer_error().raw());
+    return nullptr;
+  }
 
   MessageFinalizableData* finalizable_data = finalizable_data_;
   finalizable_data_ = NULL;
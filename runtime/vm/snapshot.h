@@ -719,9 +719,19 @@ class MessageWriter : public SnapshotWriter {
                                         Dart_Port dest_port,
                                         Message::Priority priority);
 
+  // Like WriteMessage, but returns nullptr instead of throwing if [obj]
+  // cannot be written.
+  std::unique_ptr<Message> TryWriteMessage(const Object& obj,
+                                           Dart_Port dest_port,
+                                           Message::Priority priority);
+
   MessageFinalizableData* finalizable_data() const { return finalizable_data_; }
 
  private:
+  // Returns false if [obj] cannot be written. The reason is left in
+  // exception_type() and exception_msg().
+  bool TryWriteObject(const Object& obj);
+
   ForwardList forward_list_;
   MessageFinalizableData* finalizable_data_;
 
@@ -781,6 +781,67 @@ VM_UNIT_TEST_CASE(FullSnapshot) {
   free(isolate_snapshot_data_buffer);
 }
 
+static void GetClassLocation(const char* class_name,
+                             intptr_t* line,
+                             intptr_t* column,
+                             bool* has_external_line_starts) {
+  Thread* thread = Thread::Current();
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HandleScope scope(thread);
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(TestCase::lib())));
+  const Class& cls = Class::Handle(
+      lib.LookupClass(String::Handle(String::New(class_name))));
+  EXPECT(!cls.IsNull());
+  const Script& script = Script::Handle(cls.script());
+  script.GetTokenLocation(cls.token_pos(), line, column);
+  *has_external_line_starts =
+      TypedDataBase::Handle(script.line_starts()).IsExternalTypedData();
+}
+
+VM_UNIT_TEST_CASE(FullSnapshotLazyLineStarts) {
+  const char* kScriptChars =
+      "class A {}\n"
+      "\n"
+      "  class B {}\n";
+  intptr_t line = -1;
+  intptr_t column = -1;
+  bool has_external_line_starts = true;
+  uint8_t* isolate_snapshot_data_buffer;
+  {
+    TestIsolateScope __test_isolate__;
+    TestCase::LoadTestScript(kScriptChars, NULL);
+    GetClassLocation("B", &line, &column, &has_external_line_starts);
+    EXPECT_EQ(3, line);
+    EXPECT(!has_external_line_starts);
+
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+    FullSnapshotWriter writer(Snapshot::kFull, NULL,
+                              &isolate_snapshot_data_buffer, &malloc_allocator,
+                              NULL, /*image_writer*/ nullptr);
+    writer.WriteFullSnapshot();
+  }
+
+  // The line starts of the script are read in place from the snapshot.
+  TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot_data_buffer);
+  {
+    Dart_EnterScope();
+    const intptr_t expected_column = column;
+    line = column = -1;
+    GetClassLocation("B", &line, &column, &has_external_line_starts);
+    EXPECT_EQ(3, line);
+    EXPECT_EQ(expected_column, column);
+    EXPECT(has_external_line_starts);
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(isolate_snapshot_data_buffer);
+}
+
 // Helper function to call a top level Dart function and serialize the result.
 static std::unique_ptr<Message> GetSerialized(Dart_Handle lib,
                                               const char* dart_function) {
@@ -188,7 +188,231 @@ class SymbolTraits {
     return concat.ToSymbol();
   }
 };
-typedef UnorderedHashSet<SymbolTraits> SymbolTable;
+// The symbol table of an isolate group is searched without holding a lock,
+// while other threads may insert symbols into it:
+//  - Symbols are stored into unused entries with release semantics, after
+//    they have been fully initialized. Symbols are never removed.
+//  - The table grows incrementally. A grown table refers to the table it
+//    replaced in its metadata, and each insertion moves a few entries of the
+//    replaced table into the grown one. Lookups search the grown table and
+//    then the replaced one, which is not modified after it has been replaced.
+class SymbolTable : public UnorderedHashSet<SymbolTraits, 2> {
+ public:
+  typedef UnorderedHashSet<SymbolTraits, 2> BaseSet;
+
+  // A grown table has room for more insertions than the table it replaced
+  // has entries divided by this, so all entries have been moved before the
+  // grown table needs to grow again.
+  static const intptr_t kEntriesMovedPerInsertion = 16;
+
+  explicit SymbolTable(ArrayPtr data) : BaseSet(data) {}
+  SymbolTable(Zone* zone, ArrayPtr data) : BaseSet(zone, data) {}
+  SymbolTable(Object* key, Smi* value, Array* data)
+      : BaseSet(key, value, data) {}
+
+  // The table this table replaced and still has to move entries out of, or
+  // null. It has to be read before searching this table.
+  ArrayPtr ReplacedTable() const {
+    const ObjectPtr table = data_->AtAcquire(kReplacedTableIndex);
+    return table->IsArray() ? Array::RawCast(table) : Array::null();
+  }
+
+  void SetReplacedTable(const Array& table) const {
+    ASSERT(NumOccupied() == 0);
+    data_->SetAt(kReplacedTableIndex, table);
+    SetSmiValueAt(kNextEntryIndex, 0);
+  }
+
+  bool NeedsToGrow() const {
+    static const double kMaxLoadFactor = 0.71;
+    return (1 + NumOccupied() + NumDeleted()) >=
+           kMaxLoadFactor * NumEntries();
+  }
+
+  // Moves up to [count] entries of the replaced table into this table.
+  void MoveEntries(intptr_t count) const {
+    Zone* zone = Thread::Current()->zone();
+    SymbolTable replaced(zone, ReplacedTable());
+    if (replaced.data_->IsNull()) {
+      replaced.Release();
+      return;
+    }
+    const intptr_t num_entries = replaced.NumEntries();
+    intptr_t next = GetSmiValueAt(kNextEntryIndex);
+    const intptr_t end = Utils::Minimum(num_entries, next + count);
+    Object& symbol = Object::Handle(zone);
+    for (; next < end; next++) {
+      if (replaced.IsOccupied(next)) {
+        symbol = replaced.GetKey(next);
+        intptr_t entry = -1;
+        const bool present = FindKeyOrDeletedOrUnused(symbol, &entry);
+        ASSERT(!present);
+        PublishKey(entry, symbol);
+      }
+    }
+    replaced.Release();
+    SetSmiValueAt(kNextEntryIndex, next);
+    if (next == num_entries) {
+      // Lookups that see this have to find all moved entries in this table.
+      data_->SetAtRelease(kReplacedTableIndex, Object::null_object());
+    }
+  }
+
+  // The number of symbols in this table and in the entries of the replaced
+  // table that have not been moved yet.
+  intptr_t NumSymbols() const {
+    intptr_t count = NumOccupied();
+    SymbolTable replaced(Thread::Current()->zone(), ReplacedTable());
+    if (!replaced.data_->IsNull()) {
+      const intptr_t num_entries = replaced.NumEntries();
+      for (intptr_t i = GetSmiValueAt(kNextEntryIndex); i < num_entries; i++) {
+        if (replaced.IsOccupied(i)) {
+          count++;
+        }
+      }
+    }
+    replaced.Release();
+    return count;
+  }
+
+  // Like GetOrNull, but may run concurrently with insertions.
+  template <typename Key>
+  ObjectPtr GetOrNullConcurrent(const Key& key) const {
+    const intptr_t entry = FindKey<Key, /*kAcquireKeys=*/true>(key);
+    return (entry == -1) ? Object::null() : GetKeyAcquire(entry);
+  }
+
+  // Lookups compare the hash and characters of the symbols they find, so the
+  // load of a key has to acquire what PublishKey released. Otherwise a weakly
+  // ordered CPU may show a lookup the symbol before its contents.
+  ObjectPtr GetKeyAcquire(intptr_t entry) const {
+    return InternalGetKeyAcquire(entry);
+  }
+
+  // Like InsertKey, but only makes [key] visible to concurrent lookups
+  // after it has been fully initialized.
+  void PublishKey(intptr_t entry, const Object& key) const {
+    ASSERT(IsUnused(entry));
+    AdjustSmiValueAt(kOccupiedEntriesIndex, 1);
+    UpdateHashTag(entry, key);
+    data_->SetAtRelease(KeyIndex(entry), key);
+  }
+
+ private:
+  static const intptr_t kReplacedTableIndex = kMetaDataIndex;
+  static const intptr_t kNextEntryIndex = kMetaDataIndex + 1;
+};
+
+// Returns the symbol equal to [str] in the symbol table [table_data] or the
+// table it replaced, or null. May run concurrently with insertions.
+template <typename StringType>
+static StringPtr LookupSymbol(Object* key,
+                              Smi* value,
+                              Array* data,
+                              ArrayPtr table_data,
+                              const StringType& str) {
+  ArrayPtr replaced;
+  ObjectPtr symbol;
+  {
+    *data = table_data;
+    SymbolTable table(key, value, data);
+    replaced = table.ReplacedTable();
+    symbol = table.GetOrNullConcurrent(str);
+    table.Release();
+  }
+  if (symbol == Object::null() && replaced != Array::null()) {
+    *data = replaced;
+    SymbolTable table(key, value, data);
+    symbol = table.GetOrNullConcurrent(str);
+    table.Release();
+  }
+  return String::RawCast(symbol);
+}
+
+// Inserts [symbol] into the symbol table of [object_store], unless the table
+// grew past [grown], in which case the capacity of the table to grow into is
+// returned.
+static intptr_t TryInsertSymbol(ObjectStore* object_store,
+                                Object* key,
+                                Smi* value,
+                                Array* data,
+                                const String& symbol,
+                                const Array& grown) {
+  *data = object_store->symbol_table();
+  SymbolTable table(key, value, data);
+  table.MoveEntries(SymbolTable::kEntriesMovedPerInsertion);
+  if (table.NeedsToGrow()) {
+    // Normally all entries have already been moved.
+    table.MoveEntries(kIntptrMax);
+    const intptr_t capacity = table.NumOccupied() * 2 + 1;
+    if (grown.IsNull() ||
+        grown.Length() < SymbolTable::ArrayLengthForNumOccupied(capacity)) {
+      table.Release();
+      return capacity;
+    }
+    {
+      SymbolTable grown_table(Thread::Current()->zone(), grown.raw());
+      grown_table.SetReplacedTable(*data);
+      grown_table.Release();
+    }
+    table.Release();
+    *data = grown.raw();
+    object_store->set_symbol_table_release(*data);
+    SymbolTable grown_table(key, value, data);
+    intptr_t entry = -1;
+    const bool present = grown_table.FindKeyOrDeletedOrUnused(symbol, &entry);
+    ASSERT(!present);
+    grown_table.PublishKey(entry, symbol);
+    grown_table.Release();
+    return 0;
+  }
+  intptr_t entry = -1;
+  const bool present = table.FindKeyOrDeletedOrUnused(symbol, &entry);
+  ASSERT(!present);
+  table.PublishKey(entry, symbol);
+  table.Release();
+  return 0;
+}
+
+// Returns the symbol equal to [str] in the symbol table of [object_store],
+// adding a new one if there is none. The caller either holds the symbols
+// mutex of the isolate group, or owns a safepoint operation.
+template <typename StringType>
+static StringPtr InsertSymbol(Thread* thread,
+                              ObjectStore* object_store,
+                              const StringType& str) {
+  Zone* zone = thread->zone();
+  Object& key = Object::Handle(zone);
+  Smi& value = Smi::Handle(zone);
+  Array& data = Array::Handle(zone);
+  String& symbol = String::Handle(zone);
+  Array& grown = Array::Handle(zone);
+  while (true) {
+    intptr_t capacity = 0;
+    {
+      // Other threads only insert symbols while this thread is at a
+      // safepoint, so the table does not change until the symbol is stored.
+      NoSafepointScope no_safepoint;
+      StringPtr existing = LookupSymbol(&key, &value, &data,
+                                        object_store->symbol_table(), str);
+      if (existing != String::null()) {
+        return existing;
+      }
+      if (!symbol.IsNull()) {
+        capacity =
+            TryInsertSymbol(object_store, &key, &value, &data, symbol, grown);
+        if (capacity == 0) {
+          return symbol.raw();
+        }
+      }
+    }
+    if (symbol.IsNull()) {
+      symbol ^= SymbolTraits::NewKey(str);
+    } else {
+      grown = HashTables::New<SymbolTable>(capacity, Heap::kOld);
+    }
+  }
+}
 
 const char* Symbols::Name(SymbolId symbol) {
   ASSERT((symbol > kIllegal) && (symbol < kNullCharId));
@@ -431,7 +655,7 @@ void Symbols::Compact() {
 void Symbols::GetStats(Isolate* isolate, intptr_t* size, intptr_t* capacity) {
   ASSERT(isolate != NULL);
   SymbolTable table(isolate->object_store()->symbol_table());
-  *size = table.NumOccupied();
+  *size = table.NumSymbols();
   *capacity = table.NumEntries();
   table.Release();
 }
@@ -610,59 +834,28 @@ StringPtr Symbols::NewSymbol(Thread* thread, const StringType& str) {
     ObjectStore* object_store = group->object_store() == nullptr
                                     ? isolate->object_store()
                                     : group->object_store();
-    if (thread->IsAtSafepoint()) {
-      // There are two cases where we can cause symbol allocation while holding
-      // a safepoint:
-      //    - FLAG_enable_isolate_groups in AOT due to the usage of
-      //      `RunWithStoppedMutators` in SwitchableCall runtime entry.
-      //    - non-PRODUCT mode where the vm-service uses a HeapIterationScope
-      //      while building instances
-      // Ideally we should get rid of both cases to avoid this unsafe usage of
-      // the symbol table (we are assuming here that no other thread holds the
-      // symbols_lock).
-      // TODO(https://dartbug.com/41943): Get rid of the symbol table accesses
-      // within safepoint operation scope.
-      RELEASE_ASSERT(group->safepoint_handler()->IsOwnedByTheThread(thread));
-      RELEASE_ASSERT(FLAG_enable_isolate_groups || !USING_PRODUCT);
-
-      // Uncommon case: We are at a safepoint, all mutators are stopped and we
-      // have therefore exclusive access to the symbol table.
-      data = object_store->symbol_table();
-      SymbolTable table(&key, &value, &data);
-      symbol ^= table.InsertNewOrGet(str);
-      object_store->set_symbol_table(table.Release());
-    } else {
-      // Most common case: We are not at a safepoint and the symbol is available
-      // in the symbol table: We require only read access.
-      {
-        SafepointReadRwLocker sl(thread, group->symbols_lock());
-        data = object_store->symbol_table();
-        SymbolTable table(&key, &value, &data);
-        symbol ^= table.GetOrNull(str);
-        table.Release();
-      }
-      // Second common case: We are not at a safepoint and the symbol is not
-      // available in the symbol table: We require only exclusive access.
-      if (symbol.IsNull()) {
-        auto insert_or_get = [&]() {
-          data = object_store->symbol_table();
-          SymbolTable table(&key, &value, &data);
-          symbol ^= table.InsertNewOrGet(str);
-          object_store->set_symbol_table(table.Release());
-        };
-
-        SafepointWriteRwLocker sl(thread, group->symbols_lock());
-        if (FLAG_enable_isolate_groups || !USING_PRODUCT) {
-          // NOTE: Strictly speaking we should use a safepoint operation scope
-          // here to ensure the lock-free usage inside safepoint operations (see
-          // above) is safe. Though this would really kill the performance.
-          // TODO(https://dartbug.com/41943): Get rid of the symbol table
-          // accesses within safepoint operation scope.
-          group->RunWithStoppedMutators(insert_or_get,
-                                        /*force_heap_growth=*/true);
-        } else {
-          insert_or_get();
-        }
+    // Most common case: the symbol is already in the symbol table, which is
+    // searched without holding a lock.
+    symbol = LookupSymbol(&key, &value, &data,
+                          object_store->symbol_table_acquire(), str);
+    if (symbol.IsNull()) {
+      if (thread->IsAtSafepoint()) {
+        // There are two cases where we can cause symbol allocation while
+        // holding a safepoint:
+        //    - FLAG_enable_isolate_groups in AOT due to the usage of
+        //      `RunWithStoppedMutators` in SwitchableCall runtime entry.
+        //    - non-PRODUCT mode where the vm-service uses a
+        //      HeapIterationScope while building instances
+        // All other mutators are stopped and none of them is in the middle of
+        // an insertion (see InsertSymbol), so the symbols mutex is not needed.
+        RELEASE_ASSERT(group->safepoint_handler()->IsOwnedByTheThread(thread));
+        RELEASE_ASSERT(FLAG_enable_isolate_groups || !USING_PRODUCT);
+        symbol = InsertSymbol(thread, object_store, str);
+      } else {
+        // Insertions are serialized by the symbols mutex, but do not stop
+        // concurrent lookups.
+        SafepointMutexLocker ml(group->symbols_mutex());
+        symbol = InsertSymbol(thread, object_store, str);
       }
     }
   }
@@ -694,26 +887,9 @@ StringPtr Symbols::Lookup(Thread* thread, const StringType& str) {
     ObjectStore* object_store = group->object_store() == nullptr
                                     ? isolate->object_store()
                                     : group->object_store();
-    // See `Symbols::NewSymbol` for more information why we separate the two
-    // cases.
-    if (thread->IsAtSafepoint()) {
-      RELEASE_ASSERT(group->safepoint_handler()->IsOwnedByTheThread(thread));
-      // In DEBUG mode the snapshot writer also calls this method inside a
-      // safepoint.
-#if !defined(DEBUG)
-      RELEASE_ASSERT(FLAG_enable_isolate_groups || !USING_PRODUCT);
-#endif
-      data = object_store->symbol_table();
-      SymbolTable table(&key, &value, &data);
-      symbol ^= table.GetOrNull(str);
-      table.Release();
-    } else {
-      SafepointReadRwLocker sl(thread, group->symbols_lock());
-      data = object_store->symbol_table();
-      SymbolTable table(&key, &value, &data);
-      symbol ^= table.GetOrNull(str);
-      table.Release();
-    }
+    // Lookups do not need the symbols mutex, see `Symbols::NewSymbol`.
+    symbol = LookupSymbol(&key, &value, &data,
+                          object_store->symbol_table_acquire(), str);
   }
   ASSERT(symbol.IsNull() || symbol.IsSymbol());
   ASSERT(symbol.IsNull() || symbol.HasHash());
@@ -14,6 +14,20 @@ DEFINE_FLAG(int,
             worker_timeout_millis,
             5000,
             "Free workers when they have been idle for this amount of time.");
+DEFINE_FLAG(bool,
+            worker_local_queues,
+            true,
+            "Run tasks scheduled by a worker of a mutator thread pool on that "
+            "worker first.");
+DEFINE_FLAG(int,
+            worker_steal_delay_micros,
+            50,
+            "How long a task queued on a busy worker waits before idle "
+            "workers may steal it.");
+
+// The number of tasks a worker runs from its own queue before it looks at
+// the shared queue again.
+static const intptr_t kMaxLocalTasksInARow = 64;
 
 static int64_t ComputeTimeout(int64_t idle_start) {
   int64_t worker_timeout_micros =
@@ -34,8 +48,10 @@ static int64_t ComputeTimeout(int64_t idle_start) {
   }
 }
 
-ThreadPool::ThreadPool(uintptr_t max_pool_size)
-    : all_workers_dead_(false), max_pool_size_(max_pool_size) {}
+ThreadPool::ThreadPool(uintptr_t max_pool_size, bool use_worker_queues)
+    : all_workers_dead_(false),
+      max_pool_size_(max_pool_size),
+      use_worker_queues_(use_worker_queues) {}
 
 ThreadPool::~ThreadPool() {
   Shutdown();
@@ -82,6 +98,10 @@ void ThreadPool::Shutdown() {
 }
 
 bool ThreadPool::RunImpl(std::unique_ptr<Task> task) {
+  if (use_worker_queues_ && FLAG_worker_local_queues &&
+      ScheduleOnCurrentWorker(&task)) {
+    return true;
+  }
   Worker* new_worker = nullptr;
   {
     MonitorLocker ml(&pool_monitor_);
@@ -110,17 +130,23 @@ void ThreadPool::MarkCurrentWorkerAsBlocked() {
     MonitorLocker ml(&pool_monitor_);
     ASSERT(!worker->is_blocked_);
     worker->is_blocked_ = true;
+    // Tasks queued on this worker would otherwise wait until it unblocks.
+    const intptr_t moved_tasks =
+        worker->pool_ == this ? MoveLocalTasksLocked(worker) : 0;
     if (max_pool_size_ > 0) {
       ++max_pool_size_;
-      // This thread is blocked and therefore no longer usable as a worker.
-      // If we have pending tasks and there are no idle workers, we will spawn a
-      // new thread (temporarily allow exceeding the maximum pool size) to
-      // handle the pending tasks.
-      if (idle_workers_.IsEmpty() && pending_tasks_ > 0) {
-        new_worker = new Worker(this);
-        idle_workers_.Append(new_worker);
-        count_idle_++;
-      }
+    }
+    // This thread is blocked and therefore no longer usable as a worker.
+    // If we have pending tasks and there are no idle workers, we will spawn a
+    // new thread (temporarily allow exceeding the maximum pool size) to
+    // handle the pending tasks.
+    if ((max_pool_size_ > 0 || moved_tasks > 0) && idle_workers_.IsEmpty() &&
+        pending_tasks_ > 0) {
+      new_worker = new Worker(this);
+      idle_workers_.Append(new_worker);
+      count_idle_++;
+    } else if (moved_tasks > 0) {
+      ml.NotifyAll();
     }
   }
   if (new_worker != nullptr) {
@@ -149,23 +175,37 @@ void ThreadPool::WorkerLoop(Worker* worker) {
   while (true) {
     MonitorLocker ml(&pool_monitor_);
 
-    if (!tasks_.IsEmpty()) {
+    std::unique_ptr<Task> task = TakeTaskLocked(worker);
+    if (task != nullptr) {
       IdleToRunningLocked(worker);
-      while (!tasks_.IsEmpty()) {
-        std::unique_ptr<Task> task(tasks_.RemoveFirst());
-        pending_tasks_--;
-        MonitorLeaveScope mls(&ml);
-        task->Run();
-        ASSERT(Isolate::Current() == nullptr);
-        task.reset();
+      Worker* new_worker = EnsureStealingWorkerLocked(&ml);
+      while (task != nullptr) {
+        {
+          MonitorLeaveScope mls(&ml);
+          if (new_worker != nullptr) {
+            new_worker->StartThread();
+            new_worker = nullptr;
+          }
+          // Tasks scheduled by the task we just ran are likely to work on the
+          // same data, so we run them on this worker first.
+          for (intptr_t i = 0; task != nullptr; i++) {
+            task->Run();
+            ASSERT(Isolate::Current() == nullptr);
+            task.reset();
+            if (i < kMaxLocalTasksInARow) {
+              task = TakeLocalTask(worker);
+            }
+          }
+        }
+        task = TakeTaskLocked(worker);
       }
       RunningToIdleLocked(worker);
     }
 
     if (running_workers_.IsEmpty()) {
-      ASSERT(tasks_.IsEmpty());
+      ASSERT(!TasksWaitingToRunLocked());
       OnEnterIdleLocked(&ml);
-      if (!tasks_.IsEmpty()) {
+      if (TasksWaitingToRunLocked()) {
         continue;
       }
     }
@@ -176,16 +216,23 @@ void ThreadPool::WorkerLoop(Worker* worker) {
       break;
     }
 
-    // Sleep until we get a new task, we time out or we're shutdown.
+    // Sleep until we get a new task, we time out or we're shutdown. While
+    // other workers have tasks queued we only sleep for a short while before
+    // trying to steal one of them.
     const int64_t idle_start = OS::GetCurrentMonotonicMicros();
     bool done = false;
     while (!done) {
-      const auto result = ml.WaitMicros(ComputeTimeout(idle_start));
+      const bool stealing = pending_local_tasks_ > 0;
+      if (stealing) stealing_workers_++;
+      const auto result = ml.WaitMicros(
+          stealing ? Utils::Maximum(FLAG_worker_steal_delay_micros, 1)
+                   : ComputeTimeout(idle_start));
+      if (stealing) stealing_workers_--;
 
       // We have to drain all pending tasks.
-      if (!tasks_.IsEmpty()) break;
+      if (TasksWaitingToRunLocked()) break;
 
-      if (shutting_down_ || result == Monitor::kTimedOut) {
+      if (shutting_down_ || (!stealing && result == Monitor::kTimedOut)) {
         done = true;
         break;
       }
@@ -214,6 +261,7 @@ void ThreadPool::IdleToRunningLocked(Worker* worker) {
 
 void ThreadPool::RunningToIdleLocked(Worker* worker) {
   ASSERT(tasks_.IsEmpty());
+  ASSERT(worker->local_tasks_.IsEmpty());
 
   ASSERT(running_workers_.ContainsForDebugging(worker));
   running_workers_.Remove(worker);
@@ -289,6 +337,119 @@ ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
   return new_worker;
 }
 
+bool ThreadPool::ScheduleOnCurrentWorker(std::unique_ptr<Task>* task) {
+  auto worker =
+      static_cast<Worker*>(OSThread::Current()->owning_thread_pool_worker_);
+  // Without idle workers nobody could steal the task, so we let the caller
+  // schedule it on the shared queue, which may start a new worker.
+  if (worker == nullptr || worker->pool_ != this || worker->is_blocked_ ||
+      shutting_down_ || count_idle_ == 0) {
+    return false;
+  }
+  // Counted before it is queued, so the count never drops below the number
+  // of queued tasks.
+  pending_local_tasks_++;
+  {
+    MutexLocker ml(&worker->local_tasks_mutex_);
+    worker->local_tasks_.Append(task->release());
+    worker->local_task_count_++;
+  }
+  // Wake up an idle worker to steal the task in case this worker does not get
+  // to it soon, unless one is already looking for tasks to steal.
+  if (count_idle_ > 0 && stealing_workers_ == 0) {
+    MonitorLocker ml(&pool_monitor_);
+    if (count_idle_ > 0 && stealing_workers_ == 0) {
+      ml.Notify();
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<ThreadPool::Task> ThreadPool::TakeLocalTask(Worker* worker) {
+  MutexLocker ml(&worker->local_tasks_mutex_);
+  if (worker->local_tasks_.IsEmpty()) {
+    return nullptr;
+  }
+  Task* task = worker->local_tasks_.RemoveFirst();
+  worker->local_task_count_--;
+  if (worker->steal_candidate_ == task) {
+    worker->steal_candidate_ = nullptr;
+  }
+  pending_local_tasks_--;
+  return std::unique_ptr<Task>(task);
+}
+
+std::unique_ptr<ThreadPool::Task> ThreadPool::TakeTaskLocked(Worker* worker) {
+  if (!tasks_.IsEmpty()) {
+    pending_tasks_--;
+    return std::unique_ptr<Task>(tasks_.RemoveFirst());
+  }
+  if (pending_local_tasks_ == 0) {
+    return nullptr;
+  }
+  std::unique_ptr<Task> task = TakeLocalTask(worker);
+  if (task == nullptr) {
+    task = StealTaskLocked(worker);
+  }
+  return task;
+}
+
+std::unique_ptr<ThreadPool::Task> ThreadPool::StealTaskLocked(Worker* thief) {
+  // Only running workers have local tasks. To keep tasks on the worker that
+  // scheduled them, a worker's only task is stolen only if it has not been run
+  // since the last time we looked.
+  for (Worker* worker : running_workers_) {
+    if (worker == thief) continue;
+    MutexLocker ml(&worker->local_tasks_mutex_);
+    if (worker->local_tasks_.IsEmpty()) continue;
+    Task* task = worker->local_tasks_.First();
+    if (worker->local_task_count_ == 1 && worker->steal_candidate_ != task) {
+      worker->steal_candidate_ = task;
+      continue;
+    }
+    worker->local_tasks_.Remove(task);
+    worker->local_task_count_--;
+    worker->steal_candidate_ = nullptr;
+    pending_local_tasks_--;
+    return std::unique_ptr<Task>(task);
+  }
+  return nullptr;
+}
+
+ThreadPool::Worker* ThreadPool::EnsureStealingWorkerLocked(MonitorLocker* ml) {
+  if (pending_local_tasks_ == 0) {
+    return nullptr;
+  }
+  // Tasks queued on busy workers must not wait for them indefinitely, so we
+  // keep an idle worker around to steal them unless the pool is full.
+  if (!idle_workers_.IsEmpty()) {
+    if (stealing_workers_ == 0) {
+      ml->Notify();
+    }
+    return nullptr;
+  }
+  if (max_pool_size_ > 0 && (count_idle_ + count_running_) >= max_pool_size_) {
+    return nullptr;
+  }
+  auto new_worker = new Worker(this);
+  idle_workers_.Append(new_worker);
+  count_idle_++;
+  return new_worker;
+}
+
+intptr_t ThreadPool::MoveLocalTasksLocked(Worker* worker) {
+  MutexLocker ml(&worker->local_tasks_mutex_);
+  const intptr_t count = worker->local_task_count_;
+  while (!worker->local_tasks_.IsEmpty()) {
+    tasks_.Append(worker->local_tasks_.RemoveFirst());
+    pending_tasks_++;
+    pending_local_tasks_--;
+  }
+  worker->local_task_count_ = 0;
+  worker->steal_candidate_ = nullptr;
+  return count;
+}
+
 ThreadPool::Worker::Worker(ThreadPool* pool)
     : pool_(pool), join_id_(OSThread::kInvalidThreadJoinId) {}
 
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_THREAD_POOL_H_
 #define RUNTIME_VM_THREAD_POOL_H_
 
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -34,7 +35,11 @@ class ThreadPool {
     DISALLOW_COPY_AND_ASSIGN(Task);
   };
 
-  explicit ThreadPool(uintptr_t max_pool_size = 0);
+  // If [use_worker_queues] is true, tasks scheduled from a worker of this
+  // pool are queued on that worker and run by it once its current task is
+  // done. Idle workers steal them if the worker does not get to them soon.
+  explicit ThreadPool(uintptr_t max_pool_size = 0,
+                      bool use_worker_queues = false);
 
   // Prevent scheduling of new tasks, wait until all pending tasks are done
   // and join worker threads.
@@ -88,6 +93,14 @@ class ThreadPool {
     OSThread* os_thread_ = nullptr;
     bool is_blocked_ = false;
 
+    // Tasks scheduled by the tasks running on this worker. Only the worker
+    // itself adds to them, other workers may steal the oldest one.
+    Mutex local_tasks_mutex_;
+    IntrusiveDList<Task> local_tasks_;
+    intptr_t local_task_count_ = 0;
+    // The oldest local task as last seen by a stealing worker.
+    Task* steal_candidate_ = nullptr;
+
     DISALLOW_COPY_AND_ASSIGN(Worker);
   };
 
@@ -102,7 +115,9 @@ class ThreadPool {
   bool ShuttingDownLocked() { return shutting_down_; }
 
   // Whether new tasks are ready to be run.
-  bool TasksWaitingToRunLocked() { return !tasks_.IsEmpty(); }
+  bool TasksWaitingToRunLocked() {
+    return !tasks_.IsEmpty() || pending_local_tasks_ > 0;
+  }
 
  private:
   using TaskList = IntrusiveDList<Task>;
@@ -113,6 +128,13 @@ class ThreadPool {
 
   Worker* ScheduleTaskLocked(MonitorLocker* ml, std::unique_ptr<Task> task);
 
+  bool ScheduleOnCurrentWorker(std::unique_ptr<Task>* task);
+  std::unique_ptr<Task> TakeLocalTask(Worker* worker);
+  std::unique_ptr<Task> TakeTaskLocked(Worker* worker);
+  std::unique_ptr<Task> StealTaskLocked(Worker* thief);
+  Worker* EnsureStealingWorkerLocked(MonitorLocker* ml);
+  intptr_t MoveLocalTasksLocked(Worker* worker);
+
   void IdleToRunningLocked(Worker* worker);
   void RunningToIdleLocked(Worker* worker);
   void IdleToDeadLocked(Worker* worker);
@@ -120,9 +142,9 @@ class ThreadPool {
   void JoinDeadWorkersLocked(WorkerList* dead_workers_to_join);
 
   Monitor pool_monitor_;
-  bool shutting_down_ = false;
+  std::atomic<bool> shutting_down_ = {false};
   uint64_t count_running_ = 0;
-  uint64_t count_idle_ = 0;
+  std::atomic<uint64_t> count_idle_ = {0};
   uint64_t count_dead_ = 0;
   WorkerList running_workers_;
   WorkerList idle_workers_;
@@ -130,10 +152,16 @@ class ThreadPool {
   uint64_t pending_tasks_ = 0;
   TaskList tasks_;
 
+  // The number of tasks queued on workers and the number of idle workers
+  // looking for tasks to steal. Updated without holding [pool_monitor_].
+  std::atomic<intptr_t> pending_local_tasks_ = {0};
+  std::atomic<intptr_t> stealing_workers_ = {0};
+
   Monitor exit_monitor_;
   std::atomic<bool> all_workers_dead_;
 
   uintptr_t max_pool_size_ = 0;
+  const bool use_worker_queues_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
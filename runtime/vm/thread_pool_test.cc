@@ -256,4 +256,76 @@ THREAD_POOL_UNIT_TEST_CASE(ThreadPool_RecursiveSpawn) {
   EXPECT_EQ(kTotalTasks, done);
 }
 
+THREAD_POOL_UNIT_TEST_CASE(ThreadPool_RecursiveSpawnOnWorkerQueues) {
+  ThreadPool thread_pool(/*max_pool_size=*/0, /*use_worker_queues=*/true);
+  Monitor sync;
+  const int kTotalTasks = 500;
+  int done = 0;
+  thread_pool.Run<SpawnTask>(&thread_pool, &sync, kTotalTasks, kTotalTasks,
+                             &done);
+  {
+    MonitorLocker ml(&sync);
+    while (done < kTotalTasks) {
+      ml.Wait();
+    }
+  }
+  EXPECT_EQ(kTotalTasks, done);
+}
+
+class NotifyTask : public ThreadPool::Task {
+ public:
+  NotifyTask(Monitor* sync, bool* done) : sync_(sync), done_(done) {}
+
+  virtual void Run() {
+    MonitorLocker ml(sync_);
+    *done_ = true;
+    ml.NotifyAll();
+  }
+
+ private:
+  Monitor* sync_;
+  bool* done_;
+};
+
+// Schedules a task from a worker and waits for it without marking the worker
+// as blocked, so the task has to be run by another worker.
+class WaitForChildTask : public ThreadPool::Task {
+ public:
+  WaitForChildTask(ThreadPool* pool, Monitor* sync, int* finished)
+      : pool_(pool), sync_(sync), finished_(finished) {}
+
+  virtual void Run() {
+    bool child_done = false;
+    pool_->Run<NotifyTask>(sync_, &child_done);
+    MonitorLocker ml(sync_);
+    while (!child_done) {
+      ml.Wait();
+    }
+    (*finished_)++;
+    ml.NotifyAll();
+  }
+
+ private:
+  ThreadPool* pool_;
+  Monitor* sync_;
+  int* finished_;
+};
+
+THREAD_POOL_UNIT_TEST_CASE(ThreadPool_StealFromBusyWorker) {
+  ThreadPool thread_pool(/*max_pool_size=*/0, /*use_worker_queues=*/true);
+  Monitor sync;
+  // Workers started by earlier rounds are idle in later ones, so there the
+  // child task is queued on the waiting worker and has to be stolen.
+  const int kRounds = 10;
+  int finished = 0;
+  for (int i = 0; i < kRounds; i++) {
+    thread_pool.Run<WaitForChildTask>(&thread_pool, &sync, &finished);
+    MonitorLocker ml(&sync);
+    while (finished <= i) {
+      ml.Wait();
+    }
+  }
+  EXPECT_EQ(kRounds, finished);
+}
+
 }  // namespace dart
@@ -18,25 +18,47 @@ static const uintptr_t kAsciiWordMask = DART_UINT64_C(0x8080808080808080);
 static const uintptr_t kAsciiWordMask = 0x80808080u;
 #endif
 
+// The same for a word of UTF-16 code units.
+#if defined(ARCH_IS_64_BIT)
+static const uintptr_t kTwoByteAsciiWordMask =
+    DART_UINT64_C(0xFF80FF80FF80FF80);
+#else
+static const uintptr_t kTwoByteAsciiWordMask = 0xFF80FF80u;
+#endif
+static const intptr_t kCodeUnitsPerWord = sizeof(uintptr_t) / sizeof(uint16_t);
+
+// Returns true if the next word of UTF-16 code units starting at [data] is
+// plain ASCII.
+static bool IsAsciiWord(const uint16_t* data) {
+  const uintptr_t chunk =
+      LoadUnaligned(reinterpret_cast<const uintptr_t*>(data));
+  return (chunk & kTwoByteAsciiWordMask) == 0;
+}
+
 intptr_t Utf8::Length(const String& str) {
+  return Length(str, 0, str.Length());
+}
+
+intptr_t Utf8::Length(const String& str, intptr_t start, intptr_t end) {
+  ASSERT((0 <= start) && (start <= end) && (end <= str.Length()));
   if (str.IsOneByteString() || str.IsExternalOneByteString()) {
     // For 1-byte strings, all code points < 0x80 have single-byte UTF-8
     // encodings and all >= 0x80 have two-byte encodings.  To get the length,
     // start with the number of code points and add the number of high bits in
     // the bytes.
-    uintptr_t char_length = str.Length();
+    uintptr_t char_length = end - start;
     uintptr_t length = char_length;
-    const uintptr_t* data;
+    const uint8_t* data;
     NoSafepointScope no_safepoint;
     if (str.IsOneByteString()) {
-      data = reinterpret_cast<const uintptr_t*>(OneByteString::DataStart(str));
+      data = OneByteString::DataStart(str) + start;
     } else {
-      data = reinterpret_cast<const uintptr_t*>(
-          ExternalOneByteString::DataStart(str));
+      data = ExternalOneByteString::DataStart(str) + start;
     }
     uintptr_t i;
     for (i = sizeof(uintptr_t); i <= char_length; i += sizeof(uintptr_t)) {
-      uintptr_t chunk = *data++;
+      uintptr_t chunk = LoadUnaligned(
+          reinterpret_cast<const uintptr_t*>(data + i - sizeof(uintptr_t)));
       chunk &= kAsciiWordMask;
       if (chunk != 0) {
 // Shuffle the bits until we have a count of bits in the low nibble.
@@ -51,52 +73,71 @@ intptr_t Utf8::Length(const String& str) {
     // Take care of the tail of the string, the last length % wordsize chars.
     i -= sizeof(uintptr_t);
     for (; i < char_length; i++) {
-      if (str.CharAt(i) > kMaxOneByteChar) length++;
+      if (data[i] > kMaxOneByteChar) length++;
     }
     return length;
   }
 
-  // Slow case for 2-byte strings that handles surrogate pairs and longer UTF-8
-  // encodings.
+  // For 2-byte strings, count runs of ASCII code units a word at a time and
+  // use the general code for surrogate pairs and longer UTF-8 encodings.
   intptr_t length = 0;
-  String::CodePointIterator it(str);
-  while (it.Next()) {
-    int32_t ch = it.Current();
-    length += Utf8::Length(ch);
+  NoSafepointScope no_safepoint;
+  const uint16_t* data = str.IsTwoByteString()
+                             ? TwoByteString::DataStart(str)
+                             : ExternalTwoByteString::DataStart(str);
+  const intptr_t char_length = end;
+  intptr_t i = start;
+  while (i < char_length) {
+    if ((i + kCodeUnitsPerWord <= char_length) && IsAsciiWord(data + i)) {
+      i += kCodeUnitsPerWord;
+      length += kCodeUnitsPerWord;
+      continue;
+    }
+    length += Utf8::Length(Utf16::Next(data, &i, char_length));
   }
   return length;
 }
 
 intptr_t Utf8::Encode(const String& src, char* dst, intptr_t len) {
+  return Encode(src, 0, src.Length(), dst, len);
+}
+
+intptr_t Utf8::Encode(const String& src,
+                      intptr_t start,
+                      intptr_t end,
+                      char* dst,
+                      intptr_t len) {
+  ASSERT((0 <= start) && (start <= end) && (end <= src.Length()));
   uintptr_t array_len = len;
   intptr_t pos = 0;
-  ASSERT(static_cast<intptr_t>(array_len) >= Length(src));
+  ASSERT(static_cast<intptr_t>(array_len) >= Length(src, start, end));
   if (src.IsOneByteString() || src.IsExternalOneByteString()) {
     // For 1-byte strings, all code points < 0x80 have single-byte UTF-8
     // encodings and all >= 0x80 have two-byte encodings.
-    const uintptr_t* data;
+    const uint8_t* data;
     NoSafepointScope scope;
     if (src.IsOneByteString()) {
-      data = reinterpret_cast<const uintptr_t*>(OneByteString::DataStart(src));
+      data = OneByteString::DataStart(src) + start;
     } else {
-      data = reinterpret_cast<const uintptr_t*>(
-          ExternalOneByteString::DataStart(src));
+      data = ExternalOneByteString::DataStart(src) + start;
     }
-    uintptr_t char_length = src.Length();
-    uintptr_t pos = 0;
+    uintptr_t char_length = end - start;
     ASSERT(kMaxOneByteChar + 1 == 0x80);
     for (uintptr_t i = 0; i < char_length; i += sizeof(uintptr_t)) {
       // Read the input one word at a time and just write it verbatim if it is
       // plain ASCII, as determined by the mask.
-      if (i + sizeof(uintptr_t) <= char_length &&
-          (*data & kAsciiWordMask) == 0 &&
+      const uintptr_t chunk =
+          (i + sizeof(uintptr_t) <= char_length)
+              ? LoadUnaligned(reinterpret_cast<const uintptr_t*>(data))
+              : kAsciiWordMask;
+      if ((chunk & kAsciiWordMask) == 0 &&
           pos + sizeof(uintptr_t) <= array_len) {
-        StoreUnaligned(reinterpret_cast<uintptr_t*>(dst + pos), *data);
+        StoreUnaligned(reinterpret_cast<uintptr_t*>(dst + pos), chunk);
         pos += sizeof(uintptr_t);
       } else {
         // Process up to one word of input that contains non-ASCII Latin1
         // characters.
-        const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+        const uint8_t* p = data;
         const uint8_t* limit =
             Utils::Minimum(p + sizeof(uintptr_t), p + (char_length - i));
         for (; p < limit; p++) {
@@ -104,21 +145,36 @@ intptr_t Utf8::Encode(const String& src, char* dst, intptr_t len) {
           // These calls to Length and Encode get inlined and the cases for 3
           // and 4 byte sequences are removed.
           intptr_t bytes = Length(c);
-          if (pos + bytes > array_len) {
+          if (static_cast<uintptr_t>(pos + bytes) > array_len) {
             return pos;
           }
           Encode(c, reinterpret_cast<char*>(dst) + pos);
           pos += bytes;
         }
       }
-      data++;
+      data += sizeof(uintptr_t);
     }
   } else {
-    // For two-byte strings, which can contain 3 and 4-byte UTF-8 encodings,
-    // which can result in surrogate pairs, use the more general code.
-    String::CodePointIterator it(src);
-    while (it.Next()) {
-      int32_t ch = it.Current();
+    // For two-byte strings, copy runs of ASCII code units a word at a time
+    // and use the general code for everything else, which can contain 3 and
+    // 4-byte UTF-8 encodings and surrogate pairs.
+    const intptr_t char_length = end;
+    NoSafepointScope no_safepoint;
+    const uint16_t* data = src.IsTwoByteString()
+                               ? TwoByteString::DataStart(src)
+                               : ExternalTwoByteString::DataStart(src);
+    intptr_t i = start;
+    while (i < char_length) {
+      if ((i + kCodeUnitsPerWord <= char_length) &&
+          (pos + kCodeUnitsPerWord <= len) && IsAsciiWord(data + i)) {
+        for (intptr_t j = 0; j < kCodeUnitsPerWord; j++) {
+          dst[pos + j] = static_cast<char>(LoadUnaligned(data + i + j));
+        }
+        i += kCodeUnitsPerWord;
+        pos += kCodeUnitsPerWord;
+        continue;
+      }
+      int32_t ch = Utf16::Next(data, &i, char_length);
       ASSERT(!Utf::IsOutOfRange(ch));
       if (Utf16::IsSurrogate(ch)) {
         // Encode unpaired surrogates as replacement characters to ensure the
@@ -27,6 +27,67 @@ ISOLATE_UNIT_TEST_CASE(Utf8Encode) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Utf8EncodeTwoByte) {
+  // ASCII runs longer than a word, 2 and 3 byte sequences, a surrogate pair
+  // and an unpaired lead surrogate.
+  const uint16_t kInput[] = {'a',    'b',    'c',    'd',    'e',    'f',
+                             'g',    'h',    'i',    0xe6,   'j',    0x20ac,
+                             'k',    0xd83d, 0xde00, 'l',    'm',    'n',
+                             'o',    'p',    0xd800, 'q'};
+  const uint8_t kExpected[] = {
+      'a',  'b',  'c',  'd',  'e',  'f',  'g',  'h',  'i',  0xc3, 0xa6,
+      'j',  0xe2, 0x82, 0xac, 'k',  0xf0, 0x9f, 0x98, 0x80, 'l',  'm',
+      'n',  'o',  'p',  0xef, 0xbf, 0xbd, 'q'};
+  const intptr_t kInputLen = ARRAY_SIZE(kInput);
+  const intptr_t kExpectedLen = ARRAY_SIZE(kExpected);
+  const String& input = String::Handle(String::FromUTF16(kInput, kInputLen));
+  EXPECT(input.IsTwoByteString());
+  EXPECT_EQ(kExpectedLen, Utf8::Length(input));
+
+  uint8_t buffer[kExpectedLen + 1];
+  buffer[kExpectedLen] = 42;
+  EXPECT_EQ(kExpectedLen,
+            Utf8::Encode(input, reinterpret_cast<char*>(buffer), kExpectedLen));
+  for (intptr_t i = 0; i < kExpectedLen; i++) {
+    EXPECT_EQ(kExpected[i], buffer[i]);
+  }
+  EXPECT_EQ(42, buffer[kExpectedLen]);
+
+  // One-byte strings report the number of bytes written as well.
+  const String& latin1 = String::Handle(String::New("abcdefghij\xc3\xa6"));
+  EXPECT(latin1.IsOneByteString());
+  EXPECT_EQ(12, Utf8::Length(latin1));
+  EXPECT_EQ(12, Utf8::Encode(latin1, reinterpret_cast<char*>(buffer), 12));
+}
+
+ISOLATE_UNIT_TEST_CASE(Utf8EncodeRange) {
+  // Encoding a range gives the same bytes as encoding the substring, for
+  // ranges at every alignment in one-byte and two-byte strings.
+  const uint16_t kTwoByte[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h',
+                               'i', 0xe6, 'j', 0x20ac, 'k', 0xd83d, 0xde00,
+                               'l', 'm', 'n', 'o', 'p', 'q', 'r'};
+  const String& two_byte =
+      String::Handle(String::FromUTF16(kTwoByte, ARRAY_SIZE(kTwoByte)));
+  const String& one_byte =
+      String::Handle(String::New("abcdefghijklm\xc3\xa6nopqrstuvwxyz"));
+  const String* inputs[] = {&one_byte, &two_byte};
+  String& sub = String::Handle();
+  char expected[128];
+  char actual[128];
+  for (const String* input : inputs) {
+    for (intptr_t start = 0; start <= input->Length(); start++) {
+      for (intptr_t end = start; end <= input->Length(); end++) {
+        sub = String::SubString(*input, start, end - start);
+        const intptr_t length = Utf8::Length(sub);
+        EXPECT_EQ(length, Utf8::Length(*input, start, end));
+        EXPECT_EQ(length, Utf8::Encode(sub, expected, length));
+        EXPECT_EQ(length, Utf8::Encode(*input, start, end, actual, length));
+        EXPECT(memcmp(expected, actual, length) == 0);
+      }
+    }
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(Utf8InvalidByte) {
   {
     uint8_t array[] = {0x41, 0xF0, 0x92};
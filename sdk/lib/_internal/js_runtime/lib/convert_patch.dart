@@ -10,6 +10,7 @@ import 'dart:_interceptors' show JSArray, JSExtendableArray;
 import 'dart:_internal' show MappedIterable, ListIterable;
 import 'dart:collection' show LinkedHashMap, MapBase;
 import 'dart:_native_typed_data' show NativeUint8List;
+import 'dart:typed_data' show Uint8List;
 
 /// Parses [json] and builds the corresponding parsed JSON value.
 ///
@@ -383,6 +384,15 @@ class _JsonDecoderSink extends _StringSinkConversionSink<StringBuffer> {
   }
 }
 
+@patch
+class Utf8Encoder {
+  // Currently not intercepting UTF-8 encoding.
+  @patch
+  static Uint8List? _convertIntercepted(String string, int start, int end) {
+    return null; // This call was not intercepted.
+  }
+}
+
 @patch
 class Utf8Decoder {
   // Always fall back to the Dart implementation for strings shorter than this
@@ -28,6 +28,10 @@ import "dart:typed_data" show Uint8List, Uint16List;
 @patch
 dynamic _parseJson(
     String source, Object? Function(Object? key, Object? value)? reviver) {
+  if (reviver == null) {
+    final result = _decodeJsonNative(source, <String, dynamic>{}, _notDecoded);
+    if (!identical(result, _notDecoded)) return result;
+  }
   _BuildJsonListener listener;
   if (reviver == null) {
     listener = new _BuildJsonListener();
@@ -42,6 +46,15 @@ dynamic _parseJson(
   return listener.result;
 }
 
+@patch
+class Utf8Encoder {
+  // The VM encodes strings natively, handling runs of ASCII characters a
+  // machine word at a time.
+  @patch
+  static Uint8List? _convertIntercepted(String string, int start, int end)
+      native "Utf8Encoder_convertIntercepted";
+}
+
 @patch
 class Utf8Decoder {
   @patch
@@ -70,6 +83,11 @@ class _JsonUtf8Decoder extends Converter<List<int>, Object> {
   _JsonUtf8Decoder(this._reviver, this._allowMalformed);
 
   Object convert(List<int> input) {
+    if (_reviver == null && _Utf8Decoder._isNativeUint8List(input)) {
+      final dynamic result =
+          _decodeJsonNative(input, <String, dynamic>{}, _notDecoded);
+      if (!identical(result, _notDecoded)) return result;
+    }
     var parser = _JsonUtf8DecoderSink._createParser(_reviver, _allowMalformed);
     parser.chunk = input;
     parser.chunkEnd = input.length;
@@ -85,6 +103,21 @@ class _JsonUtf8Decoder extends Converter<List<int>, Object> {
 
 //// Implementation ///////////////////////////////////////////////////////////
 
+// Native JSON decoding.
+
+/// Returned by [_decodeJsonNative] when it leaves the input to the Dart
+/// parser.
+const Object _notDecoded = const Object();
+
+/// Decodes a complete JSON text from a [String] or a UTF-8 encoded
+/// [Uint8List] without creating parser events.
+///
+/// Maps are created with the type arguments of [mapPrototype]. Returns
+/// [notDecoded] if the input is not valid JSON or cannot be decoded natively,
+/// in which case the Dart parser should be used to get the result or error.
+Object? _decodeJsonNative(Object input, Map<String, dynamic> mapPrototype,
+    Object notDecoded) native "JsonDecoder_decodeNative";
+
 // Simple API for JSON parsing.
 
 /**
@@ -325,6 +325,14 @@ abstract class _StringBase implements String {
     return _substringMatches(this.length - other.length, other);
   }
 
+  // Searches through at least this many code units are done natively, where
+  // candidates are found with memchr and compared with memcmp.
+  static const int _nativeIndexOfThreshold = 64;
+
+  // Requires 0 <= start <= length.
+  int _indexOfUnchecked(String pattern, int start)
+      native "StringBase_indexOfUnchecked";
+
   bool startsWith(Pattern pattern, [int index = 0]) {
     if ((index < 0) || (index > this.length)) {
       throw new RangeError.range(index, 0, this.length);
@@ -341,6 +349,9 @@ abstract class _StringBase implements String {
     }
     if (pattern is String) {
       String other = pattern;
+      if (this.length - start >= _nativeIndexOfThreshold) {
+        return _indexOfUnchecked(other, start);
+      }
       int maxIndex = this.length - other.length;
       // TODO: Use an efficient string search (e.g. BMH).
       for (int index = start; index <= maxIndex; index++) {
@@ -1022,6 +1033,9 @@ class _OneByteString extends _StringBase {
         if (patternCu0 > 0xFF) {
           return -1;
         }
+        if (len - start >= _StringBase._nativeIndexOfThreshold) {
+          return _indexOfUnchecked(patternAsString, start);
+        }
         for (int i = start; i < len; i++) {
           if (this.codeUnitAt(i) == patternCu0) {
             return i;
@@ -1045,6 +1059,9 @@ class _OneByteString extends _StringBase {
         if (patternCu0 > 0xFF) {
           return false;
         }
+        if (len - start >= _StringBase._nativeIndexOfThreshold) {
+          return _indexOfUnchecked(patternAsString, start) >= 0;
+        }
         for (int i = start; i < len; i++) {
           if (this.codeUnitAt(i) == patternCu0) {
             return true;
@@ -99,6 +99,24 @@ testIdentity(x) {
   return x * y + x * z;
 }
 
+// Arrays of a constant length and contexts are sunk as well. The code below
+// deoptimizes when c is a D, after the list and the context of f were
+// eliminated, so both have to be rebuilt from their elements.
+testArray(c, x) {
+  var list = new List<dynamic>.filled(2, null);
+  list[0] = x;
+  list[1] = x + 1;
+  var p = c.p;
+  return list[0] * 100 + list[1] * 10 + p;
+}
+
+testContext(c, x) {
+  var y = x + 1;
+  f() => y;
+  var p = c.p;
+  return f() * 10 + p;
+}
+
 class PointP<T> {
   var x, y;
 
@@ -330,6 +348,18 @@ main() {
   Expect.equals(z0, z1);
   Expect.equals(z0, z2);
 
+  // Test arrays and contexts rebuilt after deopt.
+  final a0 = testArray(new C(1), 4);
+  final b0 = testContext(new C(1), 4);
+  for (var i = 0; i < 100; i++) {
+    testArray(new C(1), i);
+    testContext(new C(1), i);
+  }
+  Expect.equals(a0, testArray(new C(1), 4));
+  Expect.equals(b0, testContext(new C(1), 4));
+  Expect.equals(451, testArray(new D(1), 4));
+  Expect.equals(51, testContext(new D(1), 4));
+
   testFinalField();
   testVMField();
   testCompound1();
@@ -0,0 +1,135 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that decoding complete JSON texts from strings and from UTF-8 bytes
+// gives the same results as the chunked decoder.
+
+import "dart:convert";
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+Object? decodeChunked(String source) {
+  Object? result;
+  final callback = ChunkedConversionSink<Object?>.withCallback((values) {
+    result = values.single;
+  });
+  final sink = const JsonDecoder().startChunkedConversion(callback);
+  sink.add(source);
+  sink.close();
+  return result;
+}
+
+Object? decodeBytes(String source, {bool bom = false}) {
+  final bytes = BytesBuilder();
+  if (bom) bytes.add(const [0xEF, 0xBB, 0xBF]);
+  bytes.add(utf8.encode(source));
+  return utf8.decoder.fuse(json.decoder).convert(bytes.takeBytes());
+}
+
+void checkSame(Object? expected, Object? actual) {
+  if (expected is Map) {
+    Expect.isTrue(actual is Map<String, dynamic>, "$actual");
+    final map = actual as Map;
+    Expect.listEquals(expected.keys.toList(), map.keys.toList());
+    for (final key in expected.keys) {
+      Expect.isTrue(map.containsKey(key), "$key");
+      checkSame(expected[key], map[key]);
+    }
+    // The map must still be usable after decoding.
+    map["added"] = 1;
+    Expect.equals(1, map["added"]);
+  } else if (expected is List) {
+    Expect.isTrue(actual is List<dynamic>, "$actual");
+    final list = actual as List;
+    Expect.equals(expected.length, list.length);
+    for (int i = 0; i < expected.length; i++) {
+      checkSame(expected[i], list[i]);
+    }
+    list.add(1);
+  } else if (expected is double) {
+    Expect.isTrue(actual is double, "$actual");
+    Expect.identical(expected, actual);
+  } else {
+    Expect.equals(expected is int, actual is int, "$actual");
+    Expect.equals(expected, actual);
+  }
+}
+
+void check(String source) {
+  final expected = decodeChunked(source);
+  checkSame(expected, jsonDecode(source));
+  checkSame(expected, decodeBytes(source));
+  checkSame(expected, decodeBytes(source, bom: true));
+  // A string with characters outside Latin-1.
+  final wide = '[$source, "\u1234"]';
+  checkSame(decodeChunked(wide), jsonDecode(wide));
+}
+
+void checkError(String source) {
+  Expect.throwsFormatException(() => jsonDecode(source));
+  Expect.throwsFormatException(() => decodeBytes(source));
+}
+
+void main() {
+  check('null');
+  check(' true ');
+  check('false');
+  check('[]');
+  check('{}');
+  check('[[], {}, [{}], {"a": []}]');
+  check('{"a": 1, "b": [2, 3.5, "c"], "d": {"e": null}}');
+  check('{"a": 1, "b": 2, "a": 3}');
+  check('{"": "", "\\u0000": "\\"\\\\\\/\\b\\f\\n\\r\\t"}');
+
+  // Strings with and without escapes, long enough to use word-sized scans.
+  check('"The quick brown fox jumps over the lazy dog"');
+  check('"The quick brown fox jumps over the lazy \\"dog\\""');
+  check('"Høj bølgegang på søen får ænderne til at flyve væk"');
+  check('"我能吞下玻璃而不伤身体 \\u6211"');
+  check('"\\ud83d\\ude00 😀"');
+  check('["\\ud83d", "\\ude00", "x\\ud83dy"]');
+
+  // Numbers.
+  for (final number in [
+    '0', '-0', '1', '-1', '9007199254740993', '9223372036854775807',
+    '-9223372036854775808', '9223372036854775808', '-9223372036854775809',
+    '123456789012345678901234567890', '0.0', '-0.0', '1.5', '1e3', '1E+3',
+    '1e-3', '0.1', '2.2250738585072014e-308', '1.7976931348623157e308',
+    '1e400', '-1e400', '0e400', '1e-400', '-1e-400',
+    '0.30000000000000004', '5e-324', '4.9406564584124654e-324',
+  ]) {
+    check(number);
+    check('[$number]');
+  }
+
+  checkError('');
+  checkError(' ');
+  checkError('[');
+  checkError('[1,]');
+  checkError('{"a"}');
+  checkError('{"a": 1,}');
+  checkError('{a: 1}');
+  checkError('[] []');
+  checkError('01');
+  checkError('-');
+  checkError('1.');
+  checkError('1e');
+  checkError('.5');
+  checkError('"\t"');
+  checkError('"\\x"');
+  checkError('"\\u12"');
+  checkError('tru');
+  checkError('nulll');
+
+  // Malformed UTF-8 is left to the Dart decoder.
+  Expect.throwsFormatException(() => utf8.decoder
+      .fuse(json.decoder)
+      .convert(Uint8List.fromList([0x22, 0xC3, 0x22])));
+  Expect.equals(
+      "\uFFFD",
+      const Utf8Decoder(allowMalformed: true)
+          .fuse(json.decoder)
+          .convert(Uint8List.fromList([0x22, 0xC3, 0x22])));
+}